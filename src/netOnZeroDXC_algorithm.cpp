@@ -36,11 +36,17 @@
 #include <limits>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <iostream>
 
 #include "omp.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NETONZERODXC_SSE2
+#endif
+
 #include <gsl/gsl_rng.h>
 #include <gsl/gsl_fft_real.h>
 #include <gsl/gsl_fft_halfcomplex.h>
@@ -50,11 +56,6 @@
 	#define INCLUDED_ALGORITHM
 #endif
 
-struct PairValueId {
-	int index;
-	double value;
-};
-
 bool netOnZeroDXC_sort_values (PairValueId a, PairValueId b) {return a.value < b.value;}
 
 double netOnZeroDXC_compute_wmatrix_element (const std::vector <double> & efficiency, const std::vector <double> & window_widths, double threshold_eta)
@@ -70,112 +71,1297 @@ double netOnZeroDXC_compute_wmatrix_element (const std::vector <double> & effici
 	return -1.0;
 }
 
+int netOnZeroDXC_compute_timescale_matrix (std::vector < std::vector <double> > & matrix, const std::vector < std::vector <double> > & efficiencies, const std::vector <double> & window_widths,
+					const std::vector <bool> & node_valid, const std::vector < std::vector <int> > & pair_indices, double threshold_eta)
+{
+	int	N = node_valid.size();
+	int	i, j;
+
+	matrix.assign(N, std::vector <double> (N, -1.0));
+	for (i = 0; i < N; i++) {
+		if (node_valid[i])
+			matrix[i][i] = 0.0;
+		else
+			matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
+		for (j = i + 1; j < N; j++) {
+			if (node_valid[i] && node_valid[j] && (pair_indices[i][j] >= 0)) {
+				matrix[i][j] = netOnZeroDXC_compute_wmatrix_element(efficiencies[pair_indices[i][j]], window_widths, threshold_eta);
+				matrix[j][i] = matrix[i][j];
+			} else {
+				matrix[i][j] = std::numeric_limits<double>::quiet_NaN();
+				matrix[j][i] = std::numeric_limits<double>::quiet_NaN();
+			}
+		}
+	}
+
+	return 0;
+}
+
+static inline int netOnZeroDXC_popcount (uint64_t word)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int) ((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Cells are compared 64 at a time into whole words, without branches; p < alpha, or p <= alpha if inclusive.
+template <bool inclusive>
+static inline void netOnZeroDXC_significance_mask_word (uint64_t & significant, uint64_t & undefined, const double * cells, int nr_bits, double threshold_alpha)
+{
+	uint64_t	bits_significant = 0, bits_undefined = 0;
+	int	b;
+	for (b = 0; b < nr_bits; b++) {
+		bits_significant |= ((uint64_t) ((inclusive)? cells[b] <= threshold_alpha : cells[b] < threshold_alpha)) << b;
+		bits_undefined |= ((uint64_t) (cells[b] != cells[b])) << b;
+	}
+	significant = bits_significant;
+	undefined = bits_undefined;
+}
+
+#if defined(NETONZERODXC_SSE2)
+// Two cells per comparison; movemask packs the two sign bits of the result.
+template <bool inclusive>
+static inline void netOnZeroDXC_significance_mask_full_word (uint64_t & significant, uint64_t & undefined, const double * cells, double threshold_alpha)
+{
+	uint64_t	bits_significant = 0, bits_undefined = 0;
+	__m128d	threshold = _mm_set1_pd(threshold_alpha);
+	__m128d	x;
+	int	b;
+	for (b = 0; b < 64; b += 2) {
+		x = _mm_loadu_pd(cells + b);
+		bits_significant |= ((uint64_t) _mm_movemask_pd((inclusive)? _mm_cmple_pd(x, threshold) : _mm_cmplt_pd(x, threshold))) << b;
+		bits_undefined |= ((uint64_t) _mm_movemask_pd(_mm_cmpunord_pd(x, x))) << b;
+	}
+	significant = bits_significant;
+	undefined = bits_undefined;
+}
+#else
+template <bool inclusive>
+static inline void netOnZeroDXC_significance_mask_full_word (uint64_t & significant, uint64_t & undefined, const double * cells, double threshold_alpha)
+{
+	netOnZeroDXC_significance_mask_word <inclusive> (significant, undefined, cells, 64, threshold_alpha);
+}
+#endif
+
+template <bool inclusive>
+static void netOnZeroDXC_significance_mask_row (uint64_t * significant, uint64_t * undefined, const double * diagram_row, int K, double threshold_alpha)
+{
+	int	w, nr_full_words = K / 64;
+	for (w = 0; w < nr_full_words; w++)
+		netOnZeroDXC_significance_mask_full_word <inclusive> (significant[w], undefined[w], diagram_row + 64 * w, threshold_alpha);
+	if (K % 64)
+		netOnZeroDXC_significance_mask_word <inclusive> (significant[w], undefined[w], diagram_row + 64 * w, K % 64, threshold_alpha);
+}
+
+static void netOnZeroDXC_significance_mask_row (uint64_t * significant, uint64_t * undefined, const double * diagram_row, int K, double threshold_alpha, bool inclusive)
+{
+	if (inclusive)
+		netOnZeroDXC_significance_mask_row <true> (significant, undefined, diagram_row, K, threshold_alpha);
+	else
+		netOnZeroDXC_significance_mask_row <false> (significant, undefined, diagram_row, K, threshold_alpha);
+}
+
+static void netOnZeroDXC_allocate_mask (SignificanceMask & mask, int rows, int cols)
+{
+	mask.rows = rows;
+	mask.cols = cols;
+	mask.words_per_row = (cols + 63) / 64;
+	mask.significant.assign((size_t) rows * mask.words_per_row, 0);
+	mask.undefined.assign((size_t) rows * mask.words_per_row, 0);
+}
+
+int netOnZeroDXC_significance_mask (SignificanceMask & mask, const std::vector < std::vector <double> > & diagram, double threshold_alpha, bool inclusive)
+{
+	int	l;
+	netOnZeroDXC_allocate_mask(mask, diagram.size(), (diagram.size())? diagram[0].size() : 0);
+	for (l = 0; l < mask.rows; l++) {
+		if (diagram[l].size() != mask.cols)
+			return 1;
+		netOnZeroDXC_significance_mask_row(mask.significant.data() + (size_t) l * mask.words_per_row, mask.undefined.data() + (size_t) l * mask.words_per_row,
+							diagram[l].data(), mask.cols, threshold_alpha, inclusive);
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_significance_mask (SignificanceMask & mask, const DiagramView & diagram, double threshold_alpha, bool inclusive)
+{
+	int	l;
+	netOnZeroDXC_allocate_mask(mask, diagram.rows, diagram.cols);
+	for (l = 0; l < mask.rows; l++)
+		netOnZeroDXC_significance_mask_row(mask.significant.data() + (size_t) l * mask.words_per_row, mask.undefined.data() + (size_t) l * mask.words_per_row,
+							diagram.row(l), mask.cols, threshold_alpha, inclusive);
+
+	return 0;
+}
+
+// Fraction of significant cells of a mask row among positions 0, step, 2*step, ...; NaN if undefined_rows and any of
+// them is undefined.
+static double netOnZeroDXC_efficiency_of_mask_row (const uint64_t * significant_row, const uint64_t * undefined_row, int K, int step, bool undefined_rows,
+							std::vector <uint64_t> & pattern)
+{
+	int	words_per_row = (K + 63) / 64;
+	int	w, j, n = 0, count = 0;
+	bool	undefined = false;
+	if (step == 1) {
+		n = K;
+		for (w = 0; w < words_per_row; w++) {
+			count += netOnZeroDXC_popcount(significant_row[w]);
+			undefined = undefined || undefined_row[w];
+		}
+	} else {
+		pattern.assign(words_per_row, 0);
+		for (j = 0; j < K; j += step) {
+			pattern[j / 64] |= ((uint64_t) 1) << (j % 64);
+			n++;
+		}
+		for (w = 0; w < words_per_row; w++) {
+			count += netOnZeroDXC_popcount(significant_row[w] & pattern[w]);
+			undefined = undefined || (undefined_row[w] & pattern[w]);
+		}
+	}
+
+	return (undefined_rows && undefined)? std::numeric_limits<double>::quiet_NaN() : (double) count / (double) n;
+}
+
+// One-off efficiency of a diagram row, without keeping a mask: whole rows are packed a word at a time and counted,
+// strided positions are few enough to be compared one by one.
+static double netOnZeroDXC_efficiency_of_row (const double * diagram_row, int K, int step, double threshold_alpha)
+{
+	uint64_t	significant, undefined;
+	int	w, j, n = 0, count = 0;
+	if (step == 1) {
+		for (w = 0; w < K / 64; w++) {
+			netOnZeroDXC_significance_mask_full_word <false> (significant, undefined, diagram_row + 64 * w, threshold_alpha);
+			count += netOnZeroDXC_popcount(significant);
+		}
+		if (K % 64) {
+			netOnZeroDXC_significance_mask_word <false> (significant, undefined, diagram_row + 64 * w, K % 64, threshold_alpha);
+			count += netOnZeroDXC_popcount(significant);
+		}
+		n = K;
+	} else {
+		for (j = 0; j < K; j += step) {
+			count += (diagram_row[j] < threshold_alpha);
+			n++;
+		}
+	}
+
+	return (double) count / (double) n;
+}
+
+// Efficiency of a row of counts: cells whose count is below count_limit are significant, undefined cells are not.
+static double netOnZeroDXC_efficiency_of_count_row (const uint16_t * count_row, int K, int step, int count_limit)
+{
+	int	j, n = 0, count = 0;
+	if (step == 1) {
+		for (j = 0; j < K; j++)
+			count += (count_row[j] < count_limit);
+		n = K;
+	} else {
+		for (j = 0; j < K; j += step) {
+			count += (count_row[j] < count_limit);
+			n++;
+		}
+	}
+
+	return (double) count / (double) n;
+}
+
+// Efficiency of each row of a mask: the fraction of significant cells, or, avoiding overlapping windows, of significant
+// cells among positions 0, l+1, 2(l+1), ... of row l. With undefined_rows, a row with an undefined cell among those
+// counted has a NaN efficiency; otherwise undefined cells count as not significant.
+int netOnZeroDXC_mask_efficiency (std::vector <double> & efficiency, const SignificanceMask & mask, bool avoid_overlapping, bool undefined_rows)
+{
+	std::vector <uint64_t>	pattern;
+	int	l;
+	efficiency.resize(mask.rows);
+	for (l = 0; l < mask.rows; l++)
+		efficiency[l] = netOnZeroDXC_efficiency_of_mask_row(mask.significant.data() + (size_t) l * mask.words_per_row, mask.undefined.data() + (size_t) l * mask.words_per_row, mask.cols,
+									(avoid_overlapping)? l + 1 : 1, undefined_rows, pattern);
+
+	return 0;
+}
+
 int netOnZeroDXC_compute_efficiency (std::vector <double> & efficiency, const std::vector < std::vector <double> > & diagram, double threshold_alpha, bool avoid_overlapping)
 {
-	efficiency.clear();
+	efficiency.resize(diagram.size());
+
+	int	i;
+	for (i = 0; i < diagram.size(); i++)
+		efficiency[i] = netOnZeroDXC_efficiency_of_row(diagram[i].data(), diagram[i].size(), (avoid_overlapping)? i + 1 : 1, threshold_alpha);
+
+	return 0;
+}
+
+int netOnZeroDXC_compute_efficiency (std::vector <double> & efficiency, const DiagramView & diagram, double threshold_alpha, bool avoid_overlapping)
+{
+	efficiency.resize(diagram.rows);
+
+	int	i;
+	for (i = 0; i < diagram.rows; i++)
+		efficiency[i] = netOnZeroDXC_efficiency_of_row(diagram.row(i), diagram.cols, (avoid_overlapping)? i + 1 : 1, threshold_alpha);
+
+	return 0;
+}
+
+// Efficiencies of a count diagram: p < alpha exactly when count < netOnZeroDXC_count_limit(alpha, M).
+int netOnZeroDXC_compute_efficiency (std::vector <double> & efficiency, const CountView & diagram, int count_limit, bool avoid_overlapping)
+{
+	efficiency.resize(diagram.rows);
 
-	int	i, j, n;
-	double	eta;
+	int	i;
+	for (i = 0; i < diagram.rows; i++)
+		efficiency[i] = netOnZeroDXC_efficiency_of_count_row(diagram.row(i), diagram.cols, (avoid_overlapping)? i + 1 : 1, count_limit);
 
-	if (!avoid_overlapping) {
-		for (i = 0; i < diagram.size(); i++) {
-			eta = 0.0;
-			n = 0;
-			for (j = 0; j < diagram[i].size(); j++) {
-				if (diagram[i][j] < threshold_alpha)
-					eta += 1.0;
-				n++;
+	return 0;
+}
+
+// The F-test p values are skipped when pvalue_diagram_fisher has no data, as for surrogate diagrams.
+int netOnZeroDXC_compute_cdiagram (const DiagramView & correlation_diagram, const DiagramView & pvalue_diagram_fisher,
+					SequenceSpan sequence_a, SequenceSpan sequence_b, int w_base, int W, bool apply_shift, int shift)
+{
+	int	l, j, k, ws;
+	double	cross_correlation_coefficient, f_statistics;
+	double	*correlation_row, *pvalue_row;
+	for (l = 0; l < W; l++) {
+		j = 0;
+		ws = (l + 1) * w_base;
+		correlation_row = correlation_diagram.row(l);
+		pvalue_row = (pvalue_diagram_fisher.data)? pvalue_diagram_fisher.row(l) : NULL;
+		for (k = W * w_base / 2 - 1; k < sequence_a.length - W * w_base / 2 - ((apply_shift)? shift : 0); k = k + w_base) {
+			if (apply_shift) {
+				cross_correlation_coefficient = 0.5 * netOnZeroDXC_compute_crosscorr(sequence_a, sequence_b, k + shift - ws/2 + 1, k + shift + ws/2, k - ws/2 + 1, k + ws/2);
+				cross_correlation_coefficient += 0.5 * netOnZeroDXC_compute_crosscorr(sequence_a, sequence_b, k - ws/2 + 1, k + ws/2, k + shift - ws/2 + 1, k + shift + ws/2);
+			} else {
+				cross_correlation_coefficient = netOnZeroDXC_compute_crosscorr(sequence_a, sequence_b, k - ws/2 + 1, k + ws/2, k - ws/2 + 1, k + ws/2);
 			}
-			efficiency.push_back(eta / (double) n);
-		}
-	} else if (avoid_overlapping) {
-		for (i = 0; i < diagram.size(); i++) {
-			eta = 0.0;
-			n = 0;
-			for (j = 0; j < diagram[i].size(); j += (i + 1)) {
-				if (diagram[i][j] < threshold_alpha)
-					eta += 1.0;
-				n++;
+			correlation_row[j] = cross_correlation_coefficient;
+			if (pvalue_row) {
+				f_statistics = ((double) ws) / (1.0/(cross_correlation_coefficient*cross_correlation_coefficient) - 1.0);
+				pvalue_row[j] = netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1.0, ws - 2.0);
 			}
-			efficiency.push_back(eta / (double) n);
+
+			j++;
 		}
 	}
 
 	return 0;
 }
 
-int netOnZeroDXC_compute_cdiagram (std::vector < std::vector <double> > & correlation_diagram, std::vector < std::vector <double> > & pvalue_diagram_fisher,
-					const std::vector < std::vector <double> > & sequences, int node_a, int node_b, int w_base, int W, bool apply_shift, int shift)
+static void netOnZeroDXC_window_statistics_of_node (const DiagramView & means, const DiagramView & deviations, SequenceSpan sequence, int offset, int w_base, int W)
 {
-	int	l, j, k, ws;
-	double	cross_correlation_coefficient, f_statistics;
+	int	l, j, k, t, ws, start;
+	double	mean, variance;
+	for (l = 0; l < W; l++) {
+		ws = (l + 1) * w_base;
+		double	*means_row = means.row(l);
+		double	*deviations_row = deviations.row(l);
+		for (j = 0; j < means.cols; j++) {
+			k = W * w_base / 2 - 1 + j * w_base;
+			start = k + offset - ws/2 + 1;
+			mean = 0.0;
+			for (t = start; t < start + ws; t++)
+				mean += sequence[t];
+			mean /= (double) ws;
+			variance = 0.0;
+			for (t = start; t < start + ws; t++)
+				variance += (sequence[t] - mean) * (sequence[t] - mean);
+			means_row[j] = mean;
+			deviations_row[j] = sqrt(variance);
+		}
+	}
+}
+
+// Sizes the statistics for N nodes and diagrams of W rows and K columns. Returns 1 if out of memory.
+int netOnZeroDXC_initialize_window_statistics (WindowStatistics & statistics, int N, int W, int K, bool apply_shift)
+{
+	statistics.nr_nodes = N;
+	statistics.nr_views = (apply_shift)? 2 : 1;
+	if (statistics.means.assign(statistics.nr_views * N, W, K, 0.0) || statistics.deviations.assign(statistics.nr_views * N, W, K, 0.0))
+		return 1;
+
+	return 0;
+}
+
+int netOnZeroDXC_compute_node_window_statistics (WindowStatistics & statistics, SequenceSpan sequence, int n, int w_base, int W, int shift)
+{
+	int	N = statistics.nr_nodes;
+	int	v;
+	for (v = 0; v < statistics.nr_views; v++)
+		netOnZeroDXC_window_statistics_of_node(statistics.means.view(v*N + n), statistics.deviations.view(v*N + n), sequence, (v == 0)? 0 : shift, w_base, W);
+
+	return 0;
+}
+
+// Computes the window statistics of the nodes flagged in node_mask; the others are left at zero. Returns 1 if out of memory.
+int netOnZeroDXC_compute_window_statistics (WindowStatistics & statistics, const SequenceStore & sequences, const std::vector <bool> & node_mask,
+						int w_base, int W, bool apply_shift, int shift, bool parallel)
+{
+	int	N = sequences.size();
+	if (netOnZeroDXC_initialize_window_statistics(statistics, N, W, netOnZeroDXC_diagram_positions(sequences.length(), w_base, W, apply_shift, shift), apply_shift))
+		return 1;
+
+	#pragma omp parallel for schedule(dynamic) if(parallel)
+	for (int n = 0; n < N; n++) {
+		if (node_mask[n])
+			netOnZeroDXC_compute_node_window_statistics(statistics, sequences.span(n), n, w_base, W, shift);
+	}
+
+	return 0;
+}
+
+static double netOnZeroDXC_window_crossterm (const double * data_a, const double * data_b, int ws, double mean_a, double mean_b)
+{
+	double	cross_term = 0.0;
+	int	t;
+	for (t = 0; t < ws; t++)
+		cross_term += (data_a[t] - mean_a) * (data_b[t] - mean_b);
+
+	return cross_term;
+}
+
+// Same as above, with means and deviations of the windows of nodes node_a and node_b taken from the statistics;
+// the result is identical to the one computed from scratch, unless the spans carry single-precision copies.
+int netOnZeroDXC_compute_cdiagram (const DiagramView & correlation_diagram, const DiagramView & pvalue_diagram_fisher,
+					SequenceSpan sequence_a, SequenceSpan sequence_b, const WindowStatistics & statistics, int node_a, int node_b,
+					int w_base, int W, bool apply_shift, int shift)
+{
+	return netOnZeroDXC_compute_cdiagram_rows(correlation_diagram, pvalue_diagram_fisher, sequence_a, sequence_b, statistics, node_a, node_b,
+							w_base, W, 0, W, apply_shift, shift);
+}
+
+// Sample size n is the window width, or its effective value for autocorrelated sequences
+static double netOnZeroDXC_fisher_pvalue (double cross_correlation_coefficient, double n)
+{
+	double	f_statistics = n / (1.0/(cross_correlation_coefficient*cross_correlation_coefficient) - 1.0);
+
+	return netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1.0, n - 2.0);
+}
+
+// Effective sample sizes of the windows of a pair, one per width, from the autocorrelations of both sequences
+// (Bartlett): n_eff = ws / (1 + 2 sum_k (1 - k/ws) rho_a(k) rho_b(k)), with lags up to ws/5 as autocorrelations at
+// larger lags are mostly noise. Prefix sums of rho_a*rho_b and k*rho_a*rho_b give each width in O(1).
+// Sizes are kept between 3 and ws.
+static void netOnZeroDXC_effective_sizes (std::vector <double> & sizes, const std::vector <double> & autocorrelation_a, const std::vector <double> & autocorrelation_b,
+						int w_base, int W)
+{
+	int	max_lag = autocorrelation_a.size() - 1;
+	int	l, k, ws, lags;
+	double	product, denominator;
+	std::vector <double>	sum_products(max_lag + 1, 0.0), sum_lag_products(max_lag + 1, 0.0);
+	for (k = 1; k <= max_lag; k++) {
+		product = autocorrelation_a[k] * autocorrelation_b[k];
+		sum_products[k] = sum_products[k - 1] + product;
+		sum_lag_products[k] = sum_lag_products[k - 1] + k * product;
+	}
+
+	sizes.resize(W);
+	for (l = 0; l < W; l++) {
+		ws = (l + 1) * w_base;
+		lags = (ws/5 < max_lag)? ws/5 : max_lag;
+		denominator = 1.0 + 2.0 * (sum_products[lags] - sum_lag_products[lags] / (double) ws);
+		sizes[l] = (denominator > 1.0)? ((double) ws) / denominator : (double) ws;
+		if (sizes[l] < 3.0)
+			sizes[l] = 3.0;
+	}
+}
+
+// Single-precision products of the centered copies, summed in blocks of CROSSTERM_BLOCK samples whose partial sums
+// are added up in double precision, so that the rounding error does not grow with the window width; with SSE2,
+// four products at a time. Means are taken relative to the centers of the copies.
+static double netOnZeroDXC_window_crossterm_single (const float * data_a, const float * data_b, int ws, float mean_a, float mean_b)
+{
+	double	cross_term = 0.0;
+	float	block_sum;
+	int	t, block_end;
+	for (t = 0; t < ws; t = block_end) {
+		block_end = (t + CROSSTERM_BLOCK < ws)? t + CROSSTERM_BLOCK : ws;
+		block_sum = 0.0f;
+#if defined(NETONZERODXC_SSE2)
+		__m128	sums = _mm_setzero_ps();
+		__m128	means_a = _mm_set1_ps(mean_a);
+		__m128	means_b = _mm_set1_ps(mean_b);
+		float	lanes[4];
+		for (; t + 4 <= block_end; t += 4)
+			sums = _mm_add_ps(sums, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(data_a + t), means_a), _mm_sub_ps(_mm_loadu_ps(data_b + t), means_b)));
+		_mm_storeu_ps(lanes, sums);
+		block_sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+		for (; t < block_end; t++)
+			block_sum += (data_a[t] - mean_a) * (data_b[t] - mean_b);
+		cross_term += block_sum;
+	}
+
+	return cross_term;
+}
+
+static double netOnZeroDXC_window_crossterm (SequenceSpan sequence_a, SequenceSpan sequence_b, int start_a, int start_b, int ws, double mean_a, double mean_b)
+{
+	if (sequence_a.data_single && sequence_b.data_single)
+		return netOnZeroDXC_window_crossterm_single(sequence_a.data_single + start_a, sequence_b.data_single + start_b, ws, (float) (mean_a - sequence_a.center),
+								(float) (mean_b - sequence_b.center));
+
+	return netOnZeroDXC_window_crossterm(sequence_a.data + start_a, sequence_b.data + start_b, ws, mean_a, mean_b);
+}
+
+// Coefficient of cell j of row l, from the cached statistics
+static double netOnZeroDXC_window_correlation (SequenceSpan sequence_a, SequenceSpan sequence_b, const WindowStatistics & statistics, int node_a, int node_b,
+						int w_base, int W, int l, int j, bool apply_shift, int shift)
+{
+	int	N = statistics.nr_nodes;
+	int	ws = (l + 1) * w_base;
+	int	k = W * w_base / 2 - 1 + j * w_base;
+	int	start = k - ws/2 + 1;
+	double	cross_correlation_coefficient;
 	if (apply_shift) {
-		for (l = 0; l < W; l++) {
-			j = 0;
-			ws = (l + 1) * w_base;
-			for (k = W * w_base / 2 - 1; k < sequences[node_a].size() - W * w_base / 2 - shift; k = k + w_base) {
-				cross_correlation_coefficient = 0.5 * netOnZeroDXC_compute_crosscorr(sequences, node_a, node_b, k + shift - ws/2 + 1, k + shift + ws/2, k - ws/2 + 1, k + ws/2);
-				cross_correlation_coefficient += 0.5 * netOnZeroDXC_compute_crosscorr(sequences, node_a, node_b, k - ws/2 + 1, k + ws/2, k + shift - ws/2 + 1, k + shift + ws/2);
-				correlation_diagram[l][j] = cross_correlation_coefficient;
-				f_statistics = ((double) ws) / (1.0/(cross_correlation_coefficient*cross_correlation_coefficient) - 1.0);
-				pvalue_diagram_fisher[l][j] = netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1.0, ws - 2.0);
+		cross_correlation_coefficient = 0.5 * (netOnZeroDXC_window_crossterm(sequence_a, sequence_b, start + shift, start, ws, statistics.means.row(N + node_a, l)[j], statistics.means.row(node_b, l)[j])
+							/ statistics.deviations.row(N + node_a, l)[j] / statistics.deviations.row(node_b, l)[j]);
+		cross_correlation_coefficient += 0.5 * (netOnZeroDXC_window_crossterm(sequence_a, sequence_b, start, start + shift, ws, statistics.means.row(node_a, l)[j], statistics.means.row(N + node_b, l)[j])
+							/ statistics.deviations.row(node_a, l)[j] / statistics.deviations.row(N + node_b, l)[j]);
+	} else {
+		cross_correlation_coefficient = netOnZeroDXC_window_crossterm(sequence_a, sequence_b, start, start, ws, statistics.means.row(node_a, l)[j], statistics.means.row(node_b, l)[j])
+							/ statistics.deviations.row(node_a, l)[j] / statistics.deviations.row(node_b, l)[j];
+	}
+
+	return cross_correlation_coefficient;
+}
 
-				j++;
+// Rows first_row to last_row - 1 only; the other rows are left untouched.
+int netOnZeroDXC_compute_cdiagram_rows (const DiagramView & correlation_diagram, const DiagramView & pvalue_diagram_fisher,
+					SequenceSpan sequence_a, SequenceSpan sequence_b, const WindowStatistics & statistics, int node_a, int node_b,
+					int w_base, int W, int first_row, int last_row, bool apply_shift, int shift)
+{
+	int	K = correlation_diagram.cols;
+	int	l, j;
+	double	*correlation_row, *pvalue_row;
+	for (l = first_row; l < last_row; l++) {
+		correlation_row = correlation_diagram.row(l);
+		pvalue_row = (pvalue_diagram_fisher.data)? pvalue_diagram_fisher.row(l) : NULL;
+		for (j = 0; j < K; j++) {
+			correlation_row[j] = netOnZeroDXC_window_correlation(sequence_a, sequence_b, statistics, node_a, node_b, w_base, W, l, j, apply_shift, shift);
+			if (pvalue_row)
+				pvalue_row[j] = netOnZeroDXC_fisher_pvalue(correlation_row[j], (double) ((l + 1) * w_base));
+		}
+	}
+
+	return 0;
+}
+
+// Cells of row l set in cells (row-major over the diagram) only, without F-test p values.
+static void netOnZeroDXC_compute_cdiagram_cells (const DiagramView & correlation_diagram, SequenceSpan sequence_a, SequenceSpan sequence_b, const WindowStatistics & statistics,
+						int node_a, int node_b, int w_base, int W, int l, const std::vector <bool> & cells, bool apply_shift, int shift)
+{
+	int	K = correlation_diagram.cols;
+	int	j;
+	double	*correlation_row = correlation_diagram.row(l);
+	for (j = 0; j < K; j++) {
+		if (cells[(size_t) l * K + j])
+			correlation_row[j] = netOnZeroDXC_window_correlation(sequence_a, sequence_b, statistics, node_a, node_b, w_base, W, l, j, apply_shift, shift);
+	}
+}
+
+// Cells of the diagram whose F-test p value lies within the screening band, hence left to surrogates; a NaN coefficient
+// has no F-test decision and is left to surrogates too. Returns the number of such cells.
+static int netOnZeroDXC_screened_cells (std::vector <bool> & cells, std::vector <bool> & rows, const DiagramView & correlation_diagram, int w_base,
+					const SurrogateScreening & screening)
+{
+	int	K = correlation_diagram.cols;
+	int	l, j, nr_cells = 0;
+	double	pvalue;
+
+	cells.assign((size_t) correlation_diagram.rows * K, false);
+	rows.assign(correlation_diagram.rows, false);
+	for (l = 0; l < correlation_diagram.rows; l++) {
+		const double	*correlation_row = correlation_diagram.row(l);
+		for (j = 0; j < K; j++) {
+			pvalue = netOnZeroDXC_fisher_pvalue(correlation_row[j], (double) ((l + 1) * w_base));
+			if ((!(pvalue < screening.lower_pvalue)) && (!(pvalue > screening.upper_pvalue))) {
+				cells[(size_t) l * K + j] = true;
+				rows[l] = true;
+				nr_cells++;
 			}
 		}
-	} else {
-		for (l = 0; l < W; l++) {
-			j = 0;
-			ws = (l + 1) * w_base;
-			for (k = W * w_base / 2 - 1; k < sequences[node_a].size() - W * w_base / 2; k = k + w_base) {
-				cross_correlation_coefficient = netOnZeroDXC_compute_crosscorr(sequences, node_a, node_b, k - ws/2 + 1, k + ws/2, k - ws/2 + 1, k + ws/2);
-				correlation_diagram[l][j] = cross_correlation_coefficient;
-				f_statistics = ((double) ws) / (1.0/(cross_correlation_coefficient*cross_correlation_coefficient) - 1.0);
-				pvalue_diagram_fisher[l][j] = netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1.0, ws - 2.0);
+	}
+
+	return nr_cells;
+}
+
+// Counts are held as doubles (DiagramSet) or as 16-bit integers (CountSet); undefined integer counts are never updated.
+static void netOnZeroDXC_update_pdiagram_row (double * count_row, const double * data_row, const double * surr_row, int K)
+{
+	int	k;
+	for (k = 0; k < K; k++) {
+		if (data_row[k] < surr_row[k])
+			count_row[k] += 1.0;
+	}
+}
 
-				j++;
+static void netOnZeroDXC_update_pdiagram_row (uint16_t * count_row, const double * data_row, const double * surr_row, int K)
+{
+	int	k;
+	for (k = 0; k < K; k++)
+		count_row[k] += (uint16_t) ((data_row[k] < surr_row[k]) && (count_row[k] != COUNT_UNDEFINED));
+}
+
+static void netOnZeroDXC_update_pdiagram_cells (double * count_row, const double * data_row, const double * surr_row, const std::vector <bool> & cells, size_t offset, int K)
+{
+	int	k;
+	for (k = 0; k < K; k++) {
+		if (cells[offset + k] && (data_row[k] < surr_row[k]))
+			count_row[k] += 1.0;
+	}
+}
+
+static void netOnZeroDXC_update_pdiagram_cells (uint16_t * count_row, const double * data_row, const double * surr_row, const std::vector <bool> & cells, size_t offset, int K)
+{
+	int	k;
+	for (k = 0; k < K; k++) {
+		if (cells[offset + k] && (data_row[k] < surr_row[k]) && (count_row[k] != COUNT_UNDEFINED))
+			count_row[k]++;
+	}
+}
+
+// Row l of the moments holds the number, sum, and sums of squares, cubes and fourth powers of the Fisher-z transformed
+// coefficients of width l, pooled over positions and surrogates; undefined coefficients are left out.
+static void netOnZeroDXC_accumulate_null_moments (const DiagramView & null_moments, const DiagramView & cdiagram_surr)
+{
+	int	l, k;
+	double	z, z_squared;
+	for (l = 0; l < cdiagram_surr.rows; l++) {
+		double		*moments_row = null_moments.row(l);
+		const double	*surr_row = cdiagram_surr.row(l);
+		for (k = 0; k < cdiagram_surr.cols; k++) {
+			z = atanh(surr_row[k]);
+			if (!std::isfinite(z))
+				continue;
+			z_squared = z * z;
+			moments_row[0] += 1.0;
+			moments_row[1] += z;
+			moments_row[2] += z_squared;
+			moments_row[3] += z_squared * z;
+			moments_row[4] += z_squared * z_squared;
+		}
+	}
+}
+
+// Row l of the histogram counts the coefficients of width l, pooled over positions and surrogates, in NULL_HISTOGRAM_BINS
+// equal bins over [-1, 1]; undefined coefficients are left out.
+static void netOnZeroDXC_accumulate_null_histogram (const HistogramView & null_histogram, const DiagramView & cdiagram_surr)
+{
+	int	l, k, b;
+	double	scale = 0.5 * (double) NULL_HISTOGRAM_BINS;
+	for (l = 0; l < cdiagram_surr.rows; l++) {
+		uint32_t	*histogram_row = null_histogram.row(l);
+		const double	*surr_row = cdiagram_surr.row(l);
+		for (k = 0; k < cdiagram_surr.cols; k++) {
+			if (!std::isfinite(surr_row[k]))
+				continue;
+			b = (int) ((surr_row[k] + 1.0) * scale);
+			histogram_row[(b < 0)? 0 : ((b >= NULL_HISTOGRAM_BINS)? NULL_HISTOGRAM_BINS - 1 : b)]++;
+		}
+	}
+}
+
+// P values of a correlation diagram from the pooled surrogate coefficients of each width: the fraction of them above the
+// coefficient, interpolated within its bin. K positions and M surrogates give K*M samples of the null instead of M.
+// Undefined coefficients keep their value; widths without samples get NaN p values.
+int netOnZeroDXC_compute_pooled_pdiagram (const DiagramView & pvalue_diagram, const DiagramView & correlation_diagram, const HistogramView & null_histogram)
+{
+	int	l, k, b;
+	double	scale = 0.5 * (double) NULL_HISTOGRAM_BINS;
+	double	position, total;
+	std::vector <double>	above(NULL_HISTOGRAM_BINS + 1, 0.0);
+	for (l = 0; l < pvalue_diagram.rows; l++) {
+		double		*pvalue_row = pvalue_diagram.row(l);
+		const double	*correlation_row = correlation_diagram.row(l);
+		const uint32_t	*histogram_row = null_histogram.row(l);
+		above[NULL_HISTOGRAM_BINS] = 0.0;
+		for (b = NULL_HISTOGRAM_BINS - 1; b >= 0; b--)		// above[b]: samples in bins b and up
+			above[b] = above[b + 1] + (double) histogram_row[b];
+		total = above[0];
+		for (k = 0; k < pvalue_diagram.cols; k++) {
+			if (!std::isfinite(correlation_row[k]))
+				continue;
+			if (total <= 0.0) {
+				pvalue_row[k] = std::numeric_limits<double>::quiet_NaN();
+				continue;
 			}
+			position = (correlation_row[k] + 1.0) * scale;
+			b = (int) position;
+			if (b < 0)
+				pvalue_row[k] = 1.0;
+			else if (b >= NULL_HISTOGRAM_BINS)
+				pvalue_row[k] = 0.0;
+			else
+				pvalue_row[k] = (above[b + 1] + (double) histogram_row[b] * ((double) (b + 1) - position)) / total;
 		}
 	}
 
 	return 0;
 }
 
-int netOnZeroDXC_update_pdiagram (std::vector < std::vector <double> > & pvalue_diagram, const std::vector < std::vector <double> > & cdiagram_data,
-				const std::vector < std::vector <double> > & cdiagram_surr, int W, int M)
+// Mean, standard deviation, skewness and excess kurtosis of the null distribution of one width, from its moments.
+// Returns 1 if there are too few coefficients or no spread.
+static int netOnZeroDXC_null_fit (double & mean, double & deviation, double & skewness, double & kurtosis, const double * moments_row)
+{
+	double	n = moments_row[0];
+	if (n < 2.0)
+		return 1;
+	mean = moments_row[1] / n;
+	double	m2 = moments_row[2] / n, m3 = moments_row[3] / n, m4 = moments_row[4] / n;
+	double	variance = m2 - mean * mean;
+	if (!(variance > 0.0))
+		return 1;
+	deviation = sqrt(variance);
+	skewness = (m3 - 3.0 * mean * m2 + 2.0 * mean * mean * mean) / (variance * deviation);
+	kurtosis = (m4 - 4.0 * mean * m3 + 6.0 * mean * mean * m2 - 3.0 * mean * mean * mean * mean) / (variance * variance) - 3.0;
+
+	return 0;
+}
+
+// P values of a correlation diagram from a normal fit, for each width, of the Fisher-z transformed surrogate coefficients:
+// the probability that a surrogate exceeds the coefficient, as for counts. Widths without a fit get NaN p values.
+int netOnZeroDXC_compute_parametric_pdiagram (const DiagramView & pvalue_diagram, const DiagramView & correlation_diagram, const DiagramView & null_moments)
 {
-	int	K = pvalue_diagram[0].size();
 	int	l, k;
-	for (l = 0; l < W; l++) {
-		k = 0;
-		for (k = 0; k < K; k++) {
-			if (cdiagram_data[l][k] < cdiagram_surr[l][k]) {
-				pvalue_diagram[l][k] += 1.0 / (double) M;
+	double	mean, deviation, skewness, kurtosis;
+	for (l = 0; l < pvalue_diagram.rows; l++) {
+		double		*pvalue_row = pvalue_diagram.row(l);
+		const double	*correlation_row = correlation_diagram.row(l);
+		if (netOnZeroDXC_null_fit(mean, deviation, skewness, kurtosis, null_moments.row(l))) {
+			for (k = 0; k < pvalue_diagram.cols; k++)
+				pvalue_row[k] = std::numeric_limits<double>::quiet_NaN();
+			continue;
+		}
+		for (k = 0; k < pvalue_diagram.cols; k++)
+			pvalue_row[k] = 0.5 * erfc((atanh(correlation_row[k]) - mean) / (deviation * M_SQRT2));
+	}
+
+	return 0;
+}
+
+// Goodness of fit of the normal null of each width: one row per width with the width, mean and standard deviation of
+// the fit, skewness and excess kurtosis of the transformed surrogate coefficients (both 0 for a normal null).
+int netOnZeroDXC_null_fit_table (std::vector < std::vector <double> > & table, const DiagramView & null_moments, double width_unit)
+{
+	int	l;
+	double	mean, deviation, skewness, kurtosis;
+	double	nan = std::numeric_limits<double>::quiet_NaN();
+	table.assign(null_moments.rows, std::vector <double> (5, nan));
+	for (l = 0; l < null_moments.rows; l++) {
+		table[l][0] = (l + 1) * width_unit;
+		if (!netOnZeroDXC_null_fit(mean, deviation, skewness, kurtosis, null_moments.row(l))) {
+			table[l][1] = mean;
+			table[l][2] = deviation;
+			table[l][3] = skewness;
+			table[l][4] = kurtosis;
+		}
+	}
+
+	return 0;
+}
+
+// Surrogate p-value diagrams hold exceedance counts, exact integers, while surrogates are added; the p values,
+// count / M, are formed once by finalize_pdiagram. Integer counts are kept and compared with count limits instead.
+int netOnZeroDXC_update_pdiagram (const DiagramView & count_diagram, const DiagramView & cdiagram_data, const DiagramView & cdiagram_surr, int W)
+{
+	int	l;
+	for (l = 0; l < W; l++)
+		netOnZeroDXC_update_pdiagram_row(count_diagram.row(l), cdiagram_data.row(l), cdiagram_surr.row(l), count_diagram.cols);
+
+	return 0;
+}
+
+int netOnZeroDXC_update_pdiagram (const CountView & count_diagram, const DiagramView & cdiagram_data, const DiagramView & cdiagram_surr, int W)
+{
+	int	l;
+	for (l = 0; l < W; l++)
+		netOnZeroDXC_update_pdiagram_row(count_diagram.row(l), cdiagram_data.row(l), cdiagram_surr.row(l), count_diagram.cols);
+
+	return 0;
+}
+
+// Turns the exceedance counts of the cells in surrogate_cells (all cells if empty) into p values.
+int netOnZeroDXC_finalize_pdiagram (const DiagramView & count_diagram, int M, const std::vector <bool> & surrogate_cells)
+{
+	int	l, k;
+	for (l = 0; l < count_diagram.rows; l++) {
+		double	*count_row = count_diagram.row(l);
+		for (k = 0; k < count_diagram.cols; k++) {
+			if (surrogate_cells.empty() || surrogate_cells[(size_t) l * count_diagram.cols + k])
+				count_row[k] /= (double) M;
+		}
+	}
+
+	return 0;
+}
+
+// Smallest count whose p value is not below alpha, so that p < alpha exactly when count < count_limit.
+int netOnZeroDXC_count_limit (double alpha, int M)
+{
+	int	c;
+	for (c = 0; c <= M; c++) {
+		if ((double) c / (double) M >= alpha)
+			return c;
+	}
+
+	return M + 1;
+}
+
+// Rows of a partial surrogate count diagram that still need surrogates. Cells never lose significance as counts grow,
+// and those below significance_limit keep it whatever the remaining surrogates, while those from count_limit on have
+// lost it: each efficiency lies between two bounds, and a row is settled once both fall on the same side of threshold_eta;
+// rows past the first crossing are not needed. The efficiency of a settled row lies on the same side as the final one.
+// Cells missing from a non-empty surrogate_cells keep their F-test p value, hence their decision. Returns the number of pending rows.
+template <class View> static int netOnZeroDXC_pending_rows_of (std::vector <bool> & pending_rows, const View & count_diagram, int significance_limit, int count_limit,
+								const EarlyStopping & stopping, const std::vector <bool> & surrogate_cells)
+{
+	int	K = count_diagram.cols;
+	int	l, j, n, step, nr_pending = 0;
+	double	eta_lower, eta_upper;
+	bool	counted;
+
+	pending_rows.assign(count_diagram.rows, false);
+	for (l = 0; l < count_diagram.rows; l++) {
+		step = (stopping.avoid_overlapping)? l + 1 : 1;
+		eta_lower = 0.0;
+		eta_upper = 0.0;
+		n = 0;
+		for (j = 0; j < K; j += step) {
+			counted = surrogate_cells.empty() || surrogate_cells[(size_t) l * K + j];
+			if ((double) count_diagram.row(l)[j] < ((counted)? (double) significance_limit : stopping.threshold_alpha))
+				eta_lower += 1.0;
+			if ((double) count_diagram.row(l)[j] < ((counted)? (double) count_limit : stopping.threshold_alpha))
+				eta_upper += 1.0;
+			n++;
+		}
+		if (eta_lower / (double) n > stopping.threshold_eta)
+			break;
+		if (eta_upper / (double) n > stopping.threshold_eta) {
+			pending_rows[l] = true;
+			nr_pending++;
+		}
+	}
+
+	return nr_pending;
+}
+
+int netOnZeroDXC_pending_rows (std::vector <bool> & pending_rows, const DiagramView & count_diagram, int significance_limit, int count_limit, const EarlyStopping & stopping,
+				const std::vector <bool> & surrogate_cells)
+{
+	return netOnZeroDXC_pending_rows_of(pending_rows, count_diagram, significance_limit, count_limit, stopping, surrogate_cells);
+}
+
+int netOnZeroDXC_pending_rows (std::vector <bool> & pending_rows, const CountView & count_diagram, int significance_limit, int count_limit, const EarlyStopping & stopping,
+				const std::vector <bool> & surrogate_cells)
+{
+	return netOnZeroDXC_pending_rows_of(pending_rows, count_diagram, significance_limit, count_limit, stopping, surrogate_cells);
+}
+
+int netOnZeroDXC_compute_cdiagram_set (DiagramSet & correlation_diagrams, DiagramSet & pvalue_diagrams_fisher,
+					const SequenceStore & sequences, const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a,
+					const std::vector <int> & pair_index_b, int w_base, int W, bool apply_shift, int shift, bool parallel, const EarlyStopping & stopping,
+					const std::vector < std::vector <double> > & autocorrelations)
+{
+	int	nr_pairs = pair_index_a.size();
+	int	k_size = netOnZeroDXC_diagram_positions(sequences.length(), w_base, W, apply_shift, shift);
+	int	p;
+
+	std::vector <bool>	used_sequences(sequences.size(), false);
+	for (p = 0; p < nr_pairs; p++) {
+		if (node_valid[pair_index_a[p]] && node_valid[pair_index_b[p]]) {
+			used_sequences[pair_index_a[p]] = true;
+			used_sequences[pair_index_b[p]] = true;
+		}
+	}
+
+	WindowStatistics	statistics;
+	if (correlation_diagrams.assign(nr_pairs, W, k_size, std::numeric_limits<double>::quiet_NaN())
+		|| pvalue_diagrams_fisher.assign(nr_pairs, W, k_size, std::numeric_limits<double>::quiet_NaN())
+		|| netOnZeroDXC_compute_window_statistics(statistics, sequences, used_sequences, w_base, W, apply_shift, shift, parallel))
+		return 1;
+
+	// With autocorrelations, F-test p values use the effective sample size of each width instead of the width
+	bool	corrected = !autocorrelations.empty();
+	#pragma omp parallel for schedule(dynamic) if(parallel)
+	for (int q = 0; q < nr_pairs; q++) {					// Invalid pairs keep their NaN cells
+		if (!node_valid[pair_index_a[q]] || !node_valid[pair_index_b[q]])
+			continue;
+		if ((!stopping.enabled) && (!corrected)) {
+			netOnZeroDXC_compute_cdiagram(correlation_diagrams.view(q), pvalue_diagrams_fisher.view(q), sequences.span(pair_index_a[q]), sequences.span(pair_index_b[q]),
+							statistics, pair_index_a[q], pair_index_b[q], w_base, W, apply_shift, shift);
+			continue;
+		}
+		DiagramView		no_fisher = {NULL, 0, 0, 0};
+		std::vector <double>	effective_sizes;
+		if (corrected)
+			netOnZeroDXC_effective_sizes(effective_sizes, autocorrelations[pair_index_a[q]], autocorrelations[pair_index_b[q]], w_base, W);
+		for (int l = 0; l < W; l++) {					// Rows past the first crossing of the F-test efficiency keep their NaN cells
+			netOnZeroDXC_compute_cdiagram_rows(correlation_diagrams.view(q), (corrected)? no_fisher : pvalue_diagrams_fisher.view(q), sequences.span(pair_index_a[q]),
+								sequences.span(pair_index_b[q]), statistics, pair_index_a[q], pair_index_b[q], w_base, W, l, l + 1, apply_shift, shift);
+			if (corrected) {
+				double		*pvalue_row = pvalue_diagrams_fisher.row(q, l);
+				const double	*correlation_row = correlation_diagrams.row(q, l);
+				for (int j = 0; j < k_size; j++)
+					pvalue_row[j] = netOnZeroDXC_fisher_pvalue(correlation_row[j], effective_sizes[l]);
+			}
+			if (stopping.enabled && (netOnZeroDXC_efficiency_of_row(pvalue_diagrams_fisher.row(q, l), k_size, (stopping.avoid_overlapping)? l + 1 : 1, stopping.threshold_alpha) > stopping.threshold_eta))
+				break;
+		}
+	}
+
+	return 0;
+}
+
+// Largest and mean absolute difference between the correlation diagrams of the valid pairs and the same diagrams
+// computed from single-precision copies of the sequences, over the cells defined in both. Returns 1 if out of memory.
+int netOnZeroDXC_single_precision_error (double & max_error, double & mean_error, const DiagramSet & correlation_diagrams,
+					const SequenceStore & sequences, const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a,
+					const std::vector <int> & pair_index_b, int w_base, int W, bool apply_shift, int shift, bool parallel)
+{
+	int	nr_pairs = pair_index_a.size();
+	int	nr_threads = (parallel)? omp_get_max_threads() : 1;
+	int	t;
+
+	SequenceStore		single_sequences(sequences);
+	WindowStatistics	statistics;
+	DiagramSet		single_cdiagrams;		// One scratch diagram per thread
+	if ((single_sequences.size() != sequences.size()) || single_sequences.assign_single()
+		|| netOnZeroDXC_compute_window_statistics(statistics, single_sequences, node_valid, w_base, W, apply_shift, shift, parallel)
+		|| single_cdiagrams.assign(nr_threads, W, correlation_diagrams.cols(), 0.0))
+		return 1;
+
+	std::vector <double>	thread_max(nr_threads, 0.0), thread_sum(nr_threads, 0.0);
+	std::vector <size_t>	thread_cells(nr_threads, 0);
+	#pragma omp parallel if(parallel)
+	{
+		int		thread = omp_get_thread_num();
+		DiagramView	single_cdiagram = single_cdiagrams.view(thread);
+		DiagramView	no_fisher = {NULL, 0, 0, 0};
+
+		#pragma omp for schedule(dynamic)
+		for (int q = 0; q < nr_pairs; q++) {
+			if (!node_valid[pair_index_a[q]] || !node_valid[pair_index_b[q]])
+				continue;
+			netOnZeroDXC_compute_cdiagram(single_cdiagram, no_fisher, single_sequences.span(pair_index_a[q]), single_sequences.span(pair_index_b[q]),
+							statistics, pair_index_a[q], pair_index_b[q], w_base, W, apply_shift, shift);
+			for (int l = 0; l < W; l++) {
+				const double	*correlation_row = correlation_diagrams.row(q, l);
+				const double	*single_row = single_cdiagram.row(l);
+				for (int j = 0; j < single_cdiagram.cols; j++) {
+					if (!std::isfinite(correlation_row[j]) || !std::isfinite(single_row[j]))
+						continue;
+					double	error = fabs(single_row[j] - correlation_row[j]);
+					thread_max[thread] = std::max(thread_max[thread], error);
+					thread_sum[thread] += error;
+					thread_cells[thread]++;
+				}
+			}
+		}
+	}
+
+	size_t	nr_cells = 0;
+	max_error = 0.0;
+	mean_error = 0.0;
+	for (t = 0; t < nr_threads; t++) {
+		max_error = std::max(max_error, thread_max[t]);
+		mean_error += thread_sum[t];
+		nr_cells += thread_cells[t];
+	}
+	mean_error = (nr_cells)? mean_error / (double) nr_cells : 0.0;
+
+	return 0;
+}
+
+// With screening, cells outside the band start from their F-test p value and are never updated.
+int netOnZeroDXC_initialize_pdiagram_set (DiagramSet & pvalue_diagrams, const DiagramSet & correlation_diagrams,
+					const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a, const std::vector <int> & pair_index_b, int w_base, int W,
+					const SurrogateScreening & screening)
+{
+	int	nr_pairs = pair_index_a.size();
+	int	K = correlation_diagrams.cols();
+	int	p, l, j;
+
+	if (pvalue_diagrams.assign(nr_pairs, W, K, 0.0))
+		return 1;
+	for (p = 0; p < nr_pairs; p++) {
+		if (!node_valid[pair_index_a[p]] || !node_valid[pair_index_b[p]]) {
+			pvalue_diagrams.fill(p, std::numeric_limits<double>::quiet_NaN());
+		} else if (screening.enabled) {
+			std::vector <bool>	cells, rows;
+			netOnZeroDXC_screened_cells(cells, rows, correlation_diagrams.view(p), w_base, screening);
+			for (l = 0; l < W; l++) {
+				double		*pvalue_row = pvalue_diagrams.row(p, l);
+				const double	*correlation_row = correlation_diagrams.row(p, l);
+				for (j = 0; j < K; j++) {
+					if (!cells[(size_t) l * K + j])
+						pvalue_row[j] = netOnZeroDXC_fisher_pvalue(correlation_row[j], (double) ((l + 1) * w_base));
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Integer counts start from 0, those of pairs with an invalid node are undefined; there is no screening.
+int netOnZeroDXC_initialize_pdiagram_set (CountSet & count_diagrams, const DiagramSet & correlation_diagrams,
+					const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a, const std::vector <int> & pair_index_b, int W)
+{
+	int	nr_pairs = pair_index_a.size();
+	int	p;
+
+	if (count_diagrams.assign(nr_pairs, W, correlation_diagrams.cols(), 0))
+		return 1;
+	for (p = 0; p < nr_pairs; p++) {
+		if (!node_valid[pair_index_a[p]] || !node_valid[pair_index_b[p]])
+			count_diagrams.fill(p, COUNT_UNDEFINED);
+	}
+
+	return 0;
+}
+
+static void netOnZeroDXC_finalize_counts (const DiagramView & count_diagram, int M, const std::vector <bool> & surrogate_cells)
+{
+	netOnZeroDXC_finalize_pdiagram(count_diagram, M, surrogate_cells);
+}
+
+static void netOnZeroDXC_finalize_counts (const CountView &, int, const std::vector <bool> &)		// Integer counts are kept as they are
+{
+}
+
+// Sets up a context for nr_sequences sequences of the given length and diagrams of W x K cells. Returns 1 if out of memory.
+int netOnZeroDXC_initialize_surrogate_context (SurrogateContext & context, int nr_sequences, int length, int W, int K, bool apply_shift, bool parallel,
+						bool single_precision)
+{
+	int	nr_threads = (parallel)? omp_get_max_threads() : 1;
+	context.values_distributions.assign(nr_sequences, std::vector <double> ());
+	context.fft_amplitudes.assign(nr_sequences, std::vector <double> ());
+	context.nodes.clear();
+	context.local_index.assign(nr_sequences, -1);
+	context.surrogate_sequences.clear();
+	context.W = W;
+	context.K = K;
+	context.apply_shift = apply_shift;
+	context.parallel = parallel;
+	context.single_precision = single_precision;
+	if (netOnZeroDXC_initialize_surrogate_workspaces(context.workspaces, nr_threads, length, single_precision)
+		|| context.cdiagrams.assign(nr_threads, W, K, 0.0))
+		return 1;
+
+	return 0;
+}
+
+// Gives the sequences flagged in used_sequences the rows of the surrogates and their statistics, and prepares the generation
+// of those not drawn before. Returns 1 if out of memory.
+static int netOnZeroDXC_select_surrogate_nodes (SurrogateContext & context, const SequenceStore & sequences, const std::vector <bool> & used_sequences)
+{
+	std::vector <int>	nodes;
+	int	n;
+	for (n = 0; n < sequences.size(); n++) {
+		if (used_sequences[n])
+			nodes.push_back(n);
+	}
+	if ((nodes == context.nodes) && (context.surrogate_sequences.size() == nodes.size()))
+		return 0;
+
+	int	nr_nodes = nodes.size();
+	context.nodes.swap(nodes);
+	context.local_index.assign(sequences.size(), -1);
+	for (n = 0; n < nr_nodes; n++)
+		context.local_index[context.nodes[n]] = n;
+	if (context.surrogate_sequences.assign(nr_nodes, sequences.length(), 0.0)
+		|| (context.single_precision && context.surrogate_sequences.assign_single())
+		|| netOnZeroDXC_initialize_window_statistics(context.surrogate_statistics, nr_nodes, context.W, context.K, context.apply_shift)) {
+		context.nodes.clear();
+		context.surrogate_sequences.clear();
+		return 1;
+	}
+
+	#pragma omp parallel for schedule(dynamic) if(context.parallel)
+	for (int i = 0; i < nr_nodes; i++) {
+		int	m = context.nodes[i];
+		if (context.fft_amplitudes[m].empty())
+			netOnZeroDXC_initialize_surrogate_generation(context.values_distributions[m], context.fft_amplitudes[m], sequences.span(m),
+									context.workspaces[omp_get_thread_num()]);
+	}
+
+	return 0;
+}
+
+template <class Set> static int netOnZeroDXC_update_pdiagram_set_of (Set & pvalue_diagrams, SurrogateContext & context, const DiagramSet & correlation_diagrams,
+					const SequenceStore & sequences, const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a,
+					const std::vector <int> & pair_index_b, int M, int first_round, int last_round, int w_base, int W, bool apply_shift, int shift,
+					unsigned int seed, const EarlyStopping & stopping, const SurrogateScreening & screening,
+					DiagramSet & null_moments, HistogramSet & null_histograms)
+{
+	int	nr_sequences = sequences.size();
+	int	nr_pairs = pair_index_a.size();
+	bool	parallel = context.parallel;
+	int	p;
+
+	if (!nr_pairs || (first_round >= last_round))
+		return 0;
+
+	std::vector < std::vector <bool> >	screened_cells;		// Cells left to surrogates, and rows holding any of them
+	std::vector < std::vector <bool> >	screened_rows;
+	std::vector <int>			nr_screened_cells;
+	if (screening.enabled) {
+		screened_cells.assign(nr_pairs, std::vector <bool> ());
+		screened_rows.assign(nr_pairs, std::vector <bool> ());
+		nr_screened_cells.assign(nr_pairs, 0);
+		#pragma omp parallel for schedule(dynamic) if(parallel)
+		for (int q = 0; q < nr_pairs; q++) {
+			if (node_valid[pair_index_a[q]] && node_valid[pair_index_b[q]])
+				nr_screened_cells[q] = netOnZeroDXC_screened_cells(screened_cells[q], screened_rows[q], correlation_diagrams.view(q), w_base, screening);
+		}
+	}
+
+	std::vector <bool>	used_sequences(nr_sequences, false);
+	std::vector <bool>	used_pairs(nr_pairs, false);
+	for (p = 0; p < nr_pairs; p++) {
+		if (node_valid[pair_index_a[p]] && node_valid[pair_index_b[p]] && ((!screening.enabled) || (nr_screened_cells[p] > 0))) {
+			used_sequences[pair_index_a[p]] = true;
+			used_sequences[pair_index_b[p]] = true;
+			used_pairs[p] = true;
+		}
+	}
+	if (netOnZeroDXC_select_surrogate_nodes(context, sequences, used_sequences))
+		return 1;
+
+	// With early stopping, cells below count_limit - (remaining rounds) stay significant whatever the remaining surrogates
+	std::vector < std::vector <bool> >	pending_rows;
+	std::vector <bool>	pending_pairs;
+	const std::vector <bool>	all_cells;
+	int	count_limit = M + 1;
+	if (stopping.enabled) {
+		count_limit = netOnZeroDXC_count_limit(stopping.threshold_alpha, M);
+		pending_rows.assign(nr_pairs, std::vector <bool> ());
+		pending_pairs.assign(nr_pairs, false);
+	}
+
+	int			nr_nodes = context.nodes.size();
+	SequenceStore &		surrogate_sequences = context.surrogate_sequences;	// Row context.local_index[n] holds the surrogate of sequence n
+	WindowStatistics &	surrogate_statistics = context.surrogate_statistics;
+
+	#pragma omp parallel if(parallel)
+	{
+		SurrogateWorkspace &	surrogate_workspace = context.workspaces[omp_get_thread_num()];
+		DiagramView		surrogate_cdiagram = context.cdiagrams.view(omp_get_thread_num());
+		DiagramView		no_fisher = {NULL, 0, 0, 0};
+
+		for (int r = first_round; r < last_round; r++) {		// Each round draws one surrogate per sequence, shared by all pairs;
+			if (stopping.enabled) {					// seeds depend on the round only, so rounds can be split across calls
+				int	significance_limit = count_limit - (M - r);	// Pending rows depend on the counts so far only, as after a resume
+				#pragma omp for schedule(dynamic)
+				for (int q = 0; q < nr_pairs; q++) {
+					if (used_pairs[q])
+						pending_pairs[q] = (netOnZeroDXC_pending_rows(pending_rows[q], pvalue_diagrams.view(q), significance_limit, count_limit, stopping,
+											(screening.enabled)? screened_cells[q] : all_cells) > 0);
+				}
+				#pragma omp single
+				{
+					used_sequences.assign(nr_sequences, false);	// Surrogates are drawn only for sequences of pairs with pending rows
+					for (int q = 0; q < nr_pairs; q++) {
+						if (pending_pairs[q]) {
+							used_sequences[pair_index_a[q]] = true;
+							used_sequences[pair_index_b[q]] = true;
+						}
+					}
+				}
+			}
+
+			#pragma omp for schedule(dynamic)
+			for (int i = 0; i < nr_nodes; i++) {
+				int	n = context.nodes[i];
+				if (!used_sequences[n])
+					continue;
+				netOnZeroDXC_generate_surrogate_sequence(surrogate_sequences.data(i), sequences.span(n), context.values_distributions[n], context.fft_amplitudes[n],
+										TOLERANCE_SURROGATES, seed + r*nr_sequences + n, surrogate_workspace);
+				surrogate_sequences.update_single(i);
+				netOnZeroDXC_compute_node_window_statistics(surrogate_statistics, surrogate_sequences.span(i), i, w_base, W, shift);
+			}
+
+			#pragma omp for schedule(dynamic)
+			for (int q = 0; q < nr_pairs; q++) {
+				if (!used_pairs[q])
+					continue;
+				int	a = context.local_index[pair_index_a[q]];
+				int	b = context.local_index[pair_index_b[q]];
+				if ((!stopping.enabled) && (!screening.enabled)) {
+					netOnZeroDXC_compute_cdiagram(surrogate_cdiagram, no_fisher, surrogate_sequences.span(a), surrogate_sequences.span(b),
+									surrogate_statistics, a, b, w_base, W, apply_shift, shift);
+					netOnZeroDXC_update_pdiagram(pvalue_diagrams.view(q), correlation_diagrams.view(q), surrogate_cdiagram, W);
+					if (null_moments.size())
+						netOnZeroDXC_accumulate_null_moments(null_moments.view(q), surrogate_cdiagram);
+					if (null_histograms.size())
+						netOnZeroDXC_accumulate_null_histogram(null_histograms.view(q), surrogate_cdiagram);
+					continue;
+				}
+				if (stopping.enabled && (!pending_pairs[q]))
+					continue;
+				for (int l = 0; l < W; l++) {
+					if (stopping.enabled && (!pending_rows[q][l]))
+						continue;
+					if (screening.enabled) {
+						if (!screened_rows[q][l])
+							continue;
+						netOnZeroDXC_compute_cdiagram_cells(surrogate_cdiagram, surrogate_sequences.span(a), surrogate_sequences.span(b),
+											surrogate_statistics, a, b, w_base, W, l, screened_cells[q], apply_shift, shift);
+						netOnZeroDXC_update_pdiagram_cells(pvalue_diagrams.row(q, l), correlation_diagrams.row(q, l), surrogate_cdiagram.row(l), screened_cells[q],
+											(size_t) l * correlation_diagrams.cols(), correlation_diagrams.cols());
+					} else {
+						netOnZeroDXC_compute_cdiagram_rows(surrogate_cdiagram, no_fisher, surrogate_sequences.span(a), surrogate_sequences.span(b),
+											surrogate_statistics, a, b, w_base, W, l, l + 1, apply_shift, shift);
+						netOnZeroDXC_update_pdiagram_row(pvalue_diagrams.row(q, l), correlation_diagrams.row(q, l), surrogate_cdiagram.row(l), correlation_diagrams.cols());
+					}
+				}
 			}
 		}
 	}
 
+	if (last_round == M) {
+		for (p = 0; p < nr_pairs; p++) {
+			if (used_pairs[p])
+				netOnZeroDXC_finalize_counts(pvalue_diagrams.view(p), M, (screening.enabled)? screened_cells[p] : all_cells);
+		}
+	}
+
 	return 0;
 }
 
-int netOnZeroDXC_initialize_surrogate_generation (std::vector <double> & values_distribution, std::vector <double> & fft_amplitudes,
-						const std::vector < std::vector <double> > & sequences, int index)
+// Adds rounds first_round to last_round - 1 of M to the p-value diagrams, with the scratch state of context, which must have
+// been set up for the same sequences and diagram sizes. Returns 1 if out of memory.
+int netOnZeroDXC_update_pdiagram_set (DiagramSet & pvalue_diagrams, SurrogateContext & context, const DiagramSet & correlation_diagrams,
+					const SequenceStore & sequences, const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a,
+					const std::vector <int> & pair_index_b, int M, int first_round, int last_round, int w_base, int W, bool apply_shift, int shift,
+					unsigned int seed, const EarlyStopping & stopping, const SurrogateScreening & screening,
+					DiagramSet & null_moments, HistogramSet & null_histograms)
+{
+	return netOnZeroDXC_update_pdiagram_set_of(pvalue_diagrams, context, correlation_diagrams, sequences, node_valid, pair_index_a, pair_index_b, M, first_round, last_round,
+							w_base, W, apply_shift, shift, seed, stopping, screening, null_moments, null_histograms);
+}
+
+// Same as above on integer counts, which are never turned into p values; use CountSet::getPvalueTable.
+int netOnZeroDXC_update_pdiagram_set (CountSet & count_diagrams, SurrogateContext & context, const DiagramSet & correlation_diagrams,
+					const SequenceStore & sequences, const std::vector <bool> & node_valid, const std::vector <int> & pair_index_a,
+					const std::vector <int> & pair_index_b, int M, int first_round, int last_round, int w_base, int W, bool apply_shift, int shift,
+					unsigned int seed, const EarlyStopping & stopping, const SurrogateScreening & screening,
+					DiagramSet & null_moments, HistogramSet & null_histograms)
 {
-	int	N	= sequences[index].size();
-	double	*data	= new double[N];
+	if (M > COUNT_MAX_SURROGATES)
+		return 1;
+
+	return netOnZeroDXC_update_pdiagram_set_of(count_diagrams, context, correlation_diagrams, sequences, node_valid, pair_index_a, pair_index_b, M, first_round, last_round,
+							w_base, W, apply_shift, shift, seed, stopping, screening, null_moments, null_histograms);
+}
+
+// Autocorrelation functions, up to lag max_lag, of the sequences flagged in node_mask (empty for the others), from the
+// power spectrum of the zero-padded sequences. Returns 1 if out of memory.
+int netOnZeroDXC_compute_autocorrelations (std::vector < std::vector <double> > & autocorrelations, const SequenceStore & sequences, const std::vector <bool> & node_mask,
+						int max_lag, bool parallel)
+{
+	int	nr_sequences = sequences.size();
+	int	T = sequences.length();
+	int	L = 2 * T;
+	int	nr_threads = (parallel)? omp_get_max_threads() : 1;
+	int	t;
+
+	autocorrelations.assign(nr_sequences, std::vector <double> ());
+	gsl_fft_real_wavetable		*wavetable_real = gsl_fft_real_wavetable_alloc(L);
+	gsl_fft_halfcomplex_wavetable	*wavetable_halfcomplex = gsl_fft_halfcomplex_wavetable_alloc(L);
+	std::vector <gsl_fft_real_workspace *>	fft_workspaces(nr_threads, (gsl_fft_real_workspace *) NULL);
+	bool	failed = (!wavetable_real) || (!wavetable_halfcomplex);
+	for (t = 0; t < nr_threads; t++) {
+		fft_workspaces[t] = gsl_fft_real_workspace_alloc(L);
+		failed = failed || (!fft_workspaces[t]);
+	}
+
+	if (!failed) {
+		#pragma omp parallel if(parallel)
+		{
+			gsl_fft_real_workspace	*fft_workspace = fft_workspaces[omp_get_thread_num()];
+			std::vector <double>	data(L);
+
+			#pragma omp for schedule(dynamic)
+			for (int n = 0; n < nr_sequences; n++) {
+				if (!node_mask[n])
+					continue;
+				SequenceSpan	sequence = sequences.span(n);
+				double	mean = 0.0;
+				int	i;
+				for (i = 0; i < T; i++)
+					mean += sequence[i];
+				mean /= (double) T;
+				for (i = 0; i < T; i++)
+					data[i] = sequence[i] - mean;
+				for (i = T; i < L; i++)
+					data[i] = 0.0;
+
+				gsl_fft_real_transform(data.data(), 1, L, wavetable_real, fft_workspace);
+				data[0] = data[0] * data[0];
+				for (i = 1; i < L - 1; i += 2) {
+					data[i] = data[i] * data[i] + data[i + 1] * data[i + 1];
+					data[i + 1] = 0.0;
+				}
+				data[L - 1] = data[L - 1] * data[L - 1];			// L is even: last term of the halfcomplex array
+				gsl_fft_halfcomplex_inverse(data.data(), 1, L, wavetable_halfcomplex, fft_workspace);
+
+				autocorrelations[n].assign(max_lag + 1, 0.0);
+				for (i = 0; i <= max_lag; i++)
+					autocorrelations[n][i] = (data[0] > 0.0)? data[i] / data[0] : 0.0;
+			}
+		}
+	}
+
+	for (t = 0; t < nr_threads; t++) {
+		if (fft_workspaces[t])
+			gsl_fft_real_workspace_free(fft_workspaces[t]);
+	}
+	if (wavetable_real)
+		gsl_fft_real_wavetable_free(wavetable_real);
+	if (wavetable_halfcomplex)
+		gsl_fft_halfcomplex_wavetable_free(wavetable_halfcomplex);
+
+	return (failed)? 1 : 0;
+}
 
-	gsl_fft_real_wavetable		*wavetable_real		= gsl_fft_real_wavetable_alloc(N);
-	gsl_fft_real_workspace		*workspace		= gsl_fft_real_workspace_alloc(N);
+// Sizes count workspaces, one per thread, for sequences of the given length. Returns 1 if out of memory.
+int netOnZeroDXC_initialize_surrogate_workspaces (std::vector <SurrogateWorkspace> & workspaces, int count, int length, bool single_precision)
+{
+	if (workspaces.size() != count) {
+		std::vector <SurrogateWorkspace>	temp_workspaces(count);
+		workspaces.swap(temp_workspaces);
+	}
 
-	values_distribution.clear();
 	int	i;
-	for (i = 0; i < N; i++) {
-		data[i] = sequences[index][i];
-		values_distribution.push_back(sequences[index][i]);
+	for (i = 0; i < count; i++) {
+		if (workspaces[i].assign(length, single_precision))
+			return 1;
 	}
+
+	return 0;
+}
+
+// The workspace must have been sized for sequence.length values.
+int netOnZeroDXC_initialize_surrogate_generation (std::vector <double> & values_distribution, std::vector <double> & fft_amplitudes, SequenceSpan sequence,
+						SurrogateWorkspace & workspace)
+{
+	int	N	= sequence.length;
+	double	*data	= workspace.data;
+
+	values_distribution.assign(sequence.data, sequence.data + N);
 	std::sort(values_distribution.begin(), values_distribution.end());
 
-	gsl_fft_real_transform(data, 1, N, wavetable_real, workspace);
+	int	i;
+	memcpy(data, sequence.data, N * sizeof(double));
+	gsl_fft_real_transform(data, 1, N, workspace.wavetable_real, workspace.fft_workspace);
 	fft_amplitudes.clear();
 	for (i = 0; i < N; i++) {
 		if (i == 0) {
@@ -188,66 +1374,137 @@ int netOnZeroDXC_initialize_surrogate_generation (std::vector <double> & values_
 		}
 	}
 
-	delete[] data;
-	gsl_fft_real_workspace_free(workspace);
-	gsl_fft_real_wavetable_free(wavetable_real);
-
 	return 0;
 }
 
-int netOnZeroDXC_generate_surrogate_sequence (std::vector <double> & surrogate_sequence, const std::vector < std::vector <double> > & sequences, int index,
-					const std::vector <double> & values_distribution, const std::vector <double> & fft_amplitudes, double tolerance,
-					unsigned int random_engine_seed)
+// Single-precision counterparts of the iteration steps below, on sequences centered on the mean of
+// values_distribution: the zero-frequency coefficient is then null, and the other amplitudes are restored by
+// scaling each coefficient, which keeps its phase.
+static void netOnZeroDXC_restore_fft_amplitude_single (float * data, const std::vector <double> & fft_amplitudes, int N)
 {
+	int	i;
+	float	modulus, scale;
+	data[0] = 0.0f;
+	for (i = 1; i < N; i++) {
+		if ((i < N-1) || (N%2 != 0)) {
+			modulus = sqrtf(data[i]*data[i] + data[i+1]*data[i+1]);
+			if (modulus > 0.0f) {
+				scale = (float) fft_amplitudes[i/2 + 1] / modulus;
+				data[i] *= scale;
+				data[i+1] *= scale;
+			} else {
+				data[i] = (float) fft_amplitudes[i/2 + 1];
+				data[i+1] = 0.0f;
+			}
+			i++;
+		} else {
+			data[i] = (float) fft_amplitudes[i/2 + 1];
+		}
+	}
+}
 
-	int	N		= sequences[index].size();
-	double	*data		= new double[N];
-	double	*data_prev_iter = new double[N];
+static void netOnZeroDXC_rescale_sequence_single (float * data, const std::vector <double> & values_distribution, double center, int N, PairValueId * ranks)
+{
+	int	i;
+	for (i = 0; i < N; i++) {
+		ranks[i].value = data[i];
+		ranks[i].index = i;
+	}
+
+	std::sort(ranks, ranks + N, netOnZeroDXC_sort_values);
+
+	for (i = 0; i < N; i++)
+		data[ranks[i].index] = (float) (values_distribution[i] - center);
+}
 
-	std::vector <double>	original_sequence(N,0);
+static bool netOnZeroDXC_check_iteration_convergence_single (const float * data, const float * data_prev_iter, int N, double tolerance)
+{
 	int	i;
+	double	z = 0, I = 0;
 	for (i = 0; i < N; i++) {
-		data[i] = sequences[index][i];
-		original_sequence[i] = sequences[index][i];
+		z += ((double) data[i] - data_prev_iter[i])*((double) data[i] - data_prev_iter[i]);
+		I += (double) data[i] * data[i];
 	}
 
-	// Scramble randomly the original sequence
+	return ((z / I) > tolerance)? false : true;
+}
+
+// Iterations of netOnZeroDXC_generate_surrogate_sequence in single precision, from the scrambled sequence in
+// workspace.data. The ranks of the last iteration give the surrogate, so that its values are exactly those of the
+// original sequence.
+static int netOnZeroDXC_refine_surrogate_single (double * surrogate_sequence, const std::vector <double> & values_distribution,
+					const std::vector <double> & fft_amplitudes, double tolerance, SurrogateWorkspace & workspace)
+{
+	int	N		= workspace.length();
+	float	*data		= workspace.data_single;
+	float	*data_prev_iter	= workspace.data_prev_iter_single;
+	double	center		= 0.0;
+	int	i, r = 0;
+
+	for (i = 0; i < N; i++)
+		center += values_distribution[i];
+	center /= (double) N;
+	for (i = 0; i < N; i++) {
+		data[i] = (float) (workspace.data[i] - center);
+		data_prev_iter[i] = 0.0f;
+	}
+	while(r < 1000) {
+		r++;
+		gsl_fft_real_float_transform(data, 1, N, workspace.wavetable_real_single, workspace.fft_workspace_single);
+		netOnZeroDXC_restore_fft_amplitude_single(data, fft_amplitudes, N);
+		gsl_fft_halfcomplex_float_inverse(data, 1, N, workspace.wavetable_halfcomplex_single, workspace.fft_workspace_single);
+		netOnZeroDXC_rescale_sequence_single(data, values_distribution, center, N, workspace.ranks);
+		if (netOnZeroDXC_check_iteration_convergence_single(data, data_prev_iter, N, tolerance))
+			break;
+		memcpy(data_prev_iter, data, N * sizeof(float));
+	}
+
+	for (i = 0; i < N; i++)
+		surrogate_sequence[workspace.ranks[i].index] = values_distribution[i];
+
+	return 0;
+}
+
+// Writes the surrogate of sequence in surrogate_sequence, which holds sequence.length values.
+// The workspace must have been sized for sequence.length values; no memory is allocated here.
+int netOnZeroDXC_generate_surrogate_sequence (double * surrogate_sequence, SequenceSpan sequence, const std::vector <double> & values_distribution,
+					const std::vector <double> & fft_amplitudes, double tolerance, unsigned int random_engine_seed, SurrogateWorkspace & workspace)
+{
+
+	int	N		= sequence.length;
+	double	*data		= workspace.data;
+	double	*data_prev_iter = workspace.data_prev_iter;
+	double	*pool		= workspace.pool;
+
+	memcpy(pool, sequence.data, N * sizeof(double));
+	memset(data_prev_iter, 0, N * sizeof(double));
+
+	// Scramble randomly the original sequence, drawing without replacement from the pool of remaining values
+	int	i;
 	int	r = 0;
-	gsl_rng *random_generator = gsl_rng_alloc(gsl_rng_mt19937);
-	gsl_rng_set(random_generator, random_engine_seed);
+	gsl_rng_set(workspace.random_generator, random_engine_seed);
 	for (i = 0; i < N; i++) {
-		r = gsl_rng_uniform_int(random_generator, original_sequence.size());
-		data[i] = original_sequence[r];
-		original_sequence.erase(original_sequence.begin() + r);
+		r = gsl_rng_uniform_int(workspace.random_generator, N - i);
+		data[i] = pool[r];
+		memmove(pool + r, pool + r + 1, (N - i - r - 1) * sizeof(double));
 	}
 
+	if (workspace.single_precision())
+		return netOnZeroDXC_refine_surrogate_single(surrogate_sequence, values_distribution, fft_amplitudes, tolerance, workspace);
+
 	// Iteratively refine
-	gsl_fft_real_wavetable		*wavetable_real		= gsl_fft_real_wavetable_alloc(N);
-	gsl_fft_halfcomplex_wavetable	*wavetable_halfcomplex	= gsl_fft_halfcomplex_wavetable_alloc(N);
-	gsl_fft_real_workspace		*workspace		= gsl_fft_real_workspace_alloc(N);
 	while(r < 1000) {
 		r++;
-		gsl_fft_real_transform(data, 1, N, wavetable_real, workspace);
+		gsl_fft_real_transform(data, 1, N, workspace.wavetable_real, workspace.fft_workspace);
 		netOnZeroDXC_restore_fft_amplitude(data, fft_amplitudes, N);
-		gsl_fft_halfcomplex_inverse(data, 1, N, wavetable_halfcomplex, workspace);
-		netOnZeroDXC_rescale_sequence(data, values_distribution, N);
+		gsl_fft_halfcomplex_inverse(data, 1, N, workspace.wavetable_halfcomplex, workspace.fft_workspace);
+		netOnZeroDXC_rescale_sequence(data, values_distribution, N, workspace.ranks);
 		if (netOnZeroDXC_check_iteration_convergence(data, data_prev_iter, N, tolerance))
 			break;
 		memcpy(data_prev_iter, data, N * sizeof(double));
 	}
 
-	surrogate_sequence.clear();
-	for (i = 0; i < N; i++)
-		surrogate_sequence.push_back(data[i]);
-
-
-	delete[] data;
-	delete[] data_prev_iter;
-
-	gsl_fft_halfcomplex_wavetable_free(wavetable_halfcomplex);
-	gsl_fft_real_wavetable_free (wavetable_real);
-	gsl_fft_real_workspace_free (workspace);
-	gsl_rng_free(random_generator);
+	memcpy(surrogate_sequence, data, N * sizeof(double));
 
 	return 0;
 }
@@ -274,19 +1531,18 @@ int netOnZeroDXC_restore_fft_amplitude (double * data, const std::vector <double
 	return 0;
 }
 
-int netOnZeroDXC_rescale_sequence (double * data, const std::vector <double> & values_distribution, int N)
+int netOnZeroDXC_rescale_sequence (double * data, const std::vector <double> & values_distribution, int N, PairValueId * ranks)
 {
-	std::vector <PairValueId>	temp_vector(N);
 	int	i;
 	for (i = 0; i < N; i++) {
-		temp_vector[i].value = data[i];
-		temp_vector[i].index = i;
+		ranks[i].value = data[i];
+		ranks[i].index = i;
 	}
 
-	sort(temp_vector.begin(), temp_vector.end(), netOnZeroDXC_sort_values);
+	std::sort(ranks, ranks + N, netOnZeroDXC_sort_values);
 
 	for (i = 0; i < N; i++)
-		data[temp_vector[i].index] = values_distribution[i];
+		data[ranks[i].index] = values_distribution[i];
 
 	return 0;
 }
@@ -306,27 +1562,121 @@ bool netOnZeroDXC_check_iteration_convergence (double * data, double * data_prev
 		return true;
 }
 
-double netOnZeroDXC_compute_wholeseq_crosscorr (const std::vector < std::vector <double> > & sequences, int index_a, int index_b, bool apply_shift, int shift)
+int netOnZeroDXC_compute_wholeseq_crosscorr_matrix (std::vector < std::vector <double> > & matrix, const SequenceStore & sequences,
+					const std::vector <bool> & node_valid, bool apply_shift, int shift, bool parallel)
+{
+	const int	block_rows = 32;
+	const int	block_samples = 512;
+
+	int	N = sequences.size();
+	int	T = (apply_shift)? sequences.length() - shift : sequences.length();
+	int	i, j;
+	int	nr_views = (apply_shift)? 2 : 1;
+
+	// Row v*N + n holds sequence n restricted to its first (v = 0) or last (v = 1) T samples, standardized
+	// so that the correlation coefficient of two rows is their dot product
+	std::vector <double>	views((size_t) nr_views * N * T, 0.0);
+	#pragma omp parallel for schedule(static) if(parallel)
+	for (int n = 0; n < N; n++) {
+		if (!node_valid[n])
+			continue;
+		for (int v = 0; v < nr_views; v++) {
+			const double	*source = sequences.span(n).data + ((v == 0)? 0 : shift);
+			double		*view = &views[((size_t) v * N + n) * T];
+			double		mean = 0.0, norm = 0.0;
+			int		t;
+			for (t = 0; t < T; t++)
+				mean += source[t];
+			mean /= (double) T;
+			for (t = 0; t < T; t++) {
+				view[t] = source[t] - mean;
+				norm += view[t] * view[t];
+			}
+			norm = 1.0 / sqrt(norm);
+			for (t = 0; t < T; t++)
+				view[t] *= norm;
+		}
+	}
+
+	// Upper triangle of V V' (or of the symmetrized product of first and last views), computed by tiles of
+	// rows and samples that stay in cache; each tile of the matrix belongs to one thread
+	int	nr_blocks = (N + block_rows - 1) / block_rows;
+	std::vector < std::pair <int, int> >	tiles;
+	for (i = 0; i < nr_blocks; i++) {
+		for (j = i; j < nr_blocks; j++)
+			tiles.push_back(std::make_pair(i, j));
+	}
+
+	matrix.assign(N, std::vector <double> (N, 0.0));
+	#pragma omp parallel if(parallel)
+	{
+		std::vector <double>	tile_sum(block_rows * block_rows);
+		#pragma omp for schedule(dynamic)
+		for (int b = 0; b < tiles.size(); b++) {
+			int	i0 = tiles[b].first * block_rows;
+			int	j0 = tiles[b].second * block_rows;
+			int	i1 = (i0 + block_rows < N)? i0 + block_rows : N;
+			int	j1 = (j0 + block_rows < N)? j0 + block_rows : N;
+			std::fill(tile_sum.begin(), tile_sum.end(), 0.0);
+			for (int k0 = 0; k0 < T; k0 += block_samples) {
+				int	k1 = (k0 + block_samples < T)? k0 + block_samples : T;
+				for (int a = i0; a < i1; a++) {
+					const double	*head_a = &views[(size_t) a * T];
+					const double	*tail_a = &views[((size_t) (nr_views - 1) * N + a) * T];
+					for (int c = (j0 > a + 1)? j0 : a + 1; c < j1; c++) {
+						const double	*head_c = &views[(size_t) c * T];
+						const double	*tail_c = &views[((size_t) (nr_views - 1) * N + c) * T];
+						double		sum = 0.0;
+						int		k;
+						if (apply_shift) {
+							for (k = k0; k < k1; k++)
+								sum += head_a[k] * tail_c[k] + tail_a[k] * head_c[k];
+						} else {
+							for (k = k0; k < k1; k++)
+								sum += head_a[k] * head_c[k];
+						}
+						tile_sum[(a - i0) * block_rows + (c - j0)] += sum;
+					}
+				}
+			}
+			for (int a = i0; a < i1; a++) {
+				for (int c = (j0 > a + 1)? j0 : a + 1; c < j1; c++) {
+					if (node_valid[a] && node_valid[c])
+						matrix[a][c] = (apply_shift)? 0.5 * tile_sum[(a - i0) * block_rows + (c - j0)] : tile_sum[(a - i0) * block_rows + (c - j0)];
+					else
+						matrix[a][c] = std::numeric_limits<double>::quiet_NaN();
+					matrix[c][a] = matrix[a][c];
+				}
+			}
+		}
+	}
+	for (i = 0; i < N; i++)
+		matrix[i][i] = (node_valid[i])? 1.0 : std::numeric_limits<double>::quiet_NaN();
+
+	return 0;
+}
+
+double netOnZeroDXC_compute_wholeseq_crosscorr (SequenceSpan sequence_a, SequenceSpan sequence_b, bool apply_shift, int shift)
 {
-	int	i;
 	double	cross_correlation = 0.0;
 	if (apply_shift) {
-		cross_correlation = 0.5 * netOnZeroDXC_compute_crosscorr(sequences, index_a, index_b, 0, sequences[index_a].size()-shift-1, shift, sequences[index_b].size()-1);
-		cross_correlation += 0.5 * netOnZeroDXC_compute_crosscorr(sequences, index_a, index_b, shift, sequences[index_a].size()-1, 0, sequences[index_b].size()-shift-1);
+		cross_correlation = 0.5 * netOnZeroDXC_compute_crosscorr(sequence_a, sequence_b, 0, sequence_a.length-shift-1, shift, sequence_b.length-1);
+		cross_correlation += 0.5 * netOnZeroDXC_compute_crosscorr(sequence_a, sequence_b, shift, sequence_a.length-1, 0, sequence_b.length-shift-1);
 	} else {
-		cross_correlation = netOnZeroDXC_compute_crosscorr(sequences, index_a, index_b, 0, sequences[index_a].size()-1, 0, sequences[index_b].size()-1);
+		cross_correlation = netOnZeroDXC_compute_crosscorr(sequence_a, sequence_b, 0, sequence_a.length-1, 0, sequence_b.length-1);
 	}
 	return	cross_correlation;
 }
 
-double netOnZeroDXC_compute_crosscorr (const std::vector < std::vector <double> > & sequences, int index_a, int index_b,
-				int start_a, int end_a, int start_b, int end_b)
+double netOnZeroDXC_compute_crosscorr (SequenceSpan sequence_a, SequenceSpan sequence_b, int start_a, int end_a, int start_b, int end_b)
 {
+	const double	*data_a = sequence_a.data;
+	const double	*data_b = sequence_b.data;
 	int	j = 0;
 	int	n = 0;
 	double	mean_a = 0;
 	for (j = start_a; j <= end_a; j++) {
-		mean_a += sequences[index_a][j];
+		mean_a += data_a[j];
 		n++;
 	}
 	mean_a /= (double) n;
@@ -334,18 +1684,18 @@ double netOnZeroDXC_compute_crosscorr (const std::vector < std::vector <double>
 
 	double	mean_b = 0;
 	for (j = start_b; j <= end_b; j++) {
-		mean_b += sequences[index_b][j];
+		mean_b += data_b[j];
 		n++;
 	}
 	mean_b /= (double) n;
 
 	double	var_a = 0;
 	for (j = start_a; j <= end_a; j++)
-		var_a += (sequences[index_a][j] - mean_a) * (sequences[index_a][j] - mean_a);
+		var_a += (data_a[j] - mean_a) * (data_a[j] - mean_a);
 
 	double	var_b = 0;
 	for (j = start_b; j <= end_b; j++)
-		var_b += (sequences[index_b][j] - mean_b) * (sequences[index_b][j] - mean_b);
+		var_b += (data_b[j] - mean_b) * (data_b[j] - mean_b);
 
 	int	ss = start_a;
 	int	ee = end_a;
@@ -361,7 +1711,7 @@ double netOnZeroDXC_compute_crosscorr (const std::vector < std::vector <double>
 
 	double	cross_correlation_coefficient = 0;
 	for (j = ss; j <= ee; j++)
-		cross_correlation_coefficient += (sequences[index_a][j + r1] - mean_a) * (sequences[index_b][j + r2] - mean_b);
+		cross_correlation_coefficient += (data_a[j + r1] - mean_a) * (data_b[j + r2] - mean_b);
 
 	cross_correlation_coefficient /= sqrt(var_a);
 	cross_correlation_coefficient /= sqrt(var_b);
@@ -371,42 +1721,40 @@ double netOnZeroDXC_compute_crosscorr (const std::vector < std::vector <double>
 
 void netOnZeroDXC_initialize_temp_diagram(std::vector < std::vector <double> > & diagram, int size_x, int size_y)
 {
-	std::vector <double>	temp_row(size_x, 0);
-
-	diagram.clear();
-	int	i;
-	for (i = 0; i < size_y; i++)
-		diagram.push_back(temp_row);
+	diagram.assign(size_y, std::vector <double> (size_x, 0.0));
 
 	return;
 }
 
 void netOnZeroDXC_initialize_nan_diagram(std::vector < std::vector <double> > & diagram, int size_x, int size_y)
 {
-	std::vector <double>	temp_row(size_x, std::numeric_limits<double>::quiet_NaN());
-
-	diagram.clear();
-	int	i;
-	for (i = 0; i < size_y; i++)
-		diagram.push_back(temp_row);
+	diagram.assign(size_y, std::vector <double> (size_x, std::numeric_limits<double>::quiet_NaN()));
 
 	return;
 }
 
 void netOnZeroDXC_initialize_nan_efficiency(std::vector <double> & data_container, int size)
 {
-	data_container.clear();
-	int	i;
-	for (i = 0; i < size; i++)
-		data_container.push_back(std::numeric_limits<double>::quiet_NaN());
+	data_container.assign(size, std::numeric_limits<double>::quiet_NaN());
 
 	return;
 }
 
-double netOnZeroDXC_cdf_f_distribution_Q(double x, int nu1, int nu2)	// Numerical recipes, 6.14.10
+// Number of window positions, i.e. of columns of a diagram, for sequences of the given length.
+int netOnZeroDXC_diagram_positions(int length, int w_base, int W, bool apply_shift, int shift)
+{
+	int	k_size = 0;
+	int	k;
+	for (k = W * w_base / 2 - 1; k < length - W * w_base / 2 - ((apply_shift)? shift : 0); k = k + w_base)
+		k_size++;
+
+	return k_size;
+}
+
+double netOnZeroDXC_cdf_f_distribution_Q(double x, double nu1, double nu2)	// Numerical recipes, 6.14.10
 {
-	double d1 = (double) nu1 / 2.0;
-	double d2 = (double) nu2 / 2.0;
+	double d1 = nu1 / 2.0;
+	double d2 = nu2 / 2.0;
 	double y = d1*x;
 
 	if ( x <= 0.0 ) {
@@ -28,26 +28,132 @@
 //
 // --------------------------------------------------------------------------
 
+#include <cstdint>
+
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+#ifndef INCLUDED_SEQUENCESTORE
+	#include "netOnZeroDXC_sequence_store.hpp"
+	#define INCLUDED_SEQUENCESTORE
+#endif
+#ifndef INCLUDED_SURROGATEWORKSPACE
+	#include "netOnZeroDXC_surrogate_workspace.hpp"
+	#define INCLUDED_SURROGATEWORKSPACE
+#endif
+
 #define TOLERANCE_SURROGATES 1e-6
+#define CROSSTERM_BLOCK 64		// Samples per block of single-precision cross terms, summed in double precision
+#define NULL_MOMENTS 5		// Columns of the moments of a parametric null: count and sums of the first four powers
+#define NULL_HISTOGRAM_BINS 1000	// Bins over [-1, 1] of the pooled null of a window width
+
+// Means and standard deviations of the windows of each node, for all widths and positions of a diagram, so that
+// pair kernels only compute the cross term. Table v*nr_nodes + n refers to node n; for v = 1 windows are shifted
+// forward by the shift.
+struct WindowStatistics {
+	DiagramSet	means;
+	DiagramSet	deviations;
+	int		nr_nodes;
+	int		nr_views;
+};
+
+// A single time-scale matrix only needs, for each pair, the rows (window widths) up to the first one whose efficiency
+// exceeds threshold_eta. When enabled, the remaining rows are left incomplete and only the matrix is meaningful.
+struct EarlyStopping {
+	bool	enabled;
+	double	threshold_alpha;
+	double	threshold_eta;
+	bool	avoid_overlapping;
+};
+
+// Hybrid p values: cells whose F-test p value lies between lower_pvalue and upper_pvalue are tested by surrogates,
+// the others keep the F-test p value.
+struct SurrogateScreening {
+	bool	enabled;
+	double	lower_pvalue;
+	double	upper_pvalue;
+};
+
+// Scratch state of the surrogate rounds of a run, set up once by netOnZeroDXC_initialize_surrogate_context and reused by
+// every call of netOnZeroDXC_update_pdiagram_set: thread workspaces and scratch diagrams, the generation tables of each
+// sequence, prepared the first time it is drawn, and the surrogates and their window statistics for the sequences of the
+// current pairs alone, row i holding sequence nodes[i]. Those are reallocated only when the sequences change.
+struct SurrogateContext {
+	std::vector <SurrogateWorkspace>	workspaces;
+	DiagramSet				cdiagrams;
+	std::vector < std::vector <double> >	values_distributions;
+	std::vector < std::vector <double> >	fft_amplitudes;
+	std::vector <int>			nodes;
+	std::vector <int>			local_index;		// Row of each sequence, -1 if not drawn
+	SequenceStore				surrogate_sequences;	// With single_precision, iterated and correlated in single precision
+	WindowStatistics			surrogate_statistics;
+	int					W;
+	int					K;
+	bool					apply_shift;
+	bool					parallel;
+	bool					single_precision;
+};
+
+// Significance of the cells of a p-value diagram at one threshold, one bit per cell: row l takes words_per_row words
+// from significant + l*words_per_row, bit b of word w standing for position 64*w + b. Undefined (NaN) cells are set in
+// undefined instead. Efficiencies are then population counts, with or without a stride pattern.
+struct SignificanceMask {
+	std::vector <uint64_t>	significant;
+	std::vector <uint64_t>	undefined;
+	int			rows;
+	int			cols;
+	int			words_per_row;
+};
 
 double netOnZeroDXC_compute_wmatrix_element (const std::vector <double> &, const std::vector <double> &, double);
+int netOnZeroDXC_compute_timescale_matrix (std::vector < std::vector <double> > &, const std::vector < std::vector <double> > &, const std::vector <double> &, const std::vector <bool> &, const std::vector < std::vector <int> > &, double);
 int netOnZeroDXC_compute_efficiency (std::vector <double> &, const std::vector < std::vector <double> > &, double, bool);
-int netOnZeroDXC_compute_cdiagram (std::vector < std::vector <double> > &, std::vector < std::vector <double> > &, const std::vector < std::vector <double> > &, int, int, int, int, bool, int);
+int netOnZeroDXC_compute_efficiency (std::vector <double> &, const DiagramView &, double, bool);
+int netOnZeroDXC_compute_efficiency (std::vector <double> &, const CountView &, int, bool);
+int netOnZeroDXC_significance_mask (SignificanceMask &, const std::vector < std::vector <double> > &, double, bool);
+int netOnZeroDXC_significance_mask (SignificanceMask &, const DiagramView &, double, bool);
+int netOnZeroDXC_mask_efficiency (std::vector <double> &, const SignificanceMask &, bool, bool);
+int netOnZeroDXC_compute_cdiagram (const DiagramView &, const DiagramView &, SequenceSpan, SequenceSpan, int, int, bool, int);
+int netOnZeroDXC_compute_cdiagram (const DiagramView &, const DiagramView &, SequenceSpan, SequenceSpan, const WindowStatistics &, int, int, int, int, bool, int);
+int netOnZeroDXC_compute_cdiagram_rows (const DiagramView &, const DiagramView &, SequenceSpan, SequenceSpan, const WindowStatistics &, int, int, int, int, int, int, bool, int);
+int netOnZeroDXC_initialize_window_statistics (WindowStatistics &, int, int, int, bool);
+int netOnZeroDXC_compute_window_statistics (WindowStatistics &, const SequenceStore &, const std::vector <bool> &, int, int, bool, int, bool);
+int netOnZeroDXC_compute_node_window_statistics (WindowStatistics &, SequenceSpan, int, int, int, int);
 
-double netOnZeroDXC_compute_wholeseq_crosscorr (const std::vector < std::vector <double> > &, int, int, bool, int);
-double netOnZeroDXC_compute_crosscorr (const std::vector < std::vector <double> > &, int, int, int, int, int, int);
-int netOnZeroDXC_update_pdiagram (std::vector < std::vector <double> > &, const std::vector < std::vector <double> > &, const std::vector < std::vector <double> > &, int, int);
+int netOnZeroDXC_compute_wholeseq_crosscorr_matrix (std::vector < std::vector <double> > &, const SequenceStore &, const std::vector <bool> &, bool, int, bool);
+double netOnZeroDXC_compute_wholeseq_crosscorr (SequenceSpan, SequenceSpan, bool, int);
+double netOnZeroDXC_compute_crosscorr (SequenceSpan, SequenceSpan, int, int, int, int);
+int netOnZeroDXC_compute_cdiagram_set (DiagramSet &, DiagramSet &, const SequenceStore &, const std::vector <bool> &, const std::vector <int> &, const std::vector <int> &, int, int, bool, int, bool, const EarlyStopping &, const std::vector < std::vector <double> > &);
+int netOnZeroDXC_initialize_pdiagram_set (DiagramSet &, const DiagramSet &, const std::vector <bool> &, const std::vector <int> &, const std::vector <int> &, int, int, const SurrogateScreening &);
+int netOnZeroDXC_initialize_pdiagram_set (CountSet &, const DiagramSet &, const std::vector <bool> &, const std::vector <int> &, const std::vector <int> &, int);
+int netOnZeroDXC_initialize_surrogate_context (SurrogateContext &, int, int, int, int, bool, bool, bool);
+int netOnZeroDXC_update_pdiagram_set (DiagramSet &, SurrogateContext &, const DiagramSet &, const SequenceStore &, const std::vector <bool> &, const std::vector <int> &, const std::vector <int> &, int, int, int, int, int, bool, int, unsigned int, const EarlyStopping &, const SurrogateScreening &, DiagramSet &, HistogramSet &);
+int netOnZeroDXC_update_pdiagram_set (CountSet &, SurrogateContext &, const DiagramSet &, const SequenceStore &, const std::vector <bool> &, const std::vector <int> &, const std::vector <int> &, int, int, int, int, int, bool, int, unsigned int, const EarlyStopping &, const SurrogateScreening &, DiagramSet &, HistogramSet &);
+int netOnZeroDXC_single_precision_error (double &, double &, const DiagramSet &, const SequenceStore &, const std::vector <bool> &, const std::vector <int> &, const std::vector <int> &, int, int, bool, int, bool);
+int netOnZeroDXC_pending_rows (std::vector <bool> &, const DiagramView &, int, int, const EarlyStopping &, const std::vector <bool> &);
+int netOnZeroDXC_pending_rows (std::vector <bool> &, const CountView &, int, int, const EarlyStopping &, const std::vector <bool> &);
+int netOnZeroDXC_update_pdiagram (const DiagramView &, const DiagramView &, const DiagramView &, int);
+int netOnZeroDXC_update_pdiagram (const CountView &, const DiagramView &, const DiagramView &, int);
+int netOnZeroDXC_finalize_pdiagram (const DiagramView &, int, const std::vector <bool> &);
+int netOnZeroDXC_count_limit (double, int);
+int netOnZeroDXC_compute_parametric_pdiagram (const DiagramView &, const DiagramView &, const DiagramView &);
+int netOnZeroDXC_null_fit_table (std::vector < std::vector <double> > &, const DiagramView &, double);
+int netOnZeroDXC_compute_pooled_pdiagram (const DiagramView &, const DiagramView &, const HistogramView &);
 void netOnZeroDXC_initialize_temp_diagram (std::vector < std::vector <double> > &, int, int);
 void netOnZeroDXC_initialize_nan_diagram(std::vector < std::vector <double> > &, int, int);
 void netOnZeroDXC_initialize_nan_efficiency(std::vector <double> &, int);
+int netOnZeroDXC_diagram_positions(int, int, int, bool, int);
 
-int netOnZeroDXC_generate_surrogate_sequence (std::vector <double> &, const std::vector < std::vector <double> > &, int, const std::vector <double> &, const std::vector <double> &, double, unsigned int);
-int netOnZeroDXC_initialize_surrogate_generation (std::vector <double> &, std::vector <double> &, const std::vector < std::vector <double> > &, int);
+int netOnZeroDXC_generate_surrogate_sequence (double *, SequenceSpan, const std::vector <double> &, const std::vector <double> &, double, unsigned int, SurrogateWorkspace &);
+int netOnZeroDXC_initialize_surrogate_generation (std::vector <double> &, std::vector <double> &, SequenceSpan, SurrogateWorkspace &);
+int netOnZeroDXC_initialize_surrogate_workspaces (std::vector <SurrogateWorkspace> &, int, int, bool);
+int netOnZeroDXC_compute_autocorrelations (std::vector < std::vector <double> > &, const SequenceStore &, const std::vector <bool> &, int, bool);
 int netOnZeroDXC_restore_fft_amplitude (double *, const std::vector <double> &, int);
-int netOnZeroDXC_rescale_sequence (double *, const std::vector <double> &, int);
+int netOnZeroDXC_rescale_sequence (double *, const std::vector <double> &, int, PairValueId *);
 bool netOnZeroDXC_check_iteration_convergence (double *, double *, int, double);
 
-double netOnZeroDXC_cdf_f_distribution_Q(double, int, int);
+double netOnZeroDXC_cdf_f_distribution_Q(double, double, double);
 double netOnZeroDXC_incbeta(double, double, double);
 double netOnZeroDXC_incbeta_continued_fraction(double, double, double);
 double netOnZeroDXC_incbeta_approx(double, double, double);
@@ -52,108 +52,41 @@
 	#define INCLUDED_IOFUNCTIONS
 #endif
 
-int netOnZeroDXC_compute_pdiagram (std::vector < std::vector <double> > & pvalue_diagram, WorkerThread* owner_thread, ContainerWorkspace* workspace,
-				double & progress, int index_a, int index_b, int index_diagram, int M, int w_base, int W, bool apply_shift,
-				int shift, int number_threads)
+// Adds the surrogates from round completed_rounds on to the exceedance counts of a block of pairs, a few rounds at a time so
+// that progress is shown and cancellation is honoured in between. Seeds depend on the round and the sequence only, as in
+// netOnZeroDXC_update_pdiagram_set, so that a block resumed from a checkpoint ends as an uninterrupted one. The surrogate
+// context is set up once per run and shared by all blocks.
+// Returns 1 if cancelled, with completed_rounds holding the rounds done so far, 2 if out of memory, 3 when completed_rounds
+// reaches a multiple of checkpoint_rounds short of M, for the caller to save a checkpoint and call again.
+int netOnZeroDXC_compute_pdiagram_block (CountSet & count_diagrams, int & completed_rounds, SurrogateContext & surrogate_context, WorkerThread* owner_thread,
+				ContainerWorkspace* workspace, const DiagramSet & correlation_diagrams, const std::vector <int> & pair_index_a,
+				const std::vector <int> & pair_index_b, int M, int w_base, int W, bool apply_shift, int shift, unsigned int seed, int checkpoint_rounds)
 {
-	std::vector <double>	distribution_values_a, distribution_values_b;
-	std::vector <double>	fft_amplitudes_a, fft_amplitudes_b;
-
-	netOnZeroDXC_initialize_surrogate_generation(distribution_values_a, fft_amplitudes_a, workspace->sequences, index_a);
-	netOnZeroDXC_initialize_surrogate_generation(distribution_values_b, fft_amplitudes_b, workspace->sequences, index_b);
-	std::vector <double>	temp_vector(workspace->diagrams_correlation[index_diagram][0].size(), 0.0);
-
-	bool	go_flag = 1;
-	int	old_progress = -1;
-	int	i;
-	unsigned int	seed;
-	double	progress_step;
-
-	if (number_threads > 1) {
-		omp_set_num_threads(number_threads);
-
-		progress_step = 100.0 * number_threads / ((double) M);
-
-		int	threads_to_run;
-		i = 0;
-		while (i < M) {
-			if (owner_thread->TestDestroy() || owner_thread->parent_frame->workCancelled()) {
-				go_flag = 0;
-				break;
-			}
-
-			threads_to_run = ((M - i) < number_threads)? (M - i) : number_threads;
-			seed = (unsigned int) clock() + 2*i;
-
-			#pragma omp parallel for firstprivate(seed)
-			for (int j = 0; j < threads_to_run; j++) {
-				std::vector < std::vector <double> >	surrogate_cdiagram(W, temp_vector);
-				std::vector < std::vector <double> >	dummy_diagram(W, temp_vector);
-				std::vector <double>			sequence_surrogate_a;
-				std::vector <double>			sequence_surrogate_b;
-				std::vector < std::vector <double> >	sequences_surrogate;
-
-				seed = seed + 2*j;
-				netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_a, workspace->sequences, index_a, distribution_values_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
-				seed = seed + 1;
-				netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_b, workspace->sequences, index_b, distribution_values_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
-				sequences_surrogate.push_back(sequence_surrogate_a);
-				sequences_surrogate.push_back(sequence_surrogate_b);
-				netOnZeroDXC_compute_cdiagram(surrogate_cdiagram, dummy_diagram, sequences_surrogate, 0, 1, w_base, W, apply_shift, shift);
-				#pragma omp critical
-				{
-					netOnZeroDXC_update_pdiagram(pvalue_diagram, workspace->diagrams_correlation[index_diagram], surrogate_cdiagram, W, M);
-					i++;
-				}
-			}
-
-			if (((int) progress) != old_progress) {
-				old_progress = (progress >= 100)? 99 : (int) progress;	// Progress dialog is nasty, values > 100 will make it crash in a bad way.
-				wxThreadEvent eventProgress(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-				eventProgress.SetInt((int) old_progress);
-				wxQueueEvent(owner_thread->parent_frame, eventProgress.Clone());
-			}
-			progress += progress_step;
+	EarlyStopping		no_stopping = {false, 0.0, 0.0, false};
+	SurrogateScreening	no_screening = {false, 0.0, 0.0};
+	DiagramSet		no_moments;
+	HistogramSet		no_histograms;
+
+	int	rounds_per_step = (M + 19) / 20;
+	int	last_round;
+	for (; completed_rounds < M; completed_rounds = last_round) {
+		if (owner_thread->TestDestroy() || owner_thread->parent_frame->workCancelled())
+			return 1;
+		last_round = (completed_rounds + rounds_per_step < M)? completed_rounds + rounds_per_step : M;
+		if (checkpoint_rounds > 0)
+			last_round = std::min(last_round, (completed_rounds / checkpoint_rounds + 1) * checkpoint_rounds);
+		if (netOnZeroDXC_update_pdiagram_set(count_diagrams, surrogate_context, correlation_diagrams, workspace->sequences, workspace->node_valid, pair_index_a,
+							pair_index_b, M, completed_rounds, last_round, w_base, W, apply_shift, shift, seed, no_stopping, no_screening,
+							no_moments, no_histograms))
+			return 2;
+
+		wxThreadEvent eventProgress(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+		eventProgress.SetInt((last_round < M)? 100 * last_round / M : 99);	// Progress dialog is nasty, values > 100 will make it crash in a bad way.
+		wxQueueEvent(owner_thread->parent_frame, eventProgress.Clone());
+		if ((checkpoint_rounds > 0) && (last_round < M) && (last_round % checkpoint_rounds == 0)) {
+			completed_rounds = last_round;
+			return 3;
 		}
-	} else {
-		std::vector < std::vector <double> >	surrogate_cdiagram(W, temp_vector);
-		std::vector < std::vector <double> >	dummy_diagram(W, temp_vector);
-		std::vector <double>			sequence_surrogate_a;
-		std::vector <double>			sequence_surrogate_b;
-		std::vector < std::vector <double> >	sequences_surrogate;
-		progress_step = 100.0 / ((double) M);
-
-		for (i = 0; i < M; i++) {
-			if (owner_thread->TestDestroy() || owner_thread->parent_frame->workCancelled()) {
-				go_flag = 0;
-				break;
-			}
-
-			seed = (unsigned int) clock();
-
-			sequences_surrogate.clear();
-			netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_a, workspace->sequences, index_a, distribution_values_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
-			seed = seed + 1;
-			netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_b, workspace->sequences, index_b, distribution_values_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
-			sequences_surrogate.push_back(sequence_surrogate_a);
-			sequences_surrogate.push_back(sequence_surrogate_b);
-
-			netOnZeroDXC_compute_cdiagram(surrogate_cdiagram, dummy_diagram, sequences_surrogate, 0, 1, w_base, W, apply_shift, shift);
-			netOnZeroDXC_update_pdiagram(pvalue_diagram, workspace->diagrams_correlation[index_diagram], surrogate_cdiagram, W, M);
-
-			if (((int) progress) != old_progress) {
-				old_progress = (progress >= 100)? 99 : (int) progress;
-				wxThreadEvent eventProgress(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-				eventProgress.SetInt((int) old_progress);
-				wxQueueEvent(owner_thread->parent_frame, eventProgress.Clone());
-			}
-			progress += progress_step;
-		}
-	}
-
-
-	if (!go_flag) {
-		return 1;
 	}
 
 	return 0;
@@ -165,8 +98,15 @@ int netOnZeroDXC_compute_wholeseq_pvalue (double & pvalue, WorkerThread* owner_t
 	std::vector <double>	distribution_values_a, distribution_values_b;
 	std::vector <double>	fft_amplitudes_a, fft_amplitudes_b;
 
-	netOnZeroDXC_initialize_surrogate_generation(distribution_values_a, fft_amplitudes_a, workspace->sequences, index_a);
-	netOnZeroDXC_initialize_surrogate_generation(distribution_values_b, fft_amplitudes_b, workspace->sequences, index_b);
+	int					nr_threads = (number_threads > 1)? number_threads : 1;
+	std::vector <SurrogateWorkspace>	surrogate_workspaces;
+	SequenceStore				sequences_surrogate;		// Two sequences per thread, reused by all surrogates
+	if (netOnZeroDXC_initialize_surrogate_workspaces(surrogate_workspaces, nr_threads, workspace->sequences.length(), false)
+		|| sequences_surrogate.assign(2 * nr_threads, workspace->sequences.length(), 0.0))
+		return 2;
+
+	netOnZeroDXC_initialize_surrogate_generation(distribution_values_a, fft_amplitudes_a, workspace->sequences.span(index_a), surrogate_workspaces[0]);
+	netOnZeroDXC_initialize_surrogate_generation(distribution_values_b, fft_amplitudes_b, workspace->sequences.span(index_b), surrogate_workspaces[0]);
 
 	bool	go_flag = 1;
 	int	old_progress = -1;
@@ -194,23 +134,14 @@ int netOnZeroDXC_compute_wholeseq_pvalue (double & pvalue, WorkerThread* owner_t
 
 			#pragma omp parallel for firstprivate(seed)
 			for (int j = 0; j < threads_to_run; j++) {
-				double					temp_xcorr_coeff;
-				std::vector <double>			sequence_surrogate_a;
-				std::vector <double>			sequence_surrogate_b;
-				std::vector < std::vector <double> >	sequences_surrogate;
+				double	temp_xcorr_coeff;
+				int	t = omp_get_thread_num();
 
 				seed = seed + 2*j;
-				netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_a, workspace->sequences, index_a, distribution_values_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
+				netOnZeroDXC_generate_surrogate_sequence(sequences_surrogate.data(2*t), workspace->sequences.span(index_a), distribution_values_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed, surrogate_workspaces[t]);
 				seed = seed + 1;
-				netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_b, workspace->sequences, index_b, distribution_values_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
-				sequences_surrogate.push_back(sequence_surrogate_a);
-				sequences_surrogate.push_back(sequence_surrogate_b);
-				if (apply_shift) {
-					temp_xcorr_coeff = 0.5 * netOnZeroDXC_compute_crosscorr(sequences_surrogate, 0, 1, 0, sequences_surrogate[0].size() - shift, shift, sequences_surrogate[1].size());
-					temp_xcorr_coeff += 0.5 * netOnZeroDXC_compute_crosscorr(sequences_surrogate, 0, 1, shift, sequences_surrogate[0].size(), 0, sequences_surrogate[1].size() - shift);
-				} else {
-					temp_xcorr_coeff = netOnZeroDXC_compute_crosscorr(sequences_surrogate, 0, 1, 0, sequences_surrogate[0].size(), 0, sequences_surrogate[1].size());
-				}
+				netOnZeroDXC_generate_surrogate_sequence(sequences_surrogate.data(2*t + 1), workspace->sequences.span(index_b), distribution_values_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed, surrogate_workspaces[t]);
+				temp_xcorr_coeff = netOnZeroDXC_compute_wholeseq_crosscorr(sequences_surrogate.span(2*t), sequences_surrogate.span(2*t + 1), apply_shift, shift);
 
 				#pragma omp critical
 				{
@@ -230,10 +161,7 @@ int netOnZeroDXC_compute_wholeseq_pvalue (double & pvalue, WorkerThread* owner_t
 			progress += progress_step;
 		}
 	} else {
-		double					temp_xcorr_coeff;
-		std::vector <double>			sequence_surrogate_a;
-		std::vector <double>			sequence_surrogate_b;
-		std::vector < std::vector <double> >	sequences_surrogate;
+		double	temp_xcorr_coeff;
 		progress_step = 100.0 / ((double) M);
 
 		for (i = 0; i < M; i++) {
@@ -244,19 +172,11 @@ int netOnZeroDXC_compute_wholeseq_pvalue (double & pvalue, WorkerThread* owner_t
 
 			seed = (unsigned int) clock();
 
-			sequences_surrogate.clear();
-			netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_a, workspace->sequences, index_a, distribution_values_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
+			netOnZeroDXC_generate_surrogate_sequence(sequences_surrogate.data(0), workspace->sequences.span(index_a), distribution_values_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed, surrogate_workspaces[0]);
 			seed = seed + 1;
-			netOnZeroDXC_generate_surrogate_sequence(sequence_surrogate_b, workspace->sequences, index_b, distribution_values_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
-			sequences_surrogate.push_back(sequence_surrogate_a);
-			sequences_surrogate.push_back(sequence_surrogate_b);
-
-			if (apply_shift) {
-				temp_xcorr_coeff = 0.5 * netOnZeroDXC_compute_crosscorr(sequences_surrogate, 0, 1, 0, sequences_surrogate[0].size() - shift, shift, sequences_surrogate[1].size());
-				temp_xcorr_coeff += 0.5 * netOnZeroDXC_compute_crosscorr(sequences_surrogate, 0, 1, shift, sequences_surrogate[0].size(), 0, sequences_surrogate[1].size() - shift);
-			} else {
-				temp_xcorr_coeff = netOnZeroDXC_compute_crosscorr(sequences_surrogate, 0, 1, 0, sequences_surrogate[0].size(), 0, sequences_surrogate[1].size());
-			}
+			netOnZeroDXC_generate_surrogate_sequence(sequences_surrogate.data(1), workspace->sequences.span(index_b), distribution_values_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed, surrogate_workspaces[0]);
+
+			temp_xcorr_coeff = netOnZeroDXC_compute_wholeseq_crosscorr(sequences_surrogate.span(0), sequences_surrogate.span(1), apply_shift, shift);
 			if (original_xcorr_coeff < temp_xcorr_coeff) {
 				pvalue += (1.0 / ((double) M));
 			}
@@ -279,6 +199,25 @@ int netOnZeroDXC_compute_wholeseq_pvalue (double & pvalue, WorkerThread* owner_t
 	return 0;
 }
 
+int netOnZeroDXC_validate_nodes_by_pairs (ContainerWorkspace* workspace)
+{
+	std::vector < std::vector <int> >	pair_indices;
+	netOnZeroDXC_fill_pair_index_table(pair_indices, workspace->node_pairs, workspace->node_labels);
+
+	int	i, j;
+	bool	node_valid;
+	for (i = 0; i < workspace->node_labels.size(); i++) {		// A node is valid if it takes part in at least one valid pair
+		node_valid = false;
+		for (j = 0; (j < workspace->node_labels.size()) && (!node_valid); j++) {
+			if ((i != j) && (pair_indices[i][j] >= 0))
+				node_valid = workspace->node_pairs_valid[pair_indices[i][j]];
+		}
+		workspace->node_valid.push_back(node_valid);
+	}
+
+	return 0;
+}
+
 int netOnZeroDXC_validate_node_data (ContainerWorkspace* workspace)
 {
 	int loaded_data = workspace->parameter_computation_pathway;
@@ -292,15 +231,7 @@ int netOnZeroDXC_validate_node_data (ContainerWorkspace* workspace)
 	int	i, j, k;
 
 	if (loaded_data < 2) {
-		for (i = 0; i < workspace->node_labels.size(); i++) {
-			workspace->node_valid.push_back(true);
-			for (j = 0; j < workspace->sequences[i].size(); j++) {
-				if (workspace->sequences[i][j] != workspace->sequences[i][j]) {
-					workspace->node_valid.back() = false;
-					break;
-				}
-			}
-		}
+		workspace->node_valid = workspace->sequences.validity();
 		for (i = 0; i < workspace->node_labels.size() - 1; i++) {
 			for (j = i + 1; j < workspace->node_labels.size(); j++) {
 				if (workspace->node_valid[i] && workspace->node_valid[j])
@@ -310,12 +241,17 @@ int netOnZeroDXC_validate_node_data (ContainerWorkspace* workspace)
 			}
 		}
 	} else if (loaded_data == 2) {
-		for (k = 0; k < workspace->diagrams_pvalue.size(); k++) {
+		std::vector < std::vector <double> >	temp_diagram;
+		for (k = 0; k < workspace->input_diagrams.size(); k++) {		// One diagram in memory at a time
 			workspace->node_pairs_valid.push_back(true);
 			stop_search = false;
-			for (i = 0; i < workspace->diagrams_pvalue[k].size(); i++) {
-				for (j = 0; j < workspace->diagrams_pvalue[k][i].size(); j++) {
-					if (workspace->diagrams_pvalue[k][i][j] != workspace->diagrams_pvalue[k][i][j]) {
+			if (workspace->input_diagrams.getDiagram(temp_diagram, k)) {
+				workspace->node_pairs_valid.back() = false;
+				continue;
+			}
+			for (i = 0; i < temp_diagram.size(); i++) {
+				for (j = 0; j < temp_diagram[i].size(); j++) {
+					if (temp_diagram[i][j] != temp_diagram[i][j]) {
 						workspace->node_pairs_valid.back() = false;
 						stop_search = true;
 						break;
@@ -325,19 +261,7 @@ int netOnZeroDXC_validate_node_data (ContainerWorkspace* workspace)
 					break;
 			}
 		}
-		for (i = 0; i < workspace->node_labels.size(); i++) {
-			stop_search = false;
-			for (j = 0; j < workspace->node_labels.size(); j++) {
-				if (i != j) {
-					k = netOnZeroDXC_associate_index_of_pair(workspace->node_pairs, workspace->node_labels, i, j);
-					if (workspace->node_pairs_valid[k]) {
-						stop_search = true;
-						break;
-					}
-				}
-			}
-			workspace->node_valid.push_back(stop_search);
-		}
+		netOnZeroDXC_validate_nodes_by_pairs(workspace);
 	} else if (loaded_data == 3) {
 		for (k = 0; k < workspace->efficiencies.size(); k++) {
 			workspace->node_pairs_valid.push_back(true);
@@ -349,19 +273,7 @@ int netOnZeroDXC_validate_node_data (ContainerWorkspace* workspace)
 				}
 			}
 		}
-		for (i = 0; i < workspace->node_labels.size(); i++) {
-			stop_search = false;
-			for (j = 0; j < workspace->node_labels.size(); j++) {
-				if (i != j) {
-					k = netOnZeroDXC_associate_index_of_pair(workspace->node_pairs, workspace->node_labels, i, j);
-					if (workspace->node_pairs_valid[k]) {
-						stop_search = true;
-						break;
-					}
-				}
-			}
-			workspace->node_valid.push_back(stop_search);
-		}
+		netOnZeroDXC_validate_nodes_by_pairs(workspace);
 	}
 
 	return 0;
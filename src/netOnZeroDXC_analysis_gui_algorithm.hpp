@@ -28,6 +28,7 @@
 //
 // --------------------------------------------------------------------------
 
-int netOnZeroDXC_compute_pdiagram (std::vector < std::vector <double> > &, WorkerThread*, ContainerWorkspace*, double &, int, int, int, int, int, int, bool, int, int);
+int netOnZeroDXC_compute_pdiagram_block (CountSet &, int &, SurrogateContext &, WorkerThread*, ContainerWorkspace*, const DiagramSet &, const std::vector <int> &, const std::vector <int> &, int, int, int, bool, int, unsigned int, int);
 int netOnZeroDXC_compute_wholeseq_pvalue (double &, WorkerThread*, ContainerWorkspace*, double &, int, int, int, bool, int, int);
+int netOnZeroDXC_validate_nodes_by_pairs (ContainerWorkspace*);
 int netOnZeroDXC_validate_node_data (ContainerWorkspace*);
@@ -172,6 +172,8 @@ GuiFrame::GuiFrame (const wxString& title)
 	// Output filename prefix
 	statictext_save_prefix = new wxStaticText(this, wxID_ANY, wxT("Prefix of output file names:"), wxDefaultPosition, wxDefaultSize, 0);
 	textctrl_save_prefix = new wxTextCtrl(this, wxID_ANY, wxT(""), wxDefaultPosition, wxDefaultSize, wxTE_LEFT);
+	checkbox_save_binary = new wxCheckBox(this, wxID_ANY, wxT("Save diagrams in binary format"), wxDefaultPosition, wxDefaultSize, wxCHK_2STATE);
+	checkbox_save_archive = new wxCheckBox(this, wxID_ANY, wxT("Save diagrams and efficiencies\nin a single archive file"), wxDefaultPosition, wxDefaultSize, wxCHK_2STATE);
 
 	// Parallel computation controls
 	checkbox_parallel_omp = new wxCheckBox(this, wxID_ANY, wxT("Enable parallel computing"), wxDefaultPosition, wxDefaultSize, wxCHK_2STATE | wxALIGN_RIGHT);
@@ -259,6 +261,8 @@ GuiFrame::GuiFrame (const wxString& title)
 	wxBoxSizer *vbox_tf_prefix = new wxBoxSizer(wxVERTICAL);
 	vbox_tf_prefix->Add(statictext_save_prefix, 1, wxBOTTOM | wxRESERVE_SPACE_EVEN_IF_HIDDEN, 4);
 	vbox_tf_prefix->Add(textctrl_save_prefix, 0, wxEXPAND | wxRESERVE_SPACE_EVEN_IF_HIDDEN);
+	vbox_tf_prefix->Add(checkbox_save_binary, 0, wxTOP | wxEXPAND | wxRESERVE_SPACE_EVEN_IF_HIDDEN, 8);
+	vbox_tf_prefix->Add(checkbox_save_archive, 0, wxTOP | wxEXPAND | wxRESERVE_SPACE_EVEN_IF_HIDDEN, 4);
 	wxBoxSizer *vbox_tf_save = new wxBoxSizer(wxVERTICAL);
 	vbox_tf_save->Add(statictext_save_header, 0, wxBOTTOM | wxALIGN_LEFT | wxRESERVE_SPACE_EVEN_IF_HIDDEN, 4);
 	vbox_tf_save->Add(checkbox_save_cdiagrams, 1, wxALL | wxEXPAND | wxRESERVE_SPACE_EVEN_IF_HIDDEN);
@@ -711,6 +715,8 @@ GuiFrame::~GuiFrame ()
 	delete	checkbox_save_pdiagrams;
 	delete	checkbox_save_efficiencies;
 	delete	checkbox_save_wholeseq_xcorr;
+	delete	checkbox_save_binary;
+	delete	checkbox_save_archive;
 	delete	checkbox_parallel_omp;
 
 	delete	textctrl_save_prefix;
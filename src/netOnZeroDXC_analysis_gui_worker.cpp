@@ -28,8 +28,11 @@
 //
 // --------------------------------------------------------------------------
 
+#include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <ctime>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -52,6 +55,18 @@
 	#include "netOnZeroDXC_io.hpp"
 	#define INCLUDED_IOFUNCTIONS
 #endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+#ifndef INCLUDED_WRITER
+	#include "netOnZeroDXC_writer.hpp"
+	#define INCLUDED_WRITER
+#endif
+#ifndef INCLUDED_CHECKPOINT
+	#include "netOnZeroDXC_checkpoint.hpp"
+	#define INCLUDED_CHECKPOINT
+#endif
 
 void GuiFrame::setNotReadyStatus ()
 {
@@ -86,6 +101,8 @@ void GuiFrame::setNotReadyStatus ()
 	checkbox_save_pdiagrams->Hide();
 	checkbox_save_efficiencies->Hide();
 	checkbox_save_wholeseq_xcorr->Hide();
+	checkbox_save_binary->Hide();
+	checkbox_save_archive->Hide();
 
 	statictext_threadnum->Hide();
 	checkbox_parallel_omp->Hide();
@@ -146,6 +163,8 @@ void GuiFrame::setReadyStatus (int chosen_pathway)
 	checkbox_save_pdiagrams->Show();
 	checkbox_save_efficiencies->Show();
 	checkbox_save_wholeseq_xcorr->Show();
+	checkbox_save_binary->Show();
+	checkbox_save_archive->Show();
 
 	statictext_save_prefix->Show();
 	textctrl_save_prefix->Show();
@@ -171,7 +190,7 @@ void GuiFrame::setReadyStatus (int chosen_pathway)
 
 	m_workspace->parameter_computation_pathway = chosen_pathway;
 	if (chosen_pathway == 2) {
-		spinner_nr_windowwidths->SetValue(m_workspace->diagrams_pvalue[0].size());
+		spinner_nr_windowwidths->SetValue(m_workspace->input_diagrams.rows());
 	} else if (chosen_pathway == 3) {
 		spinner_nr_windowwidths->SetValue(m_workspace->efficiencies[0].size());
 	}
@@ -216,6 +235,8 @@ int GuiFrame::loadParameterTable ()
 	m_workspace->parameter_print_pdiagrams = checkbox_save_pdiagrams->GetValue();
 	m_workspace->parameter_print_efficiencies = checkbox_save_efficiencies->GetValue();
 	m_workspace->parameter_print_wholeseq_xcorr = checkbox_save_wholeseq_xcorr->GetValue();
+	m_workspace->parameter_print_binary = checkbox_save_binary->GetValue();
+	m_workspace->parameter_print_archive = checkbox_save_archive->GetValue();
 	m_workspace->parameter_overlapping_windows = checkbox_avoid_overlapping->GetValue();
 
 	m_workspace->parameter_use_shift = checkbox_source_leakage->GetValue();
@@ -269,6 +290,19 @@ void GuiFrame::onWorkerStart (wxCommandEvent& WXUNUSED(event))
 		return;
 	}
 
+	m_workspace->parameter_resume = false;
+	if ((m_workspace->parameter_computation_pathway < 2) && (m_workspace->parameter_computation_target >= 1) && (m_workspace->parameter_computation_target <= 3)
+		&& m_workspace->parameter_pvalue_by_surrogate && netOnZeroDXC_check_archive(netOnZeroDXC_generate_filepath(m_workspace->path_output_folder,
+					m_workspace->path_output_prefix, "checkpoint", m_workspace->path_filename_delimiter, "", ""))) {
+		wxMessageDialog dialog_ask_resume(this, "An interrupted run left a checkpoint in the output folder.\nResume previous run?\n(No starts over and discards it.)", "Resume", wxYES_NO | wxCANCEL | wxICON_QUESTION);
+		int	answer = dialog_ask_resume.ShowModal();
+		if (answer == wxID_CANCEL) {
+			thread->Delete();
+			return;
+		}
+		m_workspace->parameter_resume = (answer == wxID_YES);
+	}
+
 	dialog_progress = new wxProgressDialog("Running...", "Processing request:\ninitializing data for the selected pathway.\n", 100, this, wxPD_CAN_ABORT | wxPD_APP_MODAL | wxPD_ELAPSED_TIME | wxPD_REMAINING_TIME);
 	m_cancelled = false;
 	thread->Run();		// Run the thread
@@ -277,16 +311,24 @@ void GuiFrame::onWorkerStart (wxCommandEvent& WXUNUSED(event))
 void GuiFrame::onWorkerEvent (wxThreadEvent& event)
 {
 	int n = event.GetInt();
-	if ((n == -1) || (n == -2) || (n == -3) || (n == -4)) {
+	if ((n == -1) || (n == -2) || (n == -3) || (n == -4) || (n == -5) || (n == -6) || (n == -7)) {
 		dialog_progress->Destroy();
 		dialog_progress = (wxProgressDialog *) NULL;
 		wxWakeUpIdle();
 		if (n == -1)
 			wxMessageBox("Computation ended.", "Info", wxOK, NULL, wxDefaultCoord, wxDefaultCoord);
-		if (n == -3)
+		if ((n == -3) && event.GetString().IsEmpty())
 			wxMessageBox("Error while writing output files!\nPlease check paths and permissions.", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
+		else if (n == -3)
+			wxMessageBox("Error while writing output files!\nFailed on " + event.GetString() + "\nPlease check paths and permissions.", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
 		if (n == -4)
 			wxMessageBox("Unknown error in node labels.\nPlease check file naming and labels.", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
+		if (n == -5)
+			wxMessageBox("Error while reading input diagrams!\nWere the files changed or removed after loading?", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
+		if (n == -6)
+			wxMessageBox("Not enough memory to hold the diagrams!\nPlease reduce the number of threads or the diagram size.", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
+		if (n == -7)
+			wxMessageBox("Cannot resume the previous run!\nThe checkpoint in the output folder " + event.GetString() + ".\nRun again without resuming to start over.", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
 	} else if (n == -255) {
 		dialog_progress->Update(0, "Computing correlation diagrams.\nPress [Cancel] to abort.");
 	} else if ( (n == -254)) {
@@ -328,6 +370,46 @@ WorkerThread::WorkerThread (GuiFrame *frame)
 
 void WorkerThread::OnExit () {}
 
+// Saves the checkpoint of a run computing the block from first_pair on: the partial counts of its nr_pairs pairs (none if
+// no round was completed) and, for target 3, the efficiencies of the pairs before it, which are needed at the end. Outputs
+// of those pairs are written and indexed first, so that the checkpoint never gets ahead of them.
+// Returns 1 if the outputs failed, 2 if the checkpoint did.
+static int netOnZeroDXC_save_gui_checkpoint (ContainerWorkspace* data_container, AsyncWriter & output_writer, ArchiveFile & output_archive, CheckpointInfo info,
+					const CountSet & block_count, int first_pair, int nr_pairs, int completed_rounds, std::string checkpoint_filename, int target, int W)
+{
+	if (output_writer.flush() || netOnZeroDXC_archive_flush(output_archive))
+		return 1;
+
+	info.first_pair = first_pair;
+	info.nr_pairs = nr_pairs;
+	info.completed_rounds = completed_rounds;
+	ArchiveFile	checkpoint_archive;
+	int	error = netOnZeroDXC_checkpoint_open(checkpoint_archive, checkpoint_filename, info);
+	if ((!error) && (nr_pairs > 0)) {
+		std::vector <PairOfLabels>	block_pairs(data_container->node_pairs.begin() + first_pair, data_container->node_pairs.begin() + first_pair + nr_pairs);
+		error = netOnZeroDXC_checkpoint_append(checkpoint_archive, block_count, "pdiag", block_pairs);
+	}
+	if ((!error) && (target == 3) && (first_pair > 0)) {
+		std::vector <PairOfLabels>	done_pairs(data_container->node_pairs.begin(), data_container->node_pairs.begin() + first_pair);
+		DiagramSet	saved_efficiencies, saved_sweeps;
+		if (saved_efficiencies.assign(first_pair, 1, W, 0.0) || saved_sweeps.assign(first_pair, 101, W, 0.0))
+			return 2;
+		int	p, a;
+		for (p = 0; p < first_pair; p++) {
+			std::copy(data_container->efficiencies[p].begin(), data_container->efficiencies[p].end(), saved_efficiencies.row(p, 0));
+			for (a = 0; a <= 100; a++)
+				std::copy(data_container->efficiencies_multialpha[a][p].begin(), data_container->efficiencies_multialpha[a][p].end(), saved_sweeps.row(p, a));
+		}
+		error = netOnZeroDXC_checkpoint_append(checkpoint_archive, saved_efficiencies, "eff", done_pairs);
+		if (!error)
+			error = netOnZeroDXC_checkpoint_append(checkpoint_archive, saved_sweeps, "effsweep", done_pairs);
+	}
+	if (!error)
+		error = netOnZeroDXC_checkpoint_commit(checkpoint_archive, checkpoint_filename);
+
+	return (error)? 2 : 0;
+}
+
 wxThread::ExitCode WorkerThread::Entry ()
 {
 	bool	asked_to_exit = false;
@@ -338,6 +420,8 @@ wxThread::ExitCode WorkerThread::Entry ()
 	bool	print_pdiagrams = data_container->parameter_print_pdiagrams;
 	bool	print_efficiencies = data_container->parameter_print_efficiencies;
 	bool	print_wholeseq_xcorr = data_container->parameter_print_wholeseq_xcorr;
+	bool	print_binary = data_container->parameter_print_binary;
+	bool	print_archive = data_container->parameter_print_archive;
 
 	int	W = data_container->parameter_nr_windowwidths;
 	int	M = data_container->parameter_nr_surrogates;
@@ -356,6 +440,9 @@ wxThread::ExitCode WorkerThread::Entry ()
 	} else {
 		number_threads = -1;
 	}
+	bool	parallel = (number_threads > 1);		// Stages are parallel over pairs; surrogates set their own threads
+	if (parallel)
+		omp_set_num_threads(number_threads);
 
 	char		filename_delimiter = data_container->path_filename_delimiter;
 	std::string	output_path = data_container->path_output_folder;
@@ -370,47 +457,27 @@ wxThread::ExitCode WorkerThread::Entry ()
 	if (target == 4)
 		print_wholeseq_xcorr = true;
 
+	ArchiveFile	output_archive;							// Closed (and indexed) on any exit path
+	AsyncWriter	output_writer(WRITER_QUEUE_SIZE);				// Declared later, hence drained before the archive is closed
+	if (print_archive && (pathway < 3) && (target < 4) && (print_cdiagrams || print_pdiagrams || print_efficiencies)) {
+		if (netOnZeroDXC_archive_open(output_archive, netOnZeroDXC_generate_filepath(output_path, output_prefix, ARCHIVE_LABEL, filename_delimiter, "", ""), data_container->parameter_resume)) {
+			wxThreadEvent eventErrorArchive(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+			eventErrorArchive.SetInt(-3);
+			wxQueueEvent(parent_frame, eventErrorArchive.Clone());
+			return NULL;
+		}
+	}
+
 	if (pathway < 2) {								// If input is a set of sequences
 		if (target >= 4) {
 			wxThreadEvent eventStartPath04(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 			eventStartPath04.SetInt(-251);
 			wxQueueEvent(parent_frame, eventStartPath04.Clone());
 			int	i, j;
-			netOnZeroDXC_initialize_temp_diagram(data_container->wholeseq_xcorr, data_container->node_labels.size(), data_container->node_labels.size());
-			for (i = 0; i < data_container->node_labels.size() - 1; i++) {
-
-				if (data_container->node_valid[i])
-					data_container->wholeseq_xcorr[i][i] = 1.0;
-				else
-					data_container->wholeseq_xcorr[i][i] = std::numeric_limits<double>::quiet_NaN();
-
-				for (j = i + 1; j < data_container->node_labels.size(); j++) {	// Compute cross-correlation between all pairs of time series
-					if (data_container->node_valid[i] && data_container->node_valid[j]) {
-						data_container->wholeseq_xcorr[i][j] = netOnZeroDXC_compute_wholeseq_crosscorr(data_container->sequences, i, j, apply_shift, shift_value);
-						data_container->wholeseq_xcorr[j][i] = data_container->wholeseq_xcorr[i][j];
-					} else {
-						data_container->wholeseq_xcorr[i][j] = std::numeric_limits<double>::quiet_NaN();
-						data_container->wholeseq_xcorr[j][i] = std::numeric_limits<double>::quiet_NaN();
-					}
-					if (parent_frame->workCancelled() || TestDestroy()) {
-						asked_to_exit = true;
-						break;
-					}
-					wxThreadEvent eventUpdate04(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-					eventUpdate04.SetInt(100 * i / data_container->node_labels.size());
-					wxQueueEvent(parent_frame, eventUpdate04.Clone());
-				}
-				if (asked_to_exit)
-					break;
-			}
-			if (asked_to_exit)
+			netOnZeroDXC_compute_wholeseq_crosscorr_matrix(data_container->wholeseq_xcorr, data_container->sequences, data_container->node_valid, apply_shift, shift_value, parallel);
+			if (parent_frame->workCancelled() || TestDestroy())
 				return NULL;
 
-			if (data_container->node_valid[i])
-				data_container->wholeseq_xcorr[i][i] = 1.0;
-			else
-				data_container->wholeseq_xcorr[i][i] = std::numeric_limits<double>::quiet_NaN();
-
 			int	error;
 			if (print_wholeseq_xcorr) {
 				error = netOnZeroDXC_save_diagram(data_container->wholeseq_xcorr, output_path, output_prefix, "wholeseqxcorr", filename_delimiter, "", "", '\t');
@@ -436,9 +503,15 @@ wxThread::ExitCode WorkerThread::Entry ()
 							data_container->wholeseq_pvalue[i][i] = std::numeric_limits<double>::quiet_NaN();
 						for (j = i + 1; j < data_container->node_labels.size(); j++) {
 							if (data_container->node_valid[i] && data_container->node_valid[j]) {
-								asked_to_exit = netOnZeroDXC_compute_wholeseq_pvalue(temp_pvalue, this, data_container, progress_shared, i, j, M, apply_shift, shift_value, number_threads);
+								int	exit_code = netOnZeroDXC_compute_wholeseq_pvalue(temp_pvalue, this, data_container, progress_shared, i, j, M, apply_shift, shift_value, number_threads);
+								asked_to_exit = (exit_code != 0);
 								k++;
-								if (asked_to_exit) {
+								if (exit_code == 2) {
+									wxThreadEvent eventErrorMemory(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+									eventErrorMemory.SetInt(-6);
+									wxQueueEvent(parent_frame, eventErrorMemory.Clone());
+									return NULL;
+								} else if (asked_to_exit) {
 									break;
 								} else {
 									data_container->wholeseq_pvalue[i][j] = temp_pvalue;
@@ -470,18 +543,17 @@ wxThread::ExitCode WorkerThread::Entry ()
 					wxThreadEvent eventStartPath05F(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 					eventStartPath05F.SetInt(-250);
 					wxQueueEvent(parent_frame, eventStartPath05F.Clone());
-					double		temp_pvalue, temp_cc2, f_statistics, temp_n;
-					double		progress_shared = 0.0;
-					int		k = 0;
+					double		temp_n = (double) (data_container->sequences.length() - ((apply_shift)? shift_value : 0));
 					netOnZeroDXC_initialize_temp_diagram(data_container->wholeseq_pvalue, data_container->node_labels.size(), data_container->node_labels.size());	// wholeseq_pvalue is initialized to zeros by this function
 					for (i = 0; i < data_container->node_labels.size() - 1; i++) {
 						if (!data_container->node_valid[i])
 							data_container->wholeseq_pvalue[i][i] = std::numeric_limits<double>::quiet_NaN();
-						for (j = i + 1; j < data_container->node_labels.size(); j++) {
+						#pragma omp parallel for schedule(static) if(parallel)
+						for (int j = i + 1; j < data_container->node_labels.size(); j++) {
 							if (data_container->node_valid[i] && data_container->node_valid[j]) {
-								temp_cc2 = data_container->wholeseq_xcorr[i][j]*data_container->wholeseq_xcorr[i][j];
-								temp_n = (double) (data_container->sequences[0].size() - ((apply_shift)? shift_value : 0));
-								f_statistics = 1.0/(1.0/temp_cc2 - 1.0);
+								double	temp_cc2 = data_container->wholeseq_xcorr[i][j]*data_container->wholeseq_xcorr[i][j];
+								double	f_statistics = 1.0/(1.0/temp_cc2 - 1.0);
+								double	temp_pvalue;
 								f_statistics *= temp_n;
 								temp_pvalue = netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1, temp_n - 2);
 								data_container->wholeseq_pvalue[i][j] = temp_pvalue;
@@ -513,175 +585,356 @@ wxThread::ExitCode WorkerThread::Entry ()
 		}	// End-if target >= 4
 
 		wxThreadEvent eventStartPath0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-		eventStartPath0.SetInt(-255);
+		eventStartPath0.SetInt(((target >= 1) && use_surrogate_generation)? -254 : -255);
 		wxQueueEvent(parent_frame, eventStartPath0.Clone());
 
-		int	k_size = 0;
-		int	k;
-		if (apply_shift) {
-			for (k = W*L / 2 - 1; k < data_container->sequences[0].size() - W*L / 2 - shift_value; k = k + L)
-				k_size++;
-		} else {
-			for (k = W*L / 2 - 1; k < data_container->sequences[0].size() - W*L / 2; k = k + L)
-				k_size++;
-		}
+		int	k_size = netOnZeroDXC_diagram_positions(data_container->sequences.length(), L, W, apply_shift, shift_value);
 
 		int	i, j;
-		std::vector < std::vector <double> >	temp_diagram;
-		std::vector < std::vector <double> >	temp_diagram_fisher_pvalue;
-		data_container->diagrams_correlation.clear();
+		std::vector <int>	pair_index_a, pair_index_b;
 		for (i = 0; i < data_container->node_labels.size() - 1; i++) {
-			for (j = i + 1; j < data_container->node_labels.size(); j++) {	// Compute all correlation diagrams
-				if (parent_frame->workCancelled() || TestDestroy()) {
-					asked_to_exit = true;
-					break;
-				}
-				if (data_container->node_valid[i] && data_container->node_valid[j]) {
-					netOnZeroDXC_initialize_temp_diagram(temp_diagram, k_size, W);
-					netOnZeroDXC_initialize_temp_diagram(temp_diagram_fisher_pvalue, k_size, W);
-					netOnZeroDXC_compute_cdiagram (temp_diagram, temp_diagram_fisher_pvalue, data_container->sequences, i, j, L, W, apply_shift, shift_value);
-				} else {
-					netOnZeroDXC_initialize_nan_diagram(temp_diagram, k_size, W);
-					netOnZeroDXC_initialize_nan_diagram(temp_diagram_fisher_pvalue, k_size, W);
-				}
-				data_container->diagrams_correlation.push_back(temp_diagram);
-				data_container->diagrams_pvalue_fisher.push_back(temp_diagram_fisher_pvalue);
+			for (j = i + 1; j < data_container->node_labels.size(); j++) {
+				pair_index_a.push_back(i);
+				pair_index_b.push_back(j);
 			}
-			if (asked_to_exit)
-				break;
-			wxThreadEvent eventUpdate0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventUpdate0.SetInt(100 * i / data_container->node_labels.size());
-			wxQueueEvent(parent_frame, eventUpdate0.Clone());
 		}
 
-		if (asked_to_exit)
-			return NULL;
+		// Each pair flows through the correlation, p-value and efficiency stages, and its output is handed to the writer
+		// as soon as it is done: only a block of pairs is held in memory, while the writer thread overlaps with the next block.
+		int	nr_pairs = pair_index_a.size();
+		int	block_size = (parallel)? 2*number_threads : 1;
+
+		// Surrogate p values are checkpointed every parameter_checkpoint_rounds rounds, after each block and when the user
+		// cancels, and can be resumed from the block that was running
+		bool		use_checkpoint = (target >= 1) && use_surrogate_generation;
+		std::string	checkpoint_filename = netOnZeroDXC_generate_filepath(output_path, output_prefix, "checkpoint", filename_delimiter, "", "");
+		CheckpointInfo	checkpoint_info;
+		netOnZeroDXC_checkpoint_initialize(checkpoint_info);
+		checkpoint_info.seed = (unsigned int) time(NULL);
+		checkpoint_info.nr_surrogates = M;
+		checkpoint_info.nr_nodes = data_container->node_labels.size();
+		checkpoint_info.basewidth = L;
+		checkpoint_info.nr_windowwidths = W;
+		checkpoint_info.shift = (apply_shift)? shift_value : 0;
+		checkpoint_info.length = data_container->sequences.length();
+		checkpoint_info.threshold_alpha = alpha;
+		checkpoint_info.avoid_overlapping = avoid_overlapping_windows;
+		checkpoint_info.checksum = data_container->sequences.checksum();
+
+		CheckpointInfo	saved_info;
+		netOnZeroDXC_checkpoint_initialize(saved_info);
+		if (use_checkpoint && data_container->parameter_resume) {
+			std::string	mismatch;
+			if (netOnZeroDXC_checkpoint_load_info(saved_info, checkpoint_filename))
+				mismatch = "cannot be read";
+			else
+				mismatch = netOnZeroDXC_checkpoint_mismatch(saved_info, checkpoint_info);
+			if (mismatch.empty() && (saved_info.first_pair + saved_info.nr_pairs > nr_pairs))
+				mismatch = "was saved with different sequences or parameters";
+			if (mismatch.empty() && (target >= 2) && (saved_info.first_pair > 0)		// Efficiencies of the pairs before are already written
+				&& ((saved_info.threshold_alpha != alpha) || (saved_info.avoid_overlapping != avoid_overlapping_windows)))
+				mismatch = "was saved with a different significance threshold or window overlap";
+			if (!mismatch.empty()) {
+				wxThreadEvent eventErrorResume(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventErrorResume.SetInt(-7);
+				eventErrorResume.SetString(mismatch);
+				wxQueueEvent(parent_frame, eventErrorResume.Clone());
+				return NULL;
+			}
+			checkpoint_info.seed = saved_info.seed;
+		}
 
-		if (print_cdiagrams) {							// If necessary, write them in output
-			wxThreadEvent eventPrint0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventPrint0.SetInt(-127);
-			wxQueueEvent(parent_frame, eventPrint0.Clone());
-			int	error;
-			for (i = 0; i < data_container->node_pairs.size(); i++) {
-				error = netOnZeroDXC_save_diagram(data_container->diagrams_correlation[i], output_path, output_prefix, "cdiag", filename_delimiter, data_container->node_pairs[i].label_a, data_container->node_pairs[i].label_b, '\t');
-				if (error) {
-					wxThreadEvent eventError0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-					eventError0.SetInt(-3);
-					wxQueueEvent(parent_frame, eventError0.Clone());
-					return NULL;
+		DiagramSet		block_correlation, block_pvalue;	// block_pvalue holds F-test p values
+		CountSet		block_count;			// Surrogate exceedance counts, set up for each block
+		DiagramView		no_fisher = {NULL, 0, 0, 0};
+		WindowStatistics	window_statistics;		// Window means and deviations of each node, shared by all its pairs
+		SurrogateContext	surrogate_context;		// Surrogate scratch state, reused by all blocks
+		if (block_correlation.assign(std::max(block_size, saved_info.nr_pairs), W, k_size, 0.0) || ((!use_checkpoint) && block_pvalue.assign(block_size, W, k_size, 0.0))
+			|| netOnZeroDXC_compute_window_statistics(window_statistics, data_container->sequences, data_container->node_valid, L, W, apply_shift, shift_value, parallel)
+			|| (use_checkpoint && netOnZeroDXC_initialize_surrogate_context(surrogate_context, data_container->sequences.size(), data_container->sequences.length(),
+											W, k_size, apply_shift, parallel, false))) {
+			wxThreadEvent eventErrorMemory(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+			eventErrorMemory.SetInt(-6);
+			wxQueueEvent(parent_frame, eventErrorMemory.Clone());
+			return NULL;
+		}
+		data_container->diagrams_correlation.clear();
+		data_container->diagrams_pvalue.clear();
+		data_container->diagrams_pvalue_fisher.clear();
+		data_container->efficiencies.assign(nr_pairs, std::vector <double> ());
+		data_container->window_widths.clear();
+		for (i = 0; i < W; i++)
+			data_container->window_widths.push_back((i + 1) * L * T);
+		if (target == 3)		// Efficiencies at different significance thresholds, computed while each diagram is at hand
+			data_container->efficiencies_multialpha.assign(101, std::vector < std::vector <double> > (nr_pairs));
+
+		if (use_checkpoint && data_container->parameter_resume) {
+			int	missing_pair = 0, load_error = 0;
+			if ((target == 3) && (saved_info.first_pair > 0)) {
+				std::vector <PairOfLabels>	done_pairs(data_container->node_pairs.begin(), data_container->node_pairs.begin() + saved_info.first_pair);
+				DiagramSet	saved_efficiencies, saved_sweeps;
+				load_error = netOnZeroDXC_checkpoint_load(saved_efficiencies, missing_pair, checkpoint_filename, "eff", done_pairs, 1, W);
+				if (!load_error)
+					load_error = netOnZeroDXC_checkpoint_load(saved_sweeps, missing_pair, checkpoint_filename, "effsweep", done_pairs, 101, W);
+				for (i = 0; (i < saved_info.first_pair) && (!load_error); i++) {
+					data_container->efficiencies[i].assign(saved_efficiencies.row(i, 0), saved_efficiencies.row(i, 0) + W);
+					for (j = 0; j <= 100; j++)
+						data_container->efficiencies_multialpha[j][i].assign(saved_sweeps.row(i, j), saved_sweeps.row(i, j) + W);
 				}
 			}
+			if ((!load_error) && (saved_info.completed_rounds > 0)) {
+				std::vector <PairOfLabels>	block_pairs(data_container->node_pairs.begin() + saved_info.first_pair,
+										data_container->node_pairs.begin() + saved_info.first_pair + saved_info.nr_pairs);
+				load_error = netOnZeroDXC_checkpoint_load(block_count, missing_pair, checkpoint_filename, "pdiag", block_pairs, W, k_size);
+			}
+			if (load_error) {
+				wxThreadEvent eventErrorResume(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventErrorResume.SetInt((load_error == 2)? -6 : -7);
+				eventErrorResume.SetString((load_error == 1)? "cannot be read" : "lacks some of the pairs already computed");
+				wxQueueEvent(parent_frame, eventErrorResume.Clone());
+				return NULL;
+			}
 		}
-		if (target == 0) {
-			wxThreadEvent eventEnd0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventEnd0.SetInt(-1); // that's it
-			wxQueueEvent(parent_frame, eventEnd0.Clone());
-			return NULL;
-		}									// Otherwise, compute all p-value diagrams
-
-		if (use_surrogate_generation) {
-			double	progress_shared = 0.0;
-			wxThreadEvent eventStartPath1(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventStartPath1.SetInt(-254);
-			wxQueueEvent(parent_frame, eventStartPath1.Clone());
-			data_container->diagrams_pvalue.clear();
-			k = 0;
-			int	error;
-			for (i = 0; i < data_container->node_labels.size() - 1; i++) {
-				for (j = i + 1; j < data_container->node_labels.size(); j++) {
-					if (data_container->node_valid[i] && data_container->node_valid[j]) {
-						netOnZeroDXC_initialize_temp_diagram(temp_diagram, k_size, W);
-						asked_to_exit = netOnZeroDXC_compute_pdiagram(temp_diagram, this, data_container, progress_shared, i, j, k, M, L, W, apply_shift, shift_value, number_threads);
-					} else {
-						netOnZeroDXC_initialize_nan_diagram(temp_diagram, k_size, W);
+
+		std::vector < std::vector <double> >	temp_w_eta(W, std::vector <double> (2, 0.0));
+		std::vector < std::vector <double> >	output_diagram;
+		int	first_pair, last_pair, q, error = 0;
+		int	resume_pair = saved_info.first_pair, resume_rounds = saved_info.completed_rounds;
+		for (first_pair = resume_pair; first_pair < nr_pairs; first_pair = last_pair) {
+			bool	resumed_block = (first_pair == resume_pair) && (resume_rounds > 0);		// block_count holds its partial counts
+			last_pair = (resumed_block)? first_pair + saved_info.nr_pairs : std::min(first_pair + block_size, nr_pairs);
+			if (parent_frame->workCancelled() || TestDestroy()) {
+				if (use_checkpoint)
+					netOnZeroDXC_save_gui_checkpoint(data_container, output_writer, output_archive, checkpoint_info, block_count, first_pair,
+										(resumed_block)? last_pair - first_pair : 0, (resumed_block)? resume_rounds : 0, checkpoint_filename, target, W);
+				return NULL;
+			}
+
+			#pragma omp parallel for schedule(dynamic) if(parallel)
+			for (int p = first_pair; p < last_pair; p++) {
+				int	b = p - first_pair;
+				if (data_container->node_valid[pair_index_a[p]] && data_container->node_valid[pair_index_b[p]]) {
+					netOnZeroDXC_compute_cdiagram(block_correlation.view(b), (use_checkpoint)? no_fisher : block_pvalue.view(b), data_container->sequences.span(pair_index_a[p]),
+									data_container->sequences.span(pair_index_b[p]), window_statistics, pair_index_a[p], pair_index_b[p], L, W, apply_shift, shift_value);
+				} else {
+					block_correlation.fill(b, std::numeric_limits<double>::quiet_NaN());
+					if (!use_checkpoint)
+						block_pvalue.fill(b, std::numeric_limits<double>::quiet_NaN());
+				}
+			}
+
+			if (use_checkpoint) {		// Surrogates of each round are drawn once per sequence and shared by the pairs of the block
+				std::vector <int>	block_index_a(pair_index_a.begin() + first_pair, pair_index_a.begin() + last_pair);
+				std::vector <int>	block_index_b(pair_index_b.begin() + first_pair, pair_index_b.begin() + last_pair);
+				int	completed_rounds = (resumed_block)? resume_rounds : 0;
+				int	exit_code = 0;
+				if ((!resumed_block) && netOnZeroDXC_initialize_pdiagram_set(block_count, block_correlation, data_container->node_valid, block_index_a, block_index_b, W))
+					exit_code = 2;
+
+				std::stringstream	message_updated;
+				message_updated << "Computing p-value diagrams by surrogate generation.\nThis can take a very long time.\nPairs ";
+				message_updated << first_pair + 1 << " to " << last_pair << " out of " << nr_pairs << "\nPress [Cancel] to abort.";
+				wxString	message = message_updated.str();
+				wxThreadEvent eventNewPair(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventNewPair.SetInt(-63);
+				eventNewPair.SetString(message);
+				wxQueueEvent(parent_frame, eventNewPair.Clone());
+
+				int	checkpoint_error = 0;
+				while ((!exit_code) && (completed_rounds < M)) {
+					exit_code = netOnZeroDXC_compute_pdiagram_block(block_count, completed_rounds, surrogate_context, this, data_container, block_correlation,
+											block_index_a, block_index_b, M, L, W, apply_shift, shift_value, checkpoint_info.seed,
+											data_container->parameter_checkpoint_rounds);
+					if (exit_code == 3) {
+						checkpoint_error = netOnZeroDXC_save_gui_checkpoint(data_container, output_writer, output_archive, checkpoint_info, block_count,
+													first_pair, last_pair - first_pair, completed_rounds, checkpoint_filename, target, W);
+						if (!checkpoint_error)
+							exit_code = 0;
 					}
-					k++;
-					if (asked_to_exit) {
-						break;
+				}
+				if (exit_code == 3) {
+					wxThreadEvent eventErrorCheckpoint(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+					eventErrorCheckpoint.SetInt(-3);
+					eventErrorCheckpoint.SetString((checkpoint_error == 2)? checkpoint_filename : output_writer.failedOutput());
+					wxQueueEvent(parent_frame, eventErrorCheckpoint.Clone());
+					return NULL;
+				} else if (exit_code == 2) {
+					wxThreadEvent eventErrorMemory(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+					eventErrorMemory.SetInt(-6);
+					wxQueueEvent(parent_frame, eventErrorMemory.Clone());
+					return NULL;
+				} else if (exit_code == 1) {
+					netOnZeroDXC_save_gui_checkpoint(data_container, output_writer, output_archive, checkpoint_info, block_count, first_pair,
+										(completed_rounds > 0)? last_pair - first_pair : 0, completed_rounds, checkpoint_filename, target, W);
+					return NULL;
+				}
+			}
+
+			if (target >= 2) {
+				#pragma omp parallel for schedule(dynamic) if(parallel)
+				for (int p = first_pair; p < last_pair; p++) {
+					int	b = p - first_pair;
+					if (data_container->node_pairs_valid[p] && use_checkpoint) {		// Counts are compared with the count limit of each threshold
+						netOnZeroDXC_compute_efficiency(data_container->efficiencies[p], block_count.view(b), netOnZeroDXC_count_limit(alpha, M), avoid_overlapping_windows);
+						if (target == 3) {
+							for (int a = 0; a <= 100; a++)
+								netOnZeroDXC_compute_efficiency(data_container->efficiencies_multialpha[a][p], block_count.view(b), netOnZeroDXC_count_limit(((double) a) / 1000.0, M),
+												avoid_overlapping_windows);
+						}
+					} else if (data_container->node_pairs_valid[p]) {
+						netOnZeroDXC_compute_efficiency(data_container->efficiencies[p], block_pvalue.view(b), alpha, avoid_overlapping_windows);
+						if (target == 3) {
+							for (int a = 0; a <= 100; a++)
+								netOnZeroDXC_compute_efficiency(data_container->efficiencies_multialpha[a][p], block_pvalue.view(b), ((double) a) / 1000.0, avoid_overlapping_windows);
+						}
 					} else {
-						data_container->diagrams_pvalue.push_back(temp_diagram);
-
-						std::stringstream	message_updated;
-						message_updated << "Computing p-value diagrams by surrogate generation.\nThis can take a very long time.\nPair ";
-						message_updated << k << " out of " << data_container->node_pairs.size() << "\nPress [Cancel] to abort.";
-						wxString	message = message_updated.str();
-						wxThreadEvent eventNewPair(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-						eventNewPair.SetInt(-63);
-						eventNewPair.SetString(message);
-						wxQueueEvent(parent_frame, eventNewPair.Clone());
-						progress_shared = 0.0;
-
-						if (print_pdiagrams) {
-							error = netOnZeroDXC_save_diagram(temp_diagram, output_path, output_prefix, "pdiag", filename_delimiter, data_container->node_labels[i], data_container->node_labels[j], '\t');
-							if (error) {
-								wxThreadEvent eventError0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-								eventError0.SetInt(-3);
-								wxQueueEvent(parent_frame, eventError0.Clone());
-								return NULL;
-							}
+						netOnZeroDXC_initialize_nan_efficiency(data_container->efficiencies[p], W);
+						if (target == 3) {
+							for (int a = 0; a <= 100; a++)
+								netOnZeroDXC_initialize_nan_efficiency(data_container->efficiencies_multialpha[a][p], W);
 						}
 					}
 				}
-				if (asked_to_exit)
-					break;
 			}
-			asked_to_exit = parent_frame->workCancelled();
 
-			if (asked_to_exit)
-				return NULL;
-		} else if (!use_surrogate_generation) {
-			int	error;
-			data_container->diagrams_pvalue.clear();
-			for (k = 0; k < data_container->diagrams_pvalue_fisher.size(); k++) {
-				data_container->diagrams_pvalue.push_back(data_container->diagrams_pvalue_fisher[k]);
-				if (print_pdiagrams) {
-					error = netOnZeroDXC_save_diagram(data_container->diagrams_pvalue_fisher[k], output_path, output_prefix, "pdiag", filename_delimiter, data_container->node_pairs[k].label_a, data_container->node_pairs[k].label_b, '\t');
-					if (error) {
-						wxThreadEvent eventError0F(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-						eventError0F.SetInt(-3);
-						wxQueueEvent(parent_frame, eventError0F.Clone());
-						return NULL;
+			for (q = first_pair; (q < last_pair) && (!error); q++) {		// Output keeps the order of pairs
+				const PairOfLabels &	pair = data_container->node_pairs[q];
+				if (print_cdiagrams) {
+					block_correlation.getTable(output_diagram, q - first_pair);
+					if (print_archive)
+						error = output_writer.appendArchive(output_archive, std::move(output_diagram), "cdiag", pair.label_a, pair.label_b, BINARY_TABLE_FLOAT32, 0);
+					else if (print_binary)
+						error = output_writer.saveDiagramBinary(std::move(output_diagram), output_path, output_prefix, "cdiag", filename_delimiter, pair.label_a, pair.label_b, BINARY_TABLE_FLOAT32, 0);
+					else
+						error = output_writer.saveDiagram(std::move(output_diagram), output_path, output_prefix, "cdiag", filename_delimiter, pair.label_a, pair.label_b, '\t');
+				}
+				if ((!error) && (target >= 1) && print_pdiagrams) {
+					if (use_checkpoint)
+						block_count.getPvalueTable(output_diagram, q - first_pair, M);
+					else
+						block_pvalue.getTable(output_diagram, q - first_pair);
+					if (print_archive)
+						error = output_writer.appendArchive(output_archive, std::move(output_diagram), "pdiag", pair.label_a, pair.label_b, (use_surrogate_generation)? BINARY_TABLE_COUNTS16 : BINARY_TABLE_FLOAT32, (use_surrogate_generation)? M : 0);
+					else if (print_binary)
+						error = output_writer.saveDiagramBinary(std::move(output_diagram), output_path, output_prefix, "pdiag", filename_delimiter, pair.label_a, pair.label_b, (use_surrogate_generation)? BINARY_TABLE_COUNTS16 : BINARY_TABLE_FLOAT32, (use_surrogate_generation)? M : 0);
+					else
+						error = output_writer.saveDiagram(std::move(output_diagram), output_path, output_prefix, "pdiag", filename_delimiter, pair.label_a, pair.label_b, '\t');
+				}
+				if ((!error) && (target >= 2) && print_efficiencies) {
+					if (print_archive) {
+						for (j = 0; j < W; j++) {
+							temp_w_eta[j][0] = data_container->window_widths[j];
+							temp_w_eta[j][1] = data_container->efficiencies[q][j];
+						}
+						error = output_writer.appendArchive(output_archive, temp_w_eta, "eff", pair.label_a, pair.label_b, BINARY_TABLE_FLOAT64, 0);
+					} else {
+						error = output_writer.saveLinearData(data_container->window_widths, data_container->efficiencies[q], output_path, output_prefix, "eff", filename_delimiter, pair.label_a, pair.label_b, '\t');
 					}
 				}
 			}
+			if (error) {
+				wxThreadEvent eventError0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventError0.SetInt(-3);
+				eventError0.SetString(output_writer.failedOutput());
+				wxQueueEvent(parent_frame, eventError0.Clone());
+				return NULL;
+			}
+			if (use_checkpoint && (last_pair < nr_pairs)) {			// The next block starts from scratch
+				int	checkpoint_error = netOnZeroDXC_save_gui_checkpoint(data_container, output_writer, output_archive, checkpoint_info, block_count,
+												last_pair, 0, 0, checkpoint_filename, target, W);
+				if (checkpoint_error) {
+					wxThreadEvent eventErrorCheckpoint(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+					eventErrorCheckpoint.SetInt(-3);
+					eventErrorCheckpoint.SetString((checkpoint_error == 2)? checkpoint_filename : output_writer.failedOutput());
+					wxQueueEvent(parent_frame, eventErrorCheckpoint.Clone());
+					return NULL;
+				}
+			}
+
+			if (!((target >= 1) && use_surrogate_generation)) {
+				wxThreadEvent eventUpdate0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventUpdate0.SetInt(100 * first_pair / nr_pairs);
+				wxQueueEvent(parent_frame, eventUpdate0.Clone());
+			}
 		}
 
-		if (target == 1) {							// If this is all the user needs, exit
-			wxThreadEvent eventEnd1(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventEnd1.SetInt(-1); // that's it
-			wxQueueEvent(parent_frame, eventEnd1.Clone());
+		if (use_checkpoint)
+			remove(checkpoint_filename.c_str());			// All p values are done: a later resume must not pick up stale counts
+
+		if (target < 3) {							// If this is all the user needs, exit
+			if (output_writer.finish() || netOnZeroDXC_archive_close(output_archive)) {
+				wxThreadEvent eventErrorArchive(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventErrorArchive.SetInt(-3);
+				eventErrorArchive.SetString(output_writer.failedOutput());
+				wxQueueEvent(parent_frame, eventErrorArchive.Clone());
+				return NULL;
+			}
+			wxThreadEvent eventEnd0(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+			eventEnd0.SetInt(-1); // that's it
+			wxQueueEvent(parent_frame, eventEnd0.Clone());
 			return NULL;
 		}
 	} // End-If (pathway < 2), i.e. end of the section to be run if we had only sequences in input.
 
-	if (pathway < 3) {	// When pathway < 3 (AND we haven't returned yet) efficiencies must be computed.
+	if (pathway == 2) {	// When pathway == 2 efficiencies must be computed from the input diagrams.
 		wxThreadEvent eventStartPath1(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 		eventStartPath1.SetInt(-253);
 		wxQueueEvent(parent_frame, eventStartPath1.Clone());
 
 		int	i;
-		std::vector <double>	temp_efficiency;
-		data_container->efficiencies.clear();
+		int	nr_diagrams = data_container->input_diagrams.size();
+		int	nr_widths = data_container->input_diagrams.rows();
+		data_container->efficiencies.assign(nr_diagrams, std::vector <double> ());
 		data_container->window_widths.clear();
+		if (target == 3)		// Efficiencies at different significance thresholds, computed while each diagram is at hand
+			data_container->efficiencies_multialpha.assign(101, std::vector < std::vector <double> > (nr_diagrams));
 
-		for (i = 0; i < data_container->diagrams_pvalue[0].size(); i++)
+		for (i = 0; i < nr_widths; i++)
 			data_container->window_widths.push_back((i + 1) * L * T);
 
-		for (i = 0; i < data_container->diagrams_pvalue.size(); i++) {
+		int	block_size = (parallel)? 4*number_threads : 1;		// Input diagrams are read one at a time by each thread
+		int	first_diagram, last_diagram;
+		bool	read_error = false;
+		for (first_diagram = 0; first_diagram < nr_diagrams; first_diagram = last_diagram) {
 			if (parent_frame->workCancelled() || TestDestroy()) {
 				asked_to_exit = 1;
 				break;
 			}
-			temp_efficiency.clear();
-			if (data_container->node_pairs_valid[i])
-				netOnZeroDXC_compute_efficiency(temp_efficiency, data_container->diagrams_pvalue[i], alpha, avoid_overlapping_windows);
-			else
-				netOnZeroDXC_initialize_nan_efficiency(temp_efficiency, data_container->window_widths.size());
-
-			data_container->efficiencies.push_back(temp_efficiency);
+			last_diagram = (first_diagram + block_size < nr_diagrams)? first_diagram + block_size : nr_diagrams;
+
+			#pragma omp parallel if(parallel)
+			{
+				std::vector < std::vector <double> >	temp_diagram;
+				#pragma omp for schedule(dynamic)
+				for (int d = first_diagram; d < last_diagram; d++) {
+					if (data_container->node_pairs_valid[d] && (!data_container->input_diagrams.getDiagram(temp_diagram, d))) {
+						netOnZeroDXC_compute_efficiency(data_container->efficiencies[d], temp_diagram, alpha, avoid_overlapping_windows);
+						if (target == 3) {
+							for (int k = 0; k <= 100; k++)
+								netOnZeroDXC_compute_efficiency(data_container->efficiencies_multialpha[k][d], temp_diagram, ((double) k) / 1000.0, avoid_overlapping_windows);
+						}
+					} else {
+						if (data_container->node_pairs_valid[d]) {
+							#pragma omp critical
+							read_error = true;
+						}
+						netOnZeroDXC_initialize_nan_efficiency(data_container->efficiencies[d], nr_widths);
+						if (target == 3) {
+							for (int k = 0; k <= 100; k++)
+								netOnZeroDXC_initialize_nan_efficiency(data_container->efficiencies_multialpha[k][d], nr_widths);
+						}
+					}
+				}
+			}
+			if (read_error) {
+				wxThreadEvent eventErrorRead(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventErrorRead.SetInt(-5);
+				wxQueueEvent(parent_frame, eventErrorRead.Clone());
+				return NULL;
+			}
 
 			wxThreadEvent eventUpdate2(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventUpdate2.SetInt(100 * i / data_container->diagrams_pvalue.size());
+			eventUpdate2.SetInt(100 * first_diagram / nr_diagrams);
 			wxQueueEvent(parent_frame, eventUpdate2.Clone());
 		}
 		asked_to_exit = parent_frame->workCancelled();
@@ -693,12 +946,22 @@ wxThread::ExitCode WorkerThread::Entry ()
 			wxThreadEvent eventPrint2(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 			eventPrint2.SetInt(-126);
 			wxQueueEvent(parent_frame, eventPrint2.Clone());
-			int	error;
+			int	error, j;
+			std::vector < std::vector <double> >	temp_w_eta(data_container->window_widths.size(), std::vector <double> (2, 0.0));
 			for (i = 0; i < data_container->node_pairs.size(); i++) {
-				error = netOnZeroDXC_save_linear_data(data_container->window_widths, data_container->efficiencies[i], output_path, output_prefix, "eff", filename_delimiter, data_container->node_pairs[i].label_a, data_container->node_pairs[i].label_b, '\t');
+				if (print_archive) {
+					for (j = 0; j < data_container->window_widths.size(); j++) {
+						temp_w_eta[j][0] = data_container->window_widths[j];
+						temp_w_eta[j][1] = data_container->efficiencies[i][j];
+					}
+					error = output_writer.appendArchive(output_archive, temp_w_eta, "eff", data_container->node_pairs[i].label_a, data_container->node_pairs[i].label_b, BINARY_TABLE_FLOAT64, 0);
+				} else {
+					error = output_writer.saveLinearData(data_container->window_widths, data_container->efficiencies[i], output_path, output_prefix, "eff", filename_delimiter, data_container->node_pairs[i].label_a, data_container->node_pairs[i].label_b, '\t');
+				}
 				if (error) {
 					wxThreadEvent eventError2(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 					eventError2.SetInt(-3);
+					eventError2.SetString(output_writer.failedOutput());
 					wxQueueEvent(parent_frame, eventError2.Clone());
 					return NULL;
 				}
@@ -706,141 +969,57 @@ wxThread::ExitCode WorkerThread::Entry ()
 		}
 
 		if (target == 2) {
+			if (output_writer.finish() || netOnZeroDXC_archive_close(output_archive)) {
+				wxThreadEvent eventErrorArchive(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+				eventErrorArchive.SetInt(-3);
+				eventErrorArchive.SetString(output_writer.failedOutput());
+				wxQueueEvent(parent_frame, eventErrorArchive.Clone());
+				return NULL;
+			}
 			wxThreadEvent eventEnd2(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 			eventEnd2.SetInt(-1); // that's it
 			wxQueueEvent(parent_frame, eventEnd2.Clone());
 			return NULL;
 		}
+	} // End-if (pathway == 2)
 
-		if (target == 3) {	// In case of target matrix, we prepare efficiencies at different significance thresholds
-			int	k;
-			std::vector < std::vector <double> >	temp_efficiency_list;
-			for (k = 0; k <= 100; k++) {
-				temp_efficiency_list.clear();
-				for (i = 0; i < data_container->diagrams_pvalue.size(); i++) {
-					if (parent_frame->workCancelled() || TestDestroy()) {
-						return NULL;
-					}
-					temp_efficiency.clear();
-					if (data_container->node_pairs_valid[i])
-						netOnZeroDXC_compute_efficiency(temp_efficiency, data_container->diagrams_pvalue[i], ((double) k) / 1000.0, avoid_overlapping_windows);
-					else
-						netOnZeroDXC_initialize_nan_efficiency(temp_efficiency, data_container->window_widths.size());
-
-					temp_efficiency_list.push_back(temp_efficiency);
-				}
-				data_container->efficiencies_multialpha.push_back(temp_efficiency_list);
-				wxThreadEvent eventUpdate3(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-				eventUpdate3.SetInt((k < 100)? k : 99);
-				wxQueueEvent(parent_frame, eventUpdate3.Clone());
-			}
-		}
-	} // End-if (pathway < 3)
+	if (output_writer.finish() || netOnZeroDXC_archive_close(output_archive)) {			// Nothing else goes into the archive
+		wxThreadEvent eventErrorArchive(wxEVT_THREAD, EVENT_WORKER_UPDATE);
+		eventErrorArchive.SetInt(-3);
+		eventErrorArchive.SetString(output_writer.failedOutput());
+		wxQueueEvent(parent_frame, eventErrorArchive.Clone());
+		return NULL;
+	}
 
 	// If we haven't returned yet, the matrix of time scales must be computed.
-	std::vector <double>			matrix_row(data_container->node_labels.size(), -1.0);
-	std::vector < std::vector <double> >	timescale_matrix(data_container->node_labels.size(), matrix_row);
-
-	int	i, j, k = 0;
-	for (i = 0; i < data_container->node_labels.size() - 1; i++) {
-		if (parent_frame->workCancelled() || TestDestroy()) {
-			return NULL;
-		}
-		if (data_container->node_valid[i])
-			timescale_matrix[i][i] = 0.0;
-		else
-			timescale_matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
-		for (j = i + 1; j < data_container->node_labels.size(); j++) {
-			k = netOnZeroDXC_associate_index_of_pair(data_container->node_pairs, data_container->node_labels, i, j);
-			if (data_container->node_valid[i] && data_container->node_valid[j]) {
-				timescale_matrix[i][j] = netOnZeroDXC_compute_wmatrix_element(data_container->efficiencies[k], data_container->window_widths, eta_0);
-				timescale_matrix[j][i] = timescale_matrix[i][j];
-			} else {
-				timescale_matrix[i][j] = std::numeric_limits<double>::quiet_NaN();
-				timescale_matrix[j][i] = std::numeric_limits<double>::quiet_NaN();
-			}
-		}
-	}
-	if (data_container->node_valid[i])
-		timescale_matrix[i][i] = 0.0;
-	else
-		timescale_matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
+	std::vector < std::vector <double> >	timescale_matrix;
+	std::vector < std::vector <int> >	pair_indices;
+	netOnZeroDXC_fill_pair_index_table(pair_indices, data_container->node_pairs, data_container->node_labels);
+	if (parent_frame->workCancelled() || TestDestroy())
+		return NULL;
+	netOnZeroDXC_compute_timescale_matrix(timescale_matrix, data_container->efficiencies, data_container->window_widths, data_container->node_valid, pair_indices, eta_0);
 
 	wxThreadEvent eventUpdate4(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 	eventUpdate4.SetInt(-252);
 	wxQueueEvent(parent_frame, eventUpdate4.Clone());
 
 	if (pathway == 3) {
-		std::vector < std::vector <double> >	temp_matrix(data_container->node_labels.size(), matrix_row);
-		data_container->matrices_multieta.clear();
-		int	eta_index;
-		for (eta_index = 0; eta_index <= 100; eta_index++) {
-			if (parent_frame->workCancelled() || TestDestroy()) {
-				return NULL;
-			}
-			temp_matrix.clear();
-			temp_matrix.resize(data_container->node_labels.size(), matrix_row);
-			for (i = 0; i < data_container->node_labels.size() - 1; i++) {
-				if (data_container->node_valid[i])
-					temp_matrix[i][i] = 0.0;
-				else
-					temp_matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
-				for (j = i + 1; j < data_container->node_labels.size(); j++) {
-					k = netOnZeroDXC_associate_index_of_pair(data_container->node_pairs, data_container->node_labels, i, j);
-					if (data_container->node_valid[i] && data_container->node_valid[j]) {
-						temp_matrix[i][j] = netOnZeroDXC_compute_wmatrix_element(data_container->efficiencies[k], data_container->window_widths, ((double) eta_index) / 100.0);
-						temp_matrix[j][i] = temp_matrix[i][j];
-					} else {
-						temp_matrix[i][j] = std::numeric_limits<double>::quiet_NaN();
-						temp_matrix[j][i] = std::numeric_limits<double>::quiet_NaN();
-					}
-				}
-			}
-			if (data_container->node_valid[i])
-				temp_matrix[i][i] = 0.0;
-			else
-				temp_matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
-			data_container->matrices_multieta.push_back(temp_matrix);
-			wxThreadEvent eventUpdate5(wxEVT_THREAD, EVENT_WORKER_UPDATE);
-			eventUpdate5.SetInt((eta_index < 100)? eta_index : 99);
-			wxQueueEvent(parent_frame, eventUpdate5.Clone());
-		}
+		data_container->matrices_multieta.assign(101, std::vector < std::vector <double> > ());
+		#pragma omp parallel for schedule(dynamic) if(parallel)
+		for (int eta_index = 0; eta_index <= 100; eta_index++)
+			netOnZeroDXC_compute_timescale_matrix(data_container->matrices_multieta[eta_index], data_container->efficiencies, data_container->window_widths, data_container->node_valid, pair_indices, ((double) eta_index) / 100.0);
+		if (parent_frame->workCancelled() || TestDestroy())
+			return NULL;
 	} else {
-		std::vector < std::vector <double> >			temp_matrix(data_container->node_labels.size(), matrix_row);
-		std::vector < std::vector < std::vector <double> > >	temp_matrix_list;
-		data_container->matrices_multieta_multialpha.clear();
-		int	alpha_index, eta_index;
+		data_container->matrices_multieta_multialpha.assign(101, std::vector < std::vector < std::vector <double> > > (101));
+		int	alpha_index;
 		for (alpha_index = 0; alpha_index <= 100; alpha_index++) {
-			temp_matrix_list.clear();
-			for (eta_index = 0; eta_index <= 100; eta_index++) {
-				temp_matrix.clear();
-				temp_matrix.resize(data_container->node_labels.size(), matrix_row);
-				if (parent_frame->workCancelled() || TestDestroy()) {
-					return NULL;
-				}
-				for (i = 0; i < data_container->node_labels.size() - 1; i++) {
-					if (data_container->node_valid[i])
-						temp_matrix[i][i] = 0.0;
-					else
-						temp_matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
-					for (j = i + 1; j < data_container->node_labels.size(); j++) {
-						k = netOnZeroDXC_associate_index_of_pair(data_container->node_pairs, data_container->node_labels, i, j);
-						if (data_container->node_valid[i] && data_container->node_valid[j]) {
-							temp_matrix[i][j] = netOnZeroDXC_compute_wmatrix_element(data_container->efficiencies_multialpha[alpha_index][k], data_container->window_widths, ((double) eta_index) / 100.0);
-							temp_matrix[j][i] = temp_matrix[i][j];
-						} else {
-							temp_matrix[i][j] = std::numeric_limits<double>::quiet_NaN();
-							temp_matrix[j][i] = std::numeric_limits<double>::quiet_NaN();
-						}
-					}
-				}
-				if (data_container->node_valid[i])
-					temp_matrix[i][i] = 0.0;
-				else
-					temp_matrix[i][i] = std::numeric_limits<double>::quiet_NaN();
-				temp_matrix_list.push_back(temp_matrix);
+			if (parent_frame->workCancelled() || TestDestroy())
+				return NULL;
+			#pragma omp parallel for schedule(dynamic) if(parallel)
+			for (int eta_index = 0; eta_index <= 100; eta_index++) {
+				netOnZeroDXC_compute_timescale_matrix(data_container->matrices_multieta_multialpha[alpha_index][eta_index], data_container->efficiencies_multialpha[alpha_index], data_container->window_widths, data_container->node_valid, pair_indices, ((double) eta_index) / 100.0);
 			}
-			data_container->matrices_multieta_multialpha.push_back(temp_matrix_list);
 			wxThreadEvent eventUpdate5(wxEVT_THREAD, EVENT_WORKER_UPDATE);
 			eventUpdate5.SetInt((alpha_index < 100)? alpha_index : 99);
 			wxQueueEvent(parent_frame, eventUpdate5.Clone());
@@ -887,6 +1066,10 @@ void ContainerWorkspace::clearWorkspace ()
 	parameter_print_cdiagrams = 0;
 	parameter_print_pdiagrams = 0;
 	parameter_print_efficiencies = 0;
+	parameter_print_binary = 0;
+	parameter_print_archive = 0;
+	parameter_resume = false;
+	parameter_checkpoint_rounds = 100;
 	parameter_use_parallel = false;
 	parameter_numthreads = 1;
 
@@ -894,6 +1077,7 @@ void ContainerWorkspace::clearWorkspace ()
 	diagrams_correlation.clear();
 	diagrams_pvalue.clear();
 	diagrams_pvalue_fisher.clear();
+	input_diagrams.clear();
 	efficiencies.clear();
 	window_widths.clear();
 	node_labels.clear();
@@ -924,7 +1108,7 @@ int ContainerWorkspace::validateParameterTable ()
 			wxMessageBox("Warning! Base width must be an even number of points.\nBasewidth was reduced by 1 with respect to the loaded settings.", "Warning", wxOK | wxICON_EXCLAMATION, NULL, wxDefaultCoord, wxDefaultCoord);
 		}
 		if (parameter_computation_pathway < 2) {
-			if (parameter_basewidth * parameter_nr_windowwidths >= sequences[0].size()) {
+			if (parameter_basewidth * parameter_nr_windowwidths >= sequences.length()) {
 				wxMessageBox("Error: too large / too many windows.\nWindow settings and sequences length are incompatible.", "Error", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
 				return 2;
 			}
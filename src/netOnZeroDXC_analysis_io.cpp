@@ -117,14 +117,17 @@ void GuiFrame::loadInputFiles(wxCommandEvent& WXUNUSED(event))
 	std::stringstream	displayed_file_info_stream;
 	std::stringstream	displayed_folder_info_stream;
 	int			loading_error;
+	std::vector < std::vector <double> >	loaded_sequences;
 	if (loading_mode == 0)
-		loading_error = netOnZeroDXC_load_single_file(m_workspace->sequences, m_workspace->node_labels, file_name, separator_char);
+		loading_error = netOnZeroDXC_load_single_file(loaded_sequences, m_workspace->node_labels, file_name, separator_char);
 	else if (loading_mode == 1)
-		loading_error = netOnZeroDXC_load_multi_sequences(m_workspace->sequences, m_workspace->node_labels, list_of_files, separator_char, filename_delimiter_char, column_number);
+		loading_error = netOnZeroDXC_load_multi_sequences(loaded_sequences, m_workspace->node_labels, list_of_files, separator_char, filename_delimiter_char, column_number);
 	else if (loading_mode == 2)
-		loading_error = netOnZeroDXC_load_multi_diagrams(m_workspace->diagrams_pvalue, m_workspace->node_pairs, list_of_files, separator_char, filename_delimiter_char);
+		loading_error = netOnZeroDXC_open_multi_diagrams(m_workspace->input_diagrams, m_workspace->node_pairs, list_of_files, separator_char, filename_delimiter_char);
 	else if (loading_mode == 3)
 		loading_error = netOnZeroDXC_load_multi_efficiencies(m_workspace->efficiencies, m_workspace->node_pairs, m_workspace->window_widths, list_of_files, separator_char, filename_delimiter_char);
+	if ((!loading_error) && (loading_mode < 2) && m_workspace->sequences.assign(loaded_sequences))
+		loading_error = 6;
 
 	switch (loading_error) {
 		case 1:
@@ -166,26 +169,32 @@ void GuiFrame::loadInputFiles(wxCommandEvent& WXUNUSED(event))
 			displayed_file_info_stream << "Nothing loaded!";
 			displayed_folder_info_stream << "No output folder selected.";
 			break;
+		case 6:
+			sstm << "Error in loading sequences!\nNot enough memory to hold the sequences.\nNothing was loaded";
+			m_workspace->clearWorkspace();
+			displayed_file_info_stream << "Nothing loaded!";
+			displayed_folder_info_stream << "No output folder selected.";
+			break;
 		case 0:
 			if (loading_mode == 0) {
 				sstm << "Successfully read '" << file_name << "'.\n";
 				sstm << "Loaded " << m_workspace->sequences.size() << " sequences with separator " << separator_label << ", content read:\n";
-				sstm << "- Detected sequences length: " << m_workspace->sequences[0].size() << "\n";
+				sstm << "- Detected sequences length: " << m_workspace->sequences.length() << "\n";
 				sstm << "Consistency between sequences was checked. Everything is fine.";
-				displayed_file_info_stream << "Sequences loaded: " << m_workspace->sequences.size() << ". Length: " << m_workspace->sequences[0].size();
+				displayed_file_info_stream << "Sequences loaded: " << m_workspace->sequences.size() << ". Length: " << m_workspace->sequences.length();
 			} else if (loading_mode == 1) {
 				sstm << "Successfully read " << list_of_files.GetCount() << " files with index delimiter " << delimiter_label << ".\n";
 				sstm << "Loaded " << m_workspace->sequences.size() << " sequences with separator " << separator_label << " at column " << column_number << ", content read:\n";
-				sstm << "- Detected sequences length: " << m_workspace->sequences[0].size() << "\n";
+				sstm << "- Detected sequences length: " << m_workspace->sequences.length() << "\n";
 				sstm << "Consistency between sequences was checked. Everything is fine.";
-				displayed_file_info_stream << "Sequences loaded: " << m_workspace->sequences.size() << ". Length: " << m_workspace->sequences[0].size();
+				displayed_file_info_stream << "Sequences loaded: " << m_workspace->sequences.size() << ". Length: " << m_workspace->sequences.length();
 			} else if (loading_mode == 2) {
 				sstm << "Successfully read " << list_of_files.GetCount() << " files with index delimiter " << delimiter_label << ".\n";
-				sstm << "Loaded " << m_workspace->diagrams_pvalue.size() << " diagrams with separator " << separator_label << ", content read:\n";
-				sstm << "- Detected data rows (i.e. window widths): " << m_workspace->diagrams_pvalue[0].size() << "\n";
-				sstm << "- Detected data columns (i.e. window positions): " << m_workspace->diagrams_pvalue[0][0].size() << "\n";
+				sstm << "Loaded " << m_workspace->input_diagrams.size() << " diagrams with separator " << separator_label << ", content read:\n";
+				sstm << "- Detected data rows (i.e. window widths): " << m_workspace->input_diagrams.rows() << "\n";
+				sstm << "- Detected data columns (i.e. window positions): " << m_workspace->input_diagrams.cols() << "\n";
 				sstm << "Consistency between diagrams was checked. Everything is fine.";
-				displayed_file_info_stream << "Diagrams loaded: " << m_workspace->diagrams_pvalue.size() << ". Size: " << m_workspace->diagrams_pvalue[0].size() << " x " << m_workspace->diagrams_pvalue[0][0].size();
+				displayed_file_info_stream << "Diagrams loaded: " << m_workspace->input_diagrams.size() << ". Size: " << m_workspace->input_diagrams.rows() << " x " << m_workspace->input_diagrams.cols();
 			} else if (loading_mode == 3) {
 				sstm << "Successfully read " << list_of_files.GetCount() << " files with index delimiter " << delimiter_label << ".\n";
 				sstm << "Loaded " << m_workspace->efficiencies.size() << " efficiencies with separator " << separator_label << ", content read:\n";
@@ -57,6 +57,18 @@
 	#include "netOnZeroDXC_pair.hpp"
 	#define INCLUDED_PAIR
 #endif
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+#ifndef INCLUDED_SEQUENCESTORE
+	#include "netOnZeroDXC_sequence_store.hpp"
+	#define INCLUDED_SEQUENCESTORE
+#endif
+#ifndef INCLUDED_DIAGRAMVIEW
+	#include "netOnZeroDXC_diagram_view.hpp"
+	#define INCLUDED_DIAGRAMVIEW
+#endif
 #ifndef INCLUDED_ICON
 	#include "netOnZeroDXC_gui_icon.hpp"
 	#define INCLUDED_ICON
@@ -190,6 +202,8 @@ private:
 	wxCheckBox		*checkbox_save_pdiagrams;
 	wxCheckBox		*checkbox_save_efficiencies;
 	wxCheckBox		*checkbox_save_wholeseq_xcorr;
+	wxCheckBox		*checkbox_save_binary;
+	wxCheckBox		*checkbox_save_archive;
 	wxCheckBox		*checkbox_parallel_omp;
 
 	wxTextCtrl		*textctrl_save_prefix;
@@ -244,14 +258,19 @@ public:
 	bool	parameter_print_pdiagrams;
 	bool	parameter_print_efficiencies;
 	bool	parameter_print_wholeseq_xcorr;
+	bool	parameter_print_binary;
+	bool	parameter_print_archive;
+	bool	parameter_resume;			// Continue the surrogates from the checkpoint in the output folder
+	int	parameter_checkpoint_rounds;		// Surrogates between checkpoints of the running block, 0 saves after each block only
 
 	bool	parameter_use_parallel;
 	int	parameter_numthreads;
 
-	std::vector < std::vector <double> >			sequences;
-	std::vector < std::vector < std::vector <double> > >	diagrams_correlation;
-	std::vector < std::vector < std::vector <double> > >	diagrams_pvalue;
-	std::vector < std::vector < std::vector <double> > >	diagrams_pvalue_fisher;
+	SequenceStore						sequences;
+	DiagramSet						diagrams_correlation;
+	DiagramSet						diagrams_pvalue;
+	DiagramSet						diagrams_pvalue_fisher;
+	DiagramCollection					input_diagrams;		// P-value diagrams loaded as input (pathway 2), read on demand
 	std::vector < std::vector <double> >			efficiencies;
 	std::vector <double>					window_widths;
 	std::vector <std::string>				node_labels;
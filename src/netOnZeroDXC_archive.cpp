@@ -0,0 +1,445 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef INCLUDED_IOFUNCTIONS
+	#include "netOnZeroDXC_io.hpp"
+	#define INCLUDED_IOFUNCTIONS
+#endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+
+struct ArchiveFileHeader {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	reserved;
+};
+
+struct ArchiveTrailer {
+	uint64_t	toc_offset;
+	uint64_t	nr_entries;
+	char		magic[8];
+};
+
+int netOnZeroDXC_archive_write_label (const std::string & label, FILE * file_pointer)
+{
+	uint16_t	length = label.size();
+	if (fwrite(&length, sizeof(uint16_t), 1, file_pointer) != 1)
+		return 1;
+	if (length && (fwrite(label.data(), 1, length, file_pointer) != length))
+		return 1;
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_read_label (std::string & label, FILE * file_pointer)
+{
+	uint16_t	length;
+	if (fread(&length, sizeof(uint16_t), 1, file_pointer) != 1)
+		return 1;
+	label.resize(length);
+	if (length && (fread(&label[0], 1, length, file_pointer) != length))
+		return 1;
+
+	return 0;
+}
+
+ArchiveFile::ArchiveFile ()
+{
+	file_pointer = NULL;
+	end_offset = 0;
+	flushed_entries = 0;
+	flushed_toc_offset = 0;
+	flushed_toc_end = 0;
+}
+
+ArchiveFile::~ArchiveFile ()
+{
+	netOnZeroDXC_archive_close(*this);
+}
+
+bool netOnZeroDXC_check_archive (std::string file_name)
+{
+	char	magic[sizeof(ArchiveFileHeader::magic)];
+	FILE *	file_pointer = fopen(file_name.c_str(), "rb");
+	if (!file_pointer)
+		return false;
+	size_t	n = fread(magic, 1, sizeof(magic), file_pointer);
+	fclose(file_pointer);
+
+	return ((n == sizeof(magic)) && (memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) == 0));
+}
+
+// Opens a new archive, replacing any file of the same name; with append, an existing archive is kept and new records follow
+// its own. An archive left without table of contents by an interrupted run keeps the entries of the last one it was closed
+// with, if any; records written after that are no longer indexed.
+int netOnZeroDXC_archive_open (ArchiveFile & archive, std::string file_name, bool append)
+{
+	netOnZeroDXC_archive_close(archive);
+	archive.entries.clear();
+	archive.flushed_entries = 0;
+	archive.flushed_toc_offset = 0;
+	archive.flushed_toc_end = 0;
+
+	if (append && netOnZeroDXC_check_archive(file_name)) {
+		archive.file_pointer = fopen(file_name.c_str(), "r+b");
+		if (!archive.file_pointer)
+			return 1;
+		if ((netOnZeroDXC_archive_read_toc(archive.entries, archive.file_pointer) && netOnZeroDXC_archive_recover_toc(archive.entries, archive.file_pointer))
+			|| ARCHIVE_FSEEK(archive.file_pointer, 0, SEEK_END)) {
+			fclose(archive.file_pointer);
+			archive.file_pointer = NULL;
+			return 1;
+		}
+		archive.end_offset = ARCHIVE_FTELL(archive.file_pointer);
+	} else {
+		archive.file_pointer = fopen(file_name.c_str(), "wb");
+		if (!archive.file_pointer)
+			return 1;
+		ArchiveFileHeader	header;
+		memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+		header.version = ARCHIVE_VERSION;
+		header.reserved = 0;
+		if (fwrite(&header, sizeof(ArchiveFileHeader), 1, archive.file_pointer) != 1) {
+			fclose(archive.file_pointer);
+			archive.file_pointer = NULL;
+			return 1;
+		}
+		archive.end_offset = sizeof(ArchiveFileHeader);
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_append_table (ArchiveFile & archive, const std::vector < std::vector <double> > & data_table, std::string quantity,
+					std::string label_a, std::string label_b, int cell_type, int nr_surrogates)
+{
+	if (!archive.file_pointer)
+		return 1;
+	if ((quantity.size() > 0xFFFF) || (label_a.size() > 0xFFFF) || (label_b.size() > 0xFFFF))
+		return 1;
+
+	ArchiveEntry	entry;
+	entry.quantity = quantity;
+	entry.label_a = label_a;
+	entry.label_b = label_b;
+	entry.offset = archive.end_offset;
+	if (netOnZeroDXC_write_binary_table(data_table, archive.file_pointer, cell_type, nr_surrogates))
+		return 1;
+
+	int64_t	position = ARCHIVE_FTELL(archive.file_pointer);
+	if (position < 0)
+		return 1;
+	entry.size = position - entry.offset;
+	archive.end_offset = position;
+	archive.entries.push_back(entry);
+
+	return 0;
+}
+
+// Writes a table of contents starting at toc_offset, the current position, with the entries from first on
+static int netOnZeroDXC_archive_write_toc (FILE * file_pointer, const std::vector <ArchiveEntry> & entries, size_t first, uint64_t toc_offset)
+{
+	int	error = 0;
+	size_t	i;
+	for (i = first; i < entries.size(); i++) {
+		error += netOnZeroDXC_archive_write_label(entries[i].quantity, file_pointer);
+		error += netOnZeroDXC_archive_write_label(entries[i].label_a, file_pointer);
+		error += netOnZeroDXC_archive_write_label(entries[i].label_b, file_pointer);
+		error += (fwrite(&entries[i].offset, sizeof(uint64_t), 1, file_pointer) != 1);
+		error += (fwrite(&entries[i].size, sizeof(uint64_t), 1, file_pointer) != 1);
+		if (error)
+			return 1;
+	}
+
+	ArchiveTrailer	trailer;
+	trailer.toc_offset = toc_offset;
+	trailer.nr_entries = entries.size() - first;
+	memcpy(trailer.magic, ARCHIVE_TOC_MAGIC, sizeof(trailer.magic));
+
+	return (fwrite(&trailer, sizeof(ArchiveTrailer), 1, file_pointer) != 1)? 1 : 0;
+}
+
+// Indexes the records appended since the last flush, so that they are found even if the archive is never closed
+int netOnZeroDXC_archive_flush (ArchiveFile & archive)
+{
+	if ((!archive.file_pointer) || (archive.flushed_entries == archive.entries.size()))
+		return 0;
+
+	std::vector <ArchiveEntry>	segment;
+	if (archive.flushed_toc_end > 0) {
+		ArchiveEntry	link;
+		link.quantity = ARCHIVE_TOC_LINK;
+		link.offset = archive.flushed_toc_offset;
+		link.size = archive.flushed_toc_end - archive.flushed_toc_offset;
+		segment.push_back(link);
+	}
+	segment.insert(segment.end(), archive.entries.begin() + archive.flushed_entries, archive.entries.end());
+	if (netOnZeroDXC_archive_write_toc(archive.file_pointer, segment, 0, archive.end_offset) || fflush(archive.file_pointer))
+		return 1;
+
+	int64_t	position = ARCHIVE_FTELL(archive.file_pointer);
+	if (position < 0)
+		return 1;
+	archive.flushed_entries = archive.entries.size();
+	archive.flushed_toc_offset = archive.end_offset;
+	archive.flushed_toc_end = position;
+	archive.end_offset = position;			// Later records follow the flushed table of contents
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_close (ArchiveFile & archive)
+{
+	if (!archive.file_pointer)
+		return 0;
+
+	int	error = netOnZeroDXC_archive_write_toc(archive.file_pointer, archive.entries, 0, archive.end_offset);
+	if (fclose(archive.file_pointer) == EOF)
+		error++;
+	archive.file_pointer = NULL;
+
+	return (error)? 1 : 0;
+}
+
+// Reads the single table of contents whose trailer ends at toc_end
+static int netOnZeroDXC_archive_read_segment (std::vector <ArchiveEntry> & entries, FILE * file_pointer, int64_t toc_end)
+{
+	entries.clear();
+
+	if (toc_end < (int64_t) (sizeof(ArchiveFileHeader) + sizeof(ArchiveTrailer)))
+		return 1;
+
+	ArchiveTrailer	trailer;
+	if (ARCHIVE_FSEEK(file_pointer, toc_end - sizeof(ArchiveTrailer), SEEK_SET))
+		return 1;
+	if (fread(&trailer, sizeof(ArchiveTrailer), 1, file_pointer) != 1)
+		return 1;
+	if (memcmp(trailer.magic, ARCHIVE_TOC_MAGIC, sizeof(trailer.magic)) != 0)
+		return 1;			// Archive was not closed properly
+	if ((trailer.toc_offset < sizeof(ArchiveFileHeader)) || (trailer.toc_offset > (uint64_t) (toc_end - sizeof(ArchiveTrailer))))
+		return 1;
+	if (trailer.nr_entries > (uint64_t) toc_end / (3*sizeof(uint16_t) + 2*sizeof(uint64_t)))
+		return 1;
+
+	if (ARCHIVE_FSEEK(file_pointer, trailer.toc_offset, SEEK_SET))
+		return 1;
+	ArchiveEntry	entry;
+	uint64_t	n;
+	for (n = 0; n < trailer.nr_entries; n++) {
+		if (netOnZeroDXC_archive_read_label(entry.quantity, file_pointer))
+			return 1;
+		if (netOnZeroDXC_archive_read_label(entry.label_a, file_pointer))
+			return 1;
+		if (netOnZeroDXC_archive_read_label(entry.label_b, file_pointer))
+			return 1;
+		if (fread(&entry.offset, sizeof(uint64_t), 1, file_pointer) != 1)
+			return 1;
+		if (fread(&entry.size, sizeof(uint64_t), 1, file_pointer) != 1)
+			return 1;
+		if ((entry.offset < sizeof(ArchiveFileHeader)) || (entry.offset + entry.size > trailer.toc_offset))
+			return 1;
+		entries.push_back(entry);
+	}
+	if (ARCHIVE_FTELL(file_pointer) != toc_end - (int64_t) sizeof(ArchiveTrailer))
+		return 1;
+
+	return 0;
+}
+
+// Reads the table of contents whose trailer ends at toc_end, following the links of a flushed archive back to its first one
+static int netOnZeroDXC_archive_read_toc_at (std::vector <ArchiveEntry> & entries, FILE * file_pointer, int64_t toc_end)
+{
+	std::vector < std::vector <ArchiveEntry> >	segments(1);
+	if (netOnZeroDXC_archive_read_segment(segments[0], file_pointer, toc_end))
+		return 1;
+	while ((!segments.back().empty()) && (segments.back()[0].quantity == ARCHIVE_TOC_LINK)) {
+		ArchiveEntry	link = segments.back()[0];			// Points to an earlier table of contents, hence the links cannot loop
+		segments.push_back(std::vector <ArchiveEntry> ());
+		if (netOnZeroDXC_archive_read_segment(segments.back(), file_pointer, link.offset + link.size)) {
+			entries.clear();
+			return 1;
+		}
+	}
+
+	entries.clear();
+	size_t	i;
+	for (i = segments.size(); i > 0; i--) {
+		const std::vector <ArchiveEntry> &	segment = segments[i-1];
+		size_t	first = ((!segment.empty()) && (segment[0].quantity == ARCHIVE_TOC_LINK))? 1 : 0;
+		entries.insert(entries.end(), segment.begin() + first, segment.end());
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_read_toc (std::vector <ArchiveEntry> & entries, FILE * file_pointer)
+{
+	entries.clear();
+
+	if (ARCHIVE_FSEEK(file_pointer, 0, SEEK_END))
+		return 1;
+
+	return netOnZeroDXC_archive_read_toc_at(entries, file_pointer, ARCHIVE_FTELL(file_pointer));
+}
+
+// Looks backwards for the last complete table of contents of an archive that was not closed; entries is left empty if
+// there is none. Returns 1 on read errors only.
+int netOnZeroDXC_archive_recover_toc (std::vector <ArchiveEntry> & entries, FILE * file_pointer)
+{
+	entries.clear();
+
+	if (ARCHIVE_FSEEK(file_pointer, 0, SEEK_END))
+		return 1;
+	int64_t	file_size = ARCHIVE_FTELL(file_pointer);
+	const size_t	magic_size = sizeof(ArchiveTrailer::magic);
+	std::vector <char>	buffer(65536 + magic_size);
+	int64_t	chunk_end = file_size;
+	while (chunk_end > (int64_t) sizeof(ArchiveFileHeader)) {
+		int64_t	chunk_start = std::max((int64_t) sizeof(ArchiveFileHeader), chunk_end - 65536);
+		size_t	length = (size_t) (std::min(file_size, chunk_end + (int64_t) magic_size - 1) - chunk_start);	// Overlaps the next chunk
+		if (ARCHIVE_FSEEK(file_pointer, chunk_start, SEEK_SET) || (fread(buffer.data(), 1, length, file_pointer) != length))
+			return 1;
+		int64_t	i;
+		for (i = (int64_t) (chunk_end - chunk_start) - 1; i >= 0; i--) {
+			if ((i + magic_size <= length) && (memcmp(buffer.data() + i, ARCHIVE_TOC_MAGIC, magic_size) == 0)
+				&& (netOnZeroDXC_archive_read_toc_at(entries, file_pointer, chunk_start + i + magic_size) == 0))
+				return 0;
+		}
+		chunk_end = chunk_start;
+	}
+	entries.clear();
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_read_table (std::vector < std::vector <double> > & data_table, FILE * file_pointer, const ArchiveEntry & entry)
+{
+	data_table.clear();
+
+	std::vector <char>	buffer(entry.size);
+	if (ARCHIVE_FSEEK(file_pointer, entry.offset, SEEK_SET))
+		return 1;
+	if (entry.size && (fread(buffer.data(), 1, entry.size, file_pointer) != entry.size))
+		return 1;
+
+	return netOnZeroDXC_parse_binary_table(data_table, buffer.data(), buffer.size());
+}
+
+int netOnZeroDXC_archive_select_entries (std::vector <ArchiveEntry> & selected, const std::vector <ArchiveEntry> & entries, std::string quantity)
+{
+	selected.clear();
+
+	std::map < std::pair <std::string, std::string>, size_t >		positions;
+	std::map < std::pair <std::string, std::string>, size_t >::iterator	found;
+	size_t	i;
+	for (i = 0; i < entries.size(); i++) {
+		if (entries[i].quantity != quantity)
+			continue;
+		found = positions.find(std::make_pair(entries[i].label_a, entries[i].label_b));
+		if (found != positions.end()) {			// Appended later, thus overrides the previous record
+			selected[found->second] = entries[i];
+		} else {
+			positions[std::make_pair(entries[i].label_a, entries[i].label_b)] = selected.size();
+			selected.push_back(entries[i]);
+		}
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_load_quantity (std::vector < std::vector < std::vector <double> > > & data_tables, std::vector <PairOfLabels> & list_pairs,
+					std::string file_name, std::string quantity)
+{
+	FILE *	file_pointer = fopen(file_name.c_str(), "rb");
+	if (!file_pointer)
+		return 1;
+
+	std::vector <ArchiveEntry>	entries;
+	std::vector <ArchiveEntry>	selected;
+	if (netOnZeroDXC_archive_read_toc(entries, file_pointer)) {
+		fclose(file_pointer);
+		return 1;
+	}
+	netOnZeroDXC_archive_select_entries(selected, entries, quantity);
+
+	size_t	i;
+	PairOfLabels	temp_pair;
+	std::vector < std::vector <double> >	temp_table;
+	for (i = 0; i < selected.size(); i++) {
+		if (netOnZeroDXC_archive_read_table(temp_table, file_pointer, selected[i])) {
+			fclose(file_pointer);
+			return 1;
+		}
+		temp_pair.label_a = selected[i].label_a;
+		temp_pair.label_b = selected[i].label_b;
+		list_pairs.push_back(temp_pair);
+		data_tables.push_back(temp_table);
+	}
+	fclose(file_pointer);
+
+	return 0;
+}
+
+int netOnZeroDXC_archive_load_entry (std::vector < std::vector <double> > & data_table, std::string file_name, std::string quantity,
+					std::string label_a, std::string label_b)
+{
+	FILE *	file_pointer = fopen(file_name.c_str(), "rb");
+	if (!file_pointer)
+		return 1;
+
+	std::vector <ArchiveEntry>	entries;
+	if (netOnZeroDXC_archive_read_toc(entries, file_pointer)) {
+		fclose(file_pointer);
+		return 1;
+	}
+
+	int	error = 2;
+	size_t	i;
+	for (i = entries.size(); i > 0; i--) {
+		if ((entries[i-1].quantity == quantity) && (entries[i-1].label_a == label_a) && (entries[i-1].label_b == label_b)) {
+			error = netOnZeroDXC_archive_read_table(data_table, file_pointer, entries[i-1]);
+			break;
+		}
+	}
+	fclose(file_pointer);
+
+	return error;
+}
@@ -0,0 +1,93 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdio>
+#include <stdint.h>
+
+#ifndef INCLUDED_PAIR
+	#include "netOnZeroDXC_pair.hpp"
+	#define INCLUDED_PAIR
+#endif
+
+// An archive is a single append-only file holding many binary tables (see netOnZeroDXC_io.hpp),
+// followed by a table of contents keyed by quantity and pair labels. An archive opened for appending
+// gets new records and a new table of contents; the trailer at the end of the file always points to
+// the latest one, and later entries override earlier ones with the same key. A flushed archive indexes its records so far
+// without being closed: each flush writes the entries added since the previous one, linked to it by a first entry with
+// quantity ARCHIVE_TOC_LINK, and readers follow the links back; closing writes the whole table of contents at once.
+
+#define ARCHIVE_MAGIC		"NZDXCARC"
+#define ARCHIVE_TOC_MAGIC	"NZDXCTOC"
+#define ARCHIVE_VERSION		1
+#define ARCHIVE_LABEL		"archive"
+#define ARCHIVE_TOC_LINK	"archive:toc"
+
+#ifdef _WIN32					// Archives easily exceed 2 GB, hence 64-bit file offsets
+	#define ARCHIVE_FSEEK	_fseeki64
+	#define ARCHIVE_FTELL	_ftelli64
+#else
+	#define ARCHIVE_FSEEK	fseeko
+	#define ARCHIVE_FTELL	ftello
+#endif
+
+struct ArchiveEntry {
+	std::string	quantity;
+	std::string	label_a;
+	std::string	label_b;
+	uint64_t	offset;
+	uint64_t	size;
+};
+
+class ArchiveFile
+{
+public:
+	ArchiveFile();
+	~ArchiveFile();
+
+	FILE *				file_pointer;
+	uint64_t			end_offset;
+	std::vector <ArchiveEntry>	entries;
+	size_t				flushed_entries;		// Entries indexed by the flushed table of contents ending at flushed_toc_end
+	uint64_t			flushed_toc_offset;
+	uint64_t			flushed_toc_end;
+};
+
+bool netOnZeroDXC_check_archive (std::string);
+int netOnZeroDXC_archive_open (ArchiveFile &, std::string, bool);
+int netOnZeroDXC_archive_append_table (ArchiveFile &, const std::vector < std::vector <double> > &, std::string, std::string, std::string, int, int);
+int netOnZeroDXC_archive_flush (ArchiveFile &);
+int netOnZeroDXC_archive_close (ArchiveFile &);
+
+int netOnZeroDXC_archive_read_toc (std::vector <ArchiveEntry> &, FILE *);
+int netOnZeroDXC_archive_recover_toc (std::vector <ArchiveEntry> &, FILE *);
+int netOnZeroDXC_archive_read_table (std::vector < std::vector <double> > &, FILE *, const ArchiveEntry &);
+int netOnZeroDXC_archive_select_entries (std::vector <ArchiveEntry> &, const std::vector <ArchiveEntry> &, std::string);
+int netOnZeroDXC_archive_load_quantity (std::vector < std::vector < std::vector <double> > > &, std::vector <PairOfLabels> &, std::string, std::string);
+int netOnZeroDXC_archive_load_entry (std::vector < std::vector <double> > &, std::string, std::string, std::string, std::string);
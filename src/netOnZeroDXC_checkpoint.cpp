@@ -0,0 +1,263 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef INCLUDED_IOFUNCTIONS
+	#include "netOnZeroDXC_io.hpp"
+	#define INCLUDED_IOFUNCTIONS
+#endif
+#ifndef INCLUDED_CHECKPOINT
+	#include "netOnZeroDXC_checkpoint.hpp"
+	#define INCLUDED_CHECKPOINT
+#endif
+
+// A run without early stopping, screening, parametric or pooled null, in double precision.
+void netOnZeroDXC_checkpoint_initialize (CheckpointInfo & info)
+{
+	info.seed = 0;
+	info.nr_surrogates = 0;
+	info.completed_rounds = 0;
+	info.nr_nodes = 0;
+	info.first_pair = 0;
+	info.nr_pairs = 0;
+	info.basewidth = 0;
+	info.nr_windowwidths = 0;
+	info.shift = 0;
+	info.length = 0;
+	info.early_stopping = false;
+	info.threshold_alpha = 0.0;
+	info.threshold_eta = 0.0;
+	info.avoid_overlapping = false;
+	info.screening_band = 0.0;
+	info.parametric = false;
+	info.pooled = false;
+	info.single_precision = false;
+	info.checksum = 0;
+}
+
+// Starts a checkpoint under a temporary name, with its info table.
+int netOnZeroDXC_checkpoint_open (ArchiveFile & checkpoint_archive, std::string checkpoint_filename, const CheckpointInfo & info)
+{
+	std::string	temp_filename = checkpoint_filename + ".tmp";
+	remove(temp_filename.c_str());
+
+	std::vector < std::vector <double> >	info_table(1, std::vector <double> (CHECKPOINT_INFO_SIZE, 0.0));
+	info_table[0][0] = info.seed;
+	info_table[0][1] = info.nr_surrogates;
+	info_table[0][2] = info.completed_rounds;
+	info_table[0][3] = info.nr_nodes;
+	info_table[0][4] = info.first_pair;
+	info_table[0][5] = info.nr_pairs;
+	info_table[0][6] = info.basewidth;
+	info_table[0][7] = info.nr_windowwidths;
+	info_table[0][8] = info.shift;
+	info_table[0][9] = info.length;
+	info_table[0][10] = (info.early_stopping)? 1 : 0;
+	info_table[0][11] = info.threshold_alpha;
+	info_table[0][12] = info.threshold_eta;
+	info_table[0][13] = (info.avoid_overlapping)? 1 : 0;
+	info_table[0][14] = info.screening_band;
+	info_table[0][15] = (info.parametric)? 1 : 0;
+	info_table[0][16] = (info.pooled)? 1 : 0;
+	info_table[0][17] = (info.single_precision)? 1 : 0;
+	info_table[0][18] = (double) (info.checksum >> 32);		// In halves that doubles hold exactly
+	info_table[0][19] = (double) (info.checksum & 0xFFFFFFFFULL);
+
+	if (netOnZeroDXC_archive_open(checkpoint_archive, temp_filename, false))
+		return 1;
+
+	return netOnZeroDXC_archive_append_table(checkpoint_archive, info_table, CHECKPOINT_LABEL, "info", "", BINARY_TABLE_FLOAT64, 0);
+}
+
+// Tables are stored exactly, so that the remaining rounds add up as in one go.
+template <class Set> static int netOnZeroDXC_checkpoint_append_set (ArchiveFile & checkpoint_archive, const Set & tables, std::string label, const std::vector <PairOfLabels> & pairs,
+									int cell_type)
+{
+	std::vector < std::vector <double> >	temp_table;
+	int	i;
+	for (i = 0; i < tables.size(); i++) {
+		tables.getTable(temp_table, i);
+		if (netOnZeroDXC_archive_append_table(checkpoint_archive, temp_table, label, pairs[i].label_a, pairs[i].label_b, cell_type, 0))
+			return 1;
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_checkpoint_append (ArchiveFile & checkpoint_archive, const CountSet & tables, std::string label, const std::vector <PairOfLabels> & pairs)
+{
+	return netOnZeroDXC_checkpoint_append_set(checkpoint_archive, tables, label, pairs, BINARY_TABLE_FLOAT64);
+}
+
+int netOnZeroDXC_checkpoint_append (ArchiveFile & checkpoint_archive, const DiagramSet & tables, std::string label, const std::vector <PairOfLabels> & pairs)
+{
+	return netOnZeroDXC_checkpoint_append_set(checkpoint_archive, tables, label, pairs, BINARY_TABLE_FLOAT64);
+}
+
+int netOnZeroDXC_checkpoint_append (ArchiveFile & checkpoint_archive, const HistogramSet & tables, std::string label, const std::vector <PairOfLabels> & pairs)
+{
+	return netOnZeroDXC_checkpoint_append_set(checkpoint_archive, tables, label, pairs, BINARY_TABLE_COUNTS32);
+}
+
+// Closes the checkpoint and puts it in place of the previous one. Returns 1 on i/o errors, 2 if it cannot be renamed.
+int netOnZeroDXC_checkpoint_commit (ArchiveFile & checkpoint_archive, std::string checkpoint_filename)
+{
+	std::string	temp_filename = checkpoint_filename + ".tmp";
+	if (netOnZeroDXC_archive_close(checkpoint_archive))
+		return 1;
+
+#ifdef _WIN32
+	remove(checkpoint_filename.c_str());
+#endif
+	if (rename(temp_filename.c_str(), checkpoint_filename.c_str()))
+		return 2;
+
+	return 0;
+}
+
+int netOnZeroDXC_checkpoint_load_info (CheckpointInfo & info, std::string checkpoint_filename)
+{
+	std::vector < std::vector <double> >	info_table;
+	if (netOnZeroDXC_archive_load_entry(info_table, checkpoint_filename, CHECKPOINT_LABEL, "info", "") || (info_table.size() != 1)
+		|| (info_table[0].size() != CHECKPOINT_INFO_SIZE))
+		return 1;
+
+	info.seed = (unsigned int) info_table[0][0];
+	info.nr_surrogates = (int) info_table[0][1];
+	info.completed_rounds = (int) info_table[0][2];
+	info.nr_nodes = (int) info_table[0][3];
+	info.first_pair = (int) info_table[0][4];
+	info.nr_pairs = (int) info_table[0][5];
+	info.basewidth = (int) info_table[0][6];
+	info.nr_windowwidths = (int) info_table[0][7];
+	info.shift = (int) info_table[0][8];
+	info.length = (int) info_table[0][9];
+	info.early_stopping = (info_table[0][10] != 0);
+	info.threshold_alpha = info_table[0][11];
+	info.threshold_eta = info_table[0][12];
+	info.avoid_overlapping = (info_table[0][13] != 0);
+	info.screening_band = info_table[0][14];
+	info.parametric = (info_table[0][15] != 0);
+	info.pooled = (info_table[0][16] != 0);
+	info.single_precision = (info_table[0][17] != 0);
+	info.checksum = ((uint64_t) info_table[0][18] << 32) | (uint64_t) info_table[0][19];
+
+	if ((info.completed_rounds < 0) || (info.completed_rounds > info.nr_surrogates) || (info.first_pair < 0) || (info.nr_pairs < 0))
+		return 1;
+
+	return 0;
+}
+
+// Loads the tables saved under label for the given pairs, in their order, one at a time. Returns 1 if the checkpoint
+// cannot be read, 2 if out of memory, 3 if the table of pairs[missing_pair] is missing or has a different size.
+template <class Set> static int netOnZeroDXC_checkpoint_load_set (Set & tables, int & missing_pair, std::string checkpoint_filename, std::string label,
+									const std::vector <PairOfLabels> & pairs, int rows, int cols)
+{
+	FILE *	file_pointer = fopen(checkpoint_filename.c_str(), "rb");
+	if (!file_pointer)
+		return 1;
+	std::vector <ArchiveEntry>	entries;
+	std::vector <ArchiveEntry>	selected;
+	if (netOnZeroDXC_archive_read_toc(entries, file_pointer)) {
+		fclose(file_pointer);
+		return 1;
+	}
+	netOnZeroDXC_archive_select_entries(selected, entries, label);
+	std::map < std::pair <std::string, std::string>, int >	entry_index;
+	int	i;
+	for (i = 0; i < selected.size(); i++)
+		entry_index[std::make_pair(selected[i].label_a, selected[i].label_b)] = i;
+
+	if (tables.assign(pairs.size(), rows, cols, 0)) {
+		fclose(file_pointer);
+		return 2;
+	}
+	std::vector < std::vector <double> >	temp_table;
+	int	error = 0;
+	for (i = 0; (i < pairs.size()) && (!error); i++) {
+		std::map < std::pair <std::string, std::string>, int >::iterator	found = entry_index.find(std::make_pair(pairs[i].label_a, pairs[i].label_b));
+		if (found == entry_index.end()) {
+			error = 3;
+		} else if (netOnZeroDXC_archive_read_table(temp_table, file_pointer, selected[found->second])) {
+			error = 1;
+		} else if (tables.setTable(i, temp_table)) {		// setTable also checks the table sizes
+			error = 3;
+		}
+		if (error == 3)
+			missing_pair = i;
+	}
+	fclose(file_pointer);
+
+	return error;
+}
+
+int netOnZeroDXC_checkpoint_load (CountSet & tables, int & missing_pair, std::string checkpoint_filename, std::string label, const std::vector <PairOfLabels> & pairs, int rows, int cols)
+{
+	return netOnZeroDXC_checkpoint_load_set(tables, missing_pair, checkpoint_filename, label, pairs, rows, cols);
+}
+
+int netOnZeroDXC_checkpoint_load (DiagramSet & tables, int & missing_pair, std::string checkpoint_filename, std::string label, const std::vector <PairOfLabels> & pairs, int rows, int cols)
+{
+	return netOnZeroDXC_checkpoint_load_set(tables, missing_pair, checkpoint_filename, label, pairs, rows, cols);
+}
+
+int netOnZeroDXC_checkpoint_load (HistogramSet & tables, int & missing_pair, std::string checkpoint_filename, std::string label, const std::vector <PairOfLabels> & pairs, int rows, int cols)
+{
+	return netOnZeroDXC_checkpoint_load_set(tables, missing_pair, checkpoint_filename, label, pairs, rows, cols);
+}
+
+// Why counts saved with the settings of saved cannot be resumed by a run with those of run, as the end of a sentence
+// starting with the checkpoint name; empty if they can. Seeds, rounds and the range of pairs are left to the caller.
+std::string netOnZeroDXC_checkpoint_mismatch (const CheckpointInfo & saved, const CheckpointInfo & run)
+{
+	if ((saved.nr_surrogates != run.nr_surrogates) || (saved.nr_nodes != run.nr_nodes) || (saved.basewidth != run.basewidth)
+		|| (saved.nr_windowwidths != run.nr_windowwidths) || (saved.shift != run.shift) || (saved.length != run.length))
+		return "was saved with different sequences or parameters";
+	if (saved.checksum != run.checksum)
+		return "was saved from different sequence data";
+	if (saved.early_stopping && ((!run.early_stopping) || (saved.threshold_alpha != run.threshold_alpha) || (saved.threshold_eta != run.threshold_eta)
+					|| (saved.avoid_overlapping != run.avoid_overlapping)))
+		return "was saved for the matrix of time scales alone; resume it with the same thresholds and outputs";
+	if ((saved.screening_band != run.screening_band) || ((saved.screening_band != 0) && (saved.threshold_alpha != run.threshold_alpha)))	// Bands are relative to alpha
+		return "was saved with a different screening band or significance threshold";
+	if (saved.parametric != run.parametric)
+		return (saved.parametric)? "was saved with a parametric null" : "was saved without a parametric null";
+	if (saved.pooled != run.pooled)
+		return (saved.pooled)? "was saved with a pooled null" : "was saved without a pooled null";
+	if (saved.single_precision != run.single_precision)
+		return (saved.single_precision)? "was saved with single_precision" : "was saved without single_precision";
+
+	return "";
+}
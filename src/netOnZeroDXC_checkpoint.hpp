@@ -0,0 +1,89 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef INCLUDED_PAIR
+	#include "netOnZeroDXC_pair.hpp"
+	#define INCLUDED_PAIR
+#endif
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+
+// A checkpoint is an archive holding the partial surrogate counts of nr_pairs pairs, from triangular index first_pair
+// on, after completed_rounds rounds, so that the remaining rounds can be added later with the same results. Its
+// "checkpoint" "info" table lists the fields of CheckpointInfo in order; count tables, and whatever else a program
+// needs to resume, follow under their own quantity, keyed by the pair labels. Checkpoints are written under a
+// temporary name and renamed once complete, so that the previous one stays valid until then.
+
+#define CHECKPOINT_INFO_SIZE	20
+#define CHECKPOINT_LABEL	"checkpoint"
+
+struct CheckpointInfo {
+	unsigned int	seed;			// Base seed of the surrogates
+	int		nr_surrogates;
+	int		completed_rounds;
+	int		nr_nodes;
+	int		first_pair;
+	int		nr_pairs;
+	int		basewidth;
+	int		nr_windowwidths;
+	int		shift;			// 0 without shift
+	int		length;
+	bool		early_stopping;		// Counts of rows that stopped early are partial
+	double		threshold_alpha;
+	double		threshold_eta;
+	bool		avoid_overlapping;
+	double		screening_band;		// 0 without screening
+	bool		parametric;
+	bool		pooled;
+	bool		single_precision;	// Surrogates differ from those in double precision
+	uint64_t	checksum;		// Of the sequences, see SequenceStore::checksum
+};
+
+void netOnZeroDXC_checkpoint_initialize (CheckpointInfo &);
+int netOnZeroDXC_checkpoint_open (ArchiveFile &, std::string, const CheckpointInfo &);
+int netOnZeroDXC_checkpoint_append (ArchiveFile &, const CountSet &, std::string, const std::vector <PairOfLabels> &);
+int netOnZeroDXC_checkpoint_append (ArchiveFile &, const DiagramSet &, std::string, const std::vector <PairOfLabels> &);
+int netOnZeroDXC_checkpoint_append (ArchiveFile &, const HistogramSet &, std::string, const std::vector <PairOfLabels> &);
+int netOnZeroDXC_checkpoint_commit (ArchiveFile &, std::string);
+int netOnZeroDXC_checkpoint_load_info (CheckpointInfo &, std::string);
+int netOnZeroDXC_checkpoint_load (CountSet &, int &, std::string, std::string, const std::vector <PairOfLabels> &, int, int);
+int netOnZeroDXC_checkpoint_load (DiagramSet &, int &, std::string, std::string, const std::vector <PairOfLabels> &, int, int);
+int netOnZeroDXC_checkpoint_load (HistogramSet &, int &, std::string, std::string, const std::vector <PairOfLabels> &, int, int);
+std::string netOnZeroDXC_checkpoint_mismatch (const CheckpointInfo &, const CheckpointInfo &);
@@ -28,11 +28,13 @@
 //
 // --------------------------------------------------------------------------
 
+#include <cstdio>
 #include <cstdlib>
 #include <cmath>
 #include <ctime>
 #include <cstring>
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -48,10 +50,23 @@
 	#include "netOnZeroDXC_io.hpp"
 	#define INCLUDED_IOFUNCTIONS
 #endif
+#ifndef INCLUDED_FORMAT
+	#include "netOnZeroDXC_format.hpp"
+	#define INCLUDED_FORMAT
+#endif
+#ifndef INCLUDED_CHECKPOINT
+	#include "netOnZeroDXC_checkpoint.hpp"
+	#define INCLUDED_CHECKPOINT
+#endif
 
 void netOnZeroDXC_xc_help (char *);
-int netOnZeroDXC_xc_parse_options (int, char **, bool &, bool &, bool &, bool &, bool &, bool &, bool &, int &, int &, int &, int &, int &, int &, std::string &, std::string &, char &);
-int netOnZeroDXC_xc_check_sequences (const std::vector < std::vector <double> > &, int, int, int, int &, int);
+int netOnZeroDXC_xc_parse_options (int, char **, bool &, bool &, bool &, bool &, bool &, bool &, bool &, bool &, bool &, bool &, int &, int &, int &, int &, int &, int &, int &, int &, int &, int &, std::string &, std::string &, std::string &, std::string &, char &, char &);
+int netOnZeroDXC_xc_check_sequences (const SequenceStore &, int, int, int, int &, int);
+int netOnZeroDXC_xc_read_pair_list (std::vector <int> &, std::vector <int> &, std::string, int);
+int netOnZeroDXC_xc_batch (const SequenceStore &, const std::vector <std::string> &, const std::vector <int> &, const std::vector <int> &,
+				int, int, int, int, bool, bool, bool, bool, int, int, bool, std::string, std::string, char, char, int, int);
+int netOnZeroDXC_xc_batch_surrogates (CountSet &, const DiagramSet &, const SequenceStore &, const std::vector <std::string> &, const std::vector <int> &,
+				const std::vector <int> &, int, int, int, int, bool, int, int, bool, std::string);
 
 int main(int argc, char *argv[]) {
 
@@ -63,18 +78,27 @@ int main(int argc, char *argv[]) {
 	bool	compute_wholesequence_xcorr = false;
 	bool	enable_parallel_computing = false;
 	bool	invalid_sequences = false;
+	bool	write_binary = false;
+	bool	compute_all_pairs = false;
+	bool	resume_from_checkpoint = false;
 	int	index_a = -1, index_b = -1;
 	int	apply_tau = -1;
 	int	nr_window_widths = -1, window_basewidth = -1, nr_surrogates = 100;
+	int	text_format = TEXT_FORMAT_GENERAL, text_precision = -1;
+	int	surrogate_seed = 0, checkpoint_rounds = 0;
 	char	separator_char = 't';
 	std::string	selected_input_filename;
 	std::string	selected_output_filename;
+	std::string	selected_pairs_filename;
+	std::string	selected_output_prefix;
+	char	filename_delimiter = '_';
 
 	int error;
 	error = netOnZeroDXC_xc_parse_options (argc, argv, read_from_file, write_to_file, print_corr_diagram, compute_pvalue_diagram, use_surrogate_generation,
-						compute_wholesequence_xcorr, enable_parallel_computing, index_a, index_b,
-						apply_tau, nr_window_widths, window_basewidth, nr_surrogates,
-						selected_input_filename, selected_output_filename, separator_char);
+						compute_wholesequence_xcorr, enable_parallel_computing, write_binary, compute_all_pairs, resume_from_checkpoint,
+						index_a, index_b, apply_tau, nr_window_widths, window_basewidth, nr_surrogates, surrogate_seed, checkpoint_rounds, text_format, text_precision,
+						selected_input_filename, selected_output_filename, selected_pairs_filename, selected_output_prefix,
+						separator_char, filename_delimiter);
 	if (error)
 		exit(1);
 
@@ -105,63 +129,74 @@ int main(int argc, char *argv[]) {
 		std::cerr << "ERROR: inconsistent sequences sizes found, or only one sequence detected.\n";
 		exit(1);
 	}
+
+	SequenceStore	sequences;
+	if (sequences.assign(loaded_sequences)) {
+		std::cerr << "ERROR: not enough memory to hold the sequences.\n";
+		exit(1);
+	}
+	loaded_sequences.clear();
+
+	if ((!compute_wholesequence_xcorr) && (compute_all_pairs || selected_pairs_filename.size())) {
+		std::vector <int>	pair_index_a, pair_index_b;
+		int	i, j;
+		if (selected_pairs_filename.size()) {
+			error = netOnZeroDXC_xc_read_pair_list(pair_index_a, pair_index_b, selected_pairs_filename, sequences.size());
+			if (error)
+				exit(1);
+		} else {
+			for (i = 0; i < sequences.size() - 1; i++) {
+				for (j = i + 1; j < sequences.size(); j++) {
+					pair_index_a.push_back(i);
+					pair_index_b.push_back(j);
+				}
+			}
+		}
+		if (dummy_node_labels.size() != sequences.size()) {
+			dummy_node_labels.clear();
+			netOnZeroDXC_generate_node_labels(dummy_node_labels, sequences.size());
+		}
+
+		error = netOnZeroDXC_xc_check_sequences(sequences, 1, 1, nr_window_widths, window_basewidth, apply_tau);
+		if (error)
+			exit(1);
+
+		error = netOnZeroDXC_xc_batch(sequences, dummy_node_labels, pair_index_a, pair_index_b, nr_window_widths, window_basewidth, apply_tau, nr_surrogates,
+						print_corr_diagram, use_surrogate_generation, enable_parallel_computing, write_binary, surrogate_seed, checkpoint_rounds,
+						resume_from_checkpoint, selected_output_filename, selected_output_prefix, filename_delimiter, separator_char, text_format, text_precision);
+		if (error)
+			exit(1);
+
+		return 0;
+	}
 	if (!compute_wholesequence_xcorr) {
-	        error = netOnZeroDXC_xc_check_sequences(loaded_sequences, index_a, index_b, nr_window_widths, window_basewidth, apply_tau);
+	        error = netOnZeroDXC_xc_check_sequences(sequences, index_a, index_b, nr_window_widths, window_basewidth, apply_tau);
 		if (error)
 			exit(1);
 
 		index_a--;
 		index_b--;
 
-		int	i;
-		for (i = 0; i < loaded_sequences[index_a].size(); i++) {
-			if (loaded_sequences[index_a][i] != loaded_sequences[index_a][i]) {
-				invalid_sequences = true;
-				break;
-			}
-			if (loaded_sequences[index_b][i] != loaded_sequences[index_b][i]) {
-				invalid_sequences = true;
-				break;
-			}
-		}
+		invalid_sequences = (!sequences.valid(index_a) || !sequences.valid(index_b));
 
-		std::vector <double>	dummy_vector;
-		int	k;
-		if (apply_tau > 0) {
-			for (k = nr_window_widths*window_basewidth / 2 - 1; k < loaded_sequences[index_a].size() - nr_window_widths*window_basewidth / 2 - apply_tau; k = k + window_basewidth)
-				dummy_vector.push_back(0);
-		} else {
-			for (k = nr_window_widths*window_basewidth / 2 - 1; k < loaded_sequences[index_a].size() - nr_window_widths*window_basewidth / 2; k = k + window_basewidth)
-				dummy_vector.push_back(0);
-		}
-		std::vector < std::vector <double> >	correlation_diagram_data(nr_window_widths, dummy_vector);
-		std::vector < std::vector <double> >	p_value_diagram(nr_window_widths, dummy_vector);
-		std::vector < std::vector <double> >	p_value_diagram_fisher(nr_window_widths, dummy_vector);
+		int	k_size = netOnZeroDXC_diagram_positions(sequences.length(), window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
+		double	initial_value = (invalid_sequences)? std::numeric_limits<double>::quiet_NaN() : 0.0;
+		Diagram		correlation_diagram_data, p_value_diagram_fisher;
+		CountSet	count_diagram;			// Exceedance counts of the surrogates
+		correlation_diagram_data.assign(nr_window_widths, k_size, initial_value);
+		count_diagram.assign(1, nr_window_widths, k_size, (invalid_sequences)? COUNT_UNDEFINED : 0);
+		p_value_diagram_fisher.assign(nr_window_widths, k_size, initial_value);
+		std::vector < std::vector <double> >	output_table;
 
-		if (invalid_sequences) {
-			for (k = 0; k < correlation_diagram_data.size(); k++) {
-				for (i = 0; i < correlation_diagram_data[k].size(); i++) {
-					correlation_diagram_data[k][i] = std::numeric_limits<double>::quiet_NaN();
-					p_value_diagram[k][i] = std::numeric_limits<double>::quiet_NaN();
-					p_value_diagram_fisher[k][i] = std::numeric_limits<double>::quiet_NaN();
-				}
-			}
-		} else {
-			netOnZeroDXC_compute_cdiagram(correlation_diagram_data, p_value_diagram_fisher, loaded_sequences, index_a, index_b, window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
-		}
+		if (!invalid_sequences)
+			netOnZeroDXC_compute_cdiagram(correlation_diagram_data.view(), p_value_diagram_fisher.view(), sequences.span(index_a), sequences.span(index_b), window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
 
 		if (print_corr_diagram) {
-			if (write_to_file) {
-				error = netOnZeroDXC_save_single_file(correlation_diagram_data, selected_output_filename, separator_char);
+			correlation_diagram_data.getTable(output_table);
+			if (write_binary) {
+				error = netOnZeroDXC_save_single_file_binary(output_table, (write_to_file)? selected_output_filename : "", BINARY_TABLE_FLOAT32, 0);
 			} else {
-				int	l;
-				for (l = 0; l < nr_window_widths; l++) {
-					std::cout << correlation_diagram_data[l][0];
-					for (k = 1; k < correlation_diagram_data[l].size(); k++) {
-						std::cout << separator_char << correlation_diagram_data[l][k];
-					}
-					std::cout << "\n";
-				}
+				error = netOnZeroDXC_save_single_file_text(output_table, (write_to_file)? selected_output_filename : "", separator_char, text_format, text_precision);
 			}
 			if (error) {
 				std::cerr << "ERROR: i/o error when writing data on file '" << selected_output_filename << "'. Please check permissions.\n";
@@ -171,17 +206,11 @@ int main(int argc, char *argv[]) {
 		}
 
 		if (invalid_sequences) {
-			if (write_to_file) {
-				error = netOnZeroDXC_save_single_file(p_value_diagram, selected_output_filename, separator_char);
+			count_diagram.getPvalueTable(output_table, 0, nr_surrogates);
+			if (write_binary) {
+				error = netOnZeroDXC_save_single_file_binary(output_table, (write_to_file)? selected_output_filename : "", (use_surrogate_generation)? BINARY_TABLE_COUNTS16 : BINARY_TABLE_FLOAT32, (use_surrogate_generation)? nr_surrogates : 0);
 			} else {
-				int	l;
-				for (l = 0; l < nr_window_widths; l++) {
-					std::cout << p_value_diagram[l][0];
-					for (k = 1; k < p_value_diagram[l].size(); k++) {
-						std::cout << separator_char << p_value_diagram[l][k];
-					}
-					std::cout << "\n";
-				}
+				error = netOnZeroDXC_save_single_file_text(output_table, (write_to_file)? selected_output_filename : "", separator_char, text_format, text_precision);
 			}
 			if (error) {
 				std::cerr << "ERROR: i/o error when writing data on file '" << selected_output_filename << "'. Please check permissions.\n";
@@ -195,125 +224,77 @@ int main(int argc, char *argv[]) {
 
 			std::vector <double>		values_distribution_a, values_distribution_b;
 			std::vector <double>		fft_amplitudes_a, fft_amplitudes_b;
+			DiagramView			no_fisher = {NULL, 0, 0, 0};		// F-test p values of surrogates are not needed
+
+			int					nr_threads = (enable_parallel_computing)? omp_get_max_threads() : 1;
+			std::vector <SurrogateWorkspace>	surrogate_workspaces;
+			SequenceStore				surrogate_pairs;		// Two sequences and one diagram per thread
+			DiagramSet				correlation_diagrams_surrogates;
+			if (netOnZeroDXC_initialize_surrogate_workspaces(surrogate_workspaces, nr_threads, sequences.length(), false)
+				|| surrogate_pairs.assign(2 * nr_threads, sequences.length(), 0.0)
+				|| correlation_diagrams_surrogates.assign(nr_threads, nr_window_widths, k_size, 0.0)) {
+				std::cerr << "ERROR: not enough memory to hold the surrogates.\n";
+				exit(1);
+			}
 
-			netOnZeroDXC_initialize_surrogate_generation(values_distribution_a, fft_amplitudes_a, loaded_sequences, index_a);
-			netOnZeroDXC_initialize_surrogate_generation(values_distribution_b, fft_amplitudes_b, loaded_sequences, index_b);
+			netOnZeroDXC_initialize_surrogate_generation(values_distribution_a, fft_amplitudes_a, sequences.span(index_a), surrogate_workspaces[0]);
+			netOnZeroDXC_initialize_surrogate_generation(values_distribution_b, fft_amplitudes_b, sequences.span(index_b), surrogate_workspaces[0]);
 
 			unsigned int	seed = (unsigned int) clock();
 			if (enable_parallel_computing) {
 				#pragma omp parallel for schedule(dynamic)
 				for (int i = 0; i < nr_surrogates; i++) {
-					std::vector < std::vector <double> >	correlation_diagram_surrogates(nr_window_widths, dummy_vector);
-					std::vector <double>			temp_surrogate_sequence_a;
-					std::vector <double>			temp_surrogate_sequence_b;
-					std::vector < std::vector <double> >	surrogates_container;
-					surrogates_container.clear();
-					temp_surrogate_sequence_a.clear();
-					temp_surrogate_sequence_b.clear();
+					int	t = omp_get_thread_num();
 					seed = seed + 2*i;
-					netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_a, loaded_sequences, index_a, values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
+					netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(2*t), sequences.span(index_a), values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed, surrogate_workspaces[t]);
 					seed++;
-					netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_b, loaded_sequences, index_b, values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
-					surrogates_container.push_back(temp_surrogate_sequence_a);
-					surrogates_container.push_back(temp_surrogate_sequence_b);
-					netOnZeroDXC_compute_cdiagram(correlation_diagram_surrogates, p_value_diagram_fisher, surrogates_container, 0, 1, window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
+					netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(2*t + 1), sequences.span(index_b), values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed, surrogate_workspaces[t]);
+					netOnZeroDXC_compute_cdiagram(correlation_diagrams_surrogates.view(t), no_fisher, surrogate_pairs.span(2*t), surrogate_pairs.span(2*t + 1), window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
 					#pragma omp critical
 					{
-						netOnZeroDXC_update_pdiagram (p_value_diagram, correlation_diagram_data, correlation_diagram_surrogates, nr_window_widths, nr_surrogates);
+						netOnZeroDXC_update_pdiagram (count_diagram.view(0), correlation_diagram_data.view(), correlation_diagrams_surrogates.view(t), nr_window_widths);
 					}
 				}
 			} else {
 				int	i;
 				for (i = 0; i < nr_surrogates; i++) {
-					std::vector < std::vector <double> >	correlation_diagram_surrogates(nr_window_widths, dummy_vector);
-					std::vector <double>		temp_surrogate_sequence_a;
-					std::vector <double>		temp_surrogate_sequence_b;
-					std::vector < std::vector <double> >	surrogates_container;
-					surrogates_container.clear();
-					temp_surrogate_sequence_a.clear();
-					temp_surrogate_sequence_b.clear();
-					netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_a, loaded_sequences, index_a, values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
+					netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(0), sequences.span(index_a), values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed, surrogate_workspaces[0]);
 					seed++;
-					netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_b, loaded_sequences, index_b, values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
+					netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(1), sequences.span(index_b), values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed, surrogate_workspaces[0]);
 					seed++;
-					surrogates_container.push_back(temp_surrogate_sequence_a);
-					surrogates_container.push_back(temp_surrogate_sequence_b);
-					netOnZeroDXC_compute_cdiagram(correlation_diagram_surrogates, p_value_diagram_fisher, surrogates_container, 0, 1, window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
-					netOnZeroDXC_update_pdiagram (p_value_diagram, correlation_diagram_data, correlation_diagram_surrogates, nr_window_widths, nr_surrogates);
+					netOnZeroDXC_compute_cdiagram(correlation_diagrams_surrogates.view(0), no_fisher, surrogate_pairs.span(0), surrogate_pairs.span(1), window_basewidth, nr_window_widths, (apply_tau > 0)? true : false, apply_tau);
+					netOnZeroDXC_update_pdiagram (count_diagram.view(0), correlation_diagram_data.view(), correlation_diagrams_surrogates.view(0), nr_window_widths);
 				}
 			}
+			count_diagram.getPvalueTable(output_table, 0, nr_surrogates);
 		} else if (!use_surrogate_generation) {
-			int	l;
-			for (l = 0; l < p_value_diagram_fisher.size(); l++) {
-				for (k = 0; k < p_value_diagram_fisher[l].size(); k++) {
-					p_value_diagram[l][k] = p_value_diagram_fisher[l][k];
-				}
-			}
+			p_value_diagram_fisher.getTable(output_table);
 		}
 
-		if (write_to_file) {
-			error = netOnZeroDXC_save_single_file(p_value_diagram, selected_output_filename, separator_char);
+		if (write_binary) {
+			error = netOnZeroDXC_save_single_file_binary(output_table, (write_to_file)? selected_output_filename : "", (use_surrogate_generation)? BINARY_TABLE_COUNTS16 : BINARY_TABLE_FLOAT32, (use_surrogate_generation)? nr_surrogates : 0);
 		} else {
-			int	l;
-			for (l = 0; l < nr_window_widths; l++) {
-				std::cout << p_value_diagram[l][0];
-				for (k = 1; k < p_value_diagram[l].size(); k++) {
-					std::cout << separator_char << p_value_diagram[l][k];
-				}
-				std::cout << "\n";
-			}
+			error = netOnZeroDXC_save_single_file_text(output_table, (write_to_file)? selected_output_filename : "", separator_char, text_format, text_precision);
 		}
 		if (error) {
 			std::cerr << "ERROR: i/o error when writing data on file '" << selected_output_filename << "'. Please check permissions.\n";
 			exit(1);
 		}
 	} else if (compute_wholesequence_xcorr) {
-		std::vector <double>	dummy_vector(loaded_sequences.size(), 0.0);
-		std::vector < std::vector <double> >	correlation_matrix_wholeseq(loaded_sequences.size(), dummy_vector);
-		std::vector <bool>	valid_sequences(loaded_sequences.size(), true);
+		std::vector <double>	dummy_vector(sequences.size(), 0.0);
+		std::vector < std::vector <double> >	correlation_matrix_wholeseq(sequences.size(), dummy_vector);
+		const std::vector <bool> &	valid_sequences = sequences.validity();
 
 		int	i, j;
-		for (i = 0; i < loaded_sequences.size(); i++) {
-			for (j = 0; j < loaded_sequences[i].size(); j++) {
-				if (loaded_sequences[i][j] != loaded_sequences[i][j]) {
-					valid_sequences[i] = false;
-					break;
-				}
-			}
-		}
 
 		int	error = 0;
-		for (i = 0; i < loaded_sequences.size() - 1; i++) {
-			if (valid_sequences[i])
-				correlation_matrix_wholeseq[i][i] = 1.0;
-			else
-				correlation_matrix_wholeseq[i][i] = std::numeric_limits<double>::quiet_NaN();
-			for (j = i + 1; j < loaded_sequences.size(); j++) {
-				if (valid_sequences[i] && valid_sequences[j]) {
-					correlation_matrix_wholeseq[i][j] = netOnZeroDXC_compute_wholeseq_crosscorr(loaded_sequences, i, j, (apply_tau > 0)? true : false, apply_tau);
-					correlation_matrix_wholeseq[j][i] = correlation_matrix_wholeseq[i][j];
-				} else {
-					correlation_matrix_wholeseq[i][j] = std::numeric_limits<double>::quiet_NaN();
-					correlation_matrix_wholeseq[j][i] = std::numeric_limits<double>::quiet_NaN();
-				}
-			}
-		}
-		if (valid_sequences[i])
-			correlation_matrix_wholeseq[i][i] = 1.0;
-		else
-			correlation_matrix_wholeseq[i][i] = std::numeric_limits<double>::quiet_NaN();
+		netOnZeroDXC_compute_wholeseq_crosscorr_matrix(correlation_matrix_wholeseq, sequences, valid_sequences, (apply_tau > 0)? true : false, apply_tau, enable_parallel_computing);
 
 		if (print_corr_diagram) {
-			if (write_to_file) {
-				error = netOnZeroDXC_save_single_file(correlation_matrix_wholeseq, selected_output_filename, separator_char);
+			if (write_binary) {
+				error = netOnZeroDXC_save_single_file_binary(correlation_matrix_wholeseq, (write_to_file)? selected_output_filename : "", BINARY_TABLE_FLOAT32, 0);
 			} else {
-				for (i = 0; i < correlation_matrix_wholeseq.size(); i++) {
-					std::cout << correlation_matrix_wholeseq[i][0];
-					for (j = 1; j < correlation_matrix_wholeseq[i].size(); j++) {
-						std::cout << separator_char << correlation_matrix_wholeseq[i][j];
-					}
-					std::cout << "\n";
-				}
+				error = netOnZeroDXC_save_single_file_text(correlation_matrix_wholeseq, (write_to_file)? selected_output_filename : "", separator_char, text_format, text_precision);
 			}
 			if (error) {
 				std::cerr << "ERROR: i/o error when writing data on file '" << selected_output_filename << "'. Please check permissions.\n";
@@ -322,18 +303,27 @@ int main(int argc, char *argv[]) {
 			exit(0);
 		}
 
-		std::vector < std::vector <double> >	p_value_matrix_wholeseq(loaded_sequences.size(), dummy_vector);
+		std::vector < std::vector <double> >	p_value_matrix_wholeseq(sequences.size(), dummy_vector);
 
 		if (use_surrogate_generation) {
 			std::vector <double>		values_distribution_a, values_distribution_b;
 			std::vector <double>		fft_amplitudes_a, fft_amplitudes_b;
 
-			for (i = 0; i < loaded_sequences.size() - 1; i++) {
+			int					nr_threads = (enable_parallel_computing)? omp_get_max_threads() : 1;
+			std::vector <SurrogateWorkspace>	surrogate_workspaces;
+			SequenceStore				surrogate_pairs;		// Two sequences per thread
+			if (netOnZeroDXC_initialize_surrogate_workspaces(surrogate_workspaces, nr_threads, sequences.length(), false)
+				|| surrogate_pairs.assign(2 * nr_threads, sequences.length(), 0.0)) {
+				std::cerr << "ERROR: not enough memory to hold the surrogates.\n";
+				exit(1);
+			}
+
+			for (i = 0; i < sequences.size() - 1; i++) {
 				if (valid_sequences[i])
 					p_value_matrix_wholeseq[i][i] = 0.0;
 				else
 					p_value_matrix_wholeseq[i][i] = std::numeric_limits<double>::quiet_NaN();
-				for (j = i + 1; j < loaded_sequences.size(); j++) {
+				for (j = i + 1; j < sequences.size(); j++) {
 
 					if (!valid_sequences[i] || !valid_sequences[j]) {
 						p_value_matrix_wholeseq[i][j] = std::numeric_limits<double>::quiet_NaN();
@@ -341,27 +331,20 @@ int main(int argc, char *argv[]) {
 						continue;
 					}
 
-					netOnZeroDXC_initialize_surrogate_generation(values_distribution_a, fft_amplitudes_a, loaded_sequences, i);
-					netOnZeroDXC_initialize_surrogate_generation(values_distribution_b, fft_amplitudes_b, loaded_sequences, j);
+					netOnZeroDXC_initialize_surrogate_generation(values_distribution_a, fft_amplitudes_a, sequences.span(i), surrogate_workspaces[0]);
+					netOnZeroDXC_initialize_surrogate_generation(values_distribution_b, fft_amplitudes_b, sequences.span(j), surrogate_workspaces[0]);
 
 					unsigned int	seed = (unsigned int) clock();
 					if (enable_parallel_computing) {
 						#pragma omp parallel for schedule(dynamic)
 						for (int s = 0; s < nr_surrogates; s++) {
-							std::vector <double>		temp_surrogate_sequence_a;
-							std::vector <double>		temp_surrogate_sequence_b;
-							std::vector < std::vector <double> >	surrogates_container;
+							int	t = omp_get_thread_num();
 							double	surrogate_xcorr_coefficient = 0.0;
-							surrogates_container.clear();
-							temp_surrogate_sequence_a.clear();
-							temp_surrogate_sequence_b.clear();
 							seed = seed + 2*s;
-							netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_a, loaded_sequences, i, values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
+							netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(2*t), sequences.span(i), values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed, surrogate_workspaces[t]);
 							seed++;
-							netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_b, loaded_sequences, j, values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
-							surrogates_container.push_back(temp_surrogate_sequence_a);
-							surrogates_container.push_back(temp_surrogate_sequence_b);
-							surrogate_xcorr_coefficient = netOnZeroDXC_compute_wholeseq_crosscorr(surrogates_container, 0, 1, (apply_tau > 0)? true : false, apply_tau);
+							netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(2*t + 1), sequences.span(j), values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed, surrogate_workspaces[t]);
+							surrogate_xcorr_coefficient = netOnZeroDXC_compute_wholeseq_crosscorr(surrogate_pairs.span(2*t), surrogate_pairs.span(2*t + 1), (apply_tau > 0)? true : false, apply_tau);
 							#pragma omp critical
 							{
 								if (surrogate_xcorr_coefficient > correlation_matrix_wholeseq[i][j]) {
@@ -373,19 +356,11 @@ int main(int argc, char *argv[]) {
 						int	s;
 						double	surrogate_xcorr_coefficient;
 						for (s = 0; s < nr_surrogates; s++) {
-							std::vector <double>		temp_surrogate_sequence_a;
-							std::vector <double>		temp_surrogate_sequence_b;
-							std::vector < std::vector <double> >	surrogates_container;
-							surrogates_container.clear();
-							temp_surrogate_sequence_a.clear();
-							temp_surrogate_sequence_b.clear();
-							netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_a, loaded_sequences, i, values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed);
+							netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(0), sequences.span(i), values_distribution_a, fft_amplitudes_a, TOLERANCE_SURROGATES, seed, surrogate_workspaces[0]);
 							seed++;
-							netOnZeroDXC_generate_surrogate_sequence(temp_surrogate_sequence_b, loaded_sequences, j, values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed);
+							netOnZeroDXC_generate_surrogate_sequence(surrogate_pairs.data(1), sequences.span(j), values_distribution_b, fft_amplitudes_b, TOLERANCE_SURROGATES, seed, surrogate_workspaces[0]);
 							seed++;
-							surrogates_container.push_back(temp_surrogate_sequence_a);
-							surrogates_container.push_back(temp_surrogate_sequence_b);
-							surrogate_xcorr_coefficient = netOnZeroDXC_compute_wholeseq_crosscorr(surrogates_container, 0, 1, (apply_tau > 0)? true : false, apply_tau);
+							surrogate_xcorr_coefficient = netOnZeroDXC_compute_wholeseq_crosscorr(surrogate_pairs.span(0), surrogate_pairs.span(1), (apply_tau > 0)? true : false, apply_tau);
 							if (surrogate_xcorr_coefficient > correlation_matrix_wholeseq[i][j]) {
 								p_value_matrix_wholeseq[i][j] += 1.0 / ((double) nr_surrogates);
 							}
@@ -412,7 +387,7 @@ int main(int argc, char *argv[]) {
 						p_value_matrix_wholeseq[j][i] = std::numeric_limits<double>::quiet_NaN();
 					} else {
 						temp_cc2 = correlation_matrix_wholeseq[i][j]*correlation_matrix_wholeseq[i][j];
-						temp_n = (double) (loaded_sequences[0].size() - ((apply_tau > 0)? apply_tau : 0));
+						temp_n = (double) (sequences.length() - ((apply_tau > 0)? apply_tau : 0));
 						f_statistics = 1.0 / (1.0/temp_cc2 - 1.0);
 						f_statistics *= temp_n;
 						p_value_matrix_wholeseq[i][j] = netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1, temp_n - 2);
@@ -426,16 +401,10 @@ int main(int argc, char *argv[]) {
 				p_value_matrix_wholeseq[i][i] = std::numeric_limits<double>::quiet_NaN();
 		}
 
-		if (write_to_file) {
-			error = netOnZeroDXC_save_single_file(p_value_matrix_wholeseq, selected_output_filename, separator_char);
+		if (write_binary) {
+			error = netOnZeroDXC_save_single_file_binary(p_value_matrix_wholeseq, (write_to_file)? selected_output_filename : "", (use_surrogate_generation)? BINARY_TABLE_COUNTS16 : BINARY_TABLE_FLOAT32, (use_surrogate_generation)? nr_surrogates : 0);
 		} else {
-			for (i = 0; i < p_value_matrix_wholeseq.size(); i++) {
-				std::cout << p_value_matrix_wholeseq[i][0];
-				for (j = 1; j < p_value_matrix_wholeseq[i].size(); j++) {
-					std::cout << separator_char << p_value_matrix_wholeseq[i][j];
-				}
-				std::cout << "\n";
-			}
+			error = netOnZeroDXC_save_single_file_text(p_value_matrix_wholeseq, (write_to_file)? selected_output_filename : "", separator_char, text_format, text_precision);
 		}
 		if (error) {
 			std::cerr << "ERROR: i/o error when writing data on file '" << selected_output_filename << "'. Please check permissions.\n";
@@ -458,26 +427,43 @@ void netOnZeroDXC_xc_help (char *program_name)
 	std::cerr << "\nOptions:\n";
 	std::cerr << "\t-C\t\tonly compute correlation diagram;\n";
 	std::cerr << "\t-p\t\tcompute p value diagram by surrogate generation (default);\n";
-	std::cerr << "\t-M <#>\t\tset the number of surrogates to be generated (default = 100);\n";
+	std::cerr << "\t-M <#>\t\tset the number of surrogates to be generated (default = 100, at most 65534);\n";
 	std::cerr << "\t-tau <#>\tapply the delay of +/-tau points to assess zero-delay cross-correlation as the average of two delayed cross-correlations;\n";
 	std::cerr << "\t-Ftest\t\tcompute p values by means of a regression-based F-test, instead of the default surrogate-based evaluation;\n";
 	std::cerr << "\t-parallel\tenable parallel computing;\n";
 	std::cerr << "\t-whole-seq\tcompute cross correlations (and corresponding p values) between the whole sequences, for all pairs.\n";
 	std::cerr << "\t\t\t\tIn this case, mandatory assigments are not required and are ignored.\n";
 	std::cerr << "\t\t\t\tFlags -C and -p correspond to computing correlation coefficients only or p values, respectively.\n";
+	std::cerr << "\t-all-pairs\tcompute diagrams for all pairs of sequences in a single run, instead of the pair set by -n;\n";
+	std::cerr << "\t-pairs <fname>\tcompute diagrams for the pairs of column numbers listed in file 'fname' (one pair per line);\n";
+	std::cerr << "\t\t\t\tin both cases, input is read and surrogates are generated once per sequence, and pairs are computed in parallel\n";
+	std::cerr << "\t\t\t\tif -parallel is set. Output is written, one file per pair, in the folder set by -o (mandatory),\n";
+	std::cerr << "\t\t\t\tusing the same file names as the GUI analysis program (e.g. pdiag_001_002.dat).\n";
+	std::cerr << "\t-seed <#>\tset the base seed of the surrogates with -all-pairs or -pairs (default: drawn from the clock and printed);\n";
+	std::cerr << "\t-checkpoint <#>\twith -all-pairs or -pairs, save the partial p-value diagrams every # surrogates in the file checkpoint.dat\n";
+	std::cerr << "\t\t\t\tof the output folder, which is removed at the end (default = 0, no checkpoints);\n";
+	std::cerr << "\t-resume\t\tcontinue from the checkpoint found in the output folder, if any, with the seed saved in it:\n";
+	std::cerr << "\t\t\t\tresults are identical to those of an uninterrupted run.\n";
 
 	std::cerr << "\nInput/output:\n";
 	std::cerr << "\t-i <fname>\tread from file 'fname' instead of standard input;\n";
-	std::cerr << "\t-o <fname>\twrite to file 'fname' instead of standard output;\n";
-	std::cerr << "\t-s <@>\t\tset column separator, default t (TAB); other options are s (space) or c (comma ',').\n";
+	std::cerr << "\t-o <fname>\twrite to file 'fname' instead of standard output (output folder with -all-pairs or -pairs);\n";
+	std::cerr << "\t-prefix <str>\tprepend 'str' to output file names with -all-pairs or -pairs;\n";
+	std::cerr << "\t-d <@>\t\tset the file name delimiter with -all-pairs or -pairs, default '_';\n";
+	std::cerr << "\t-s <@>\t\tset column separator, default t (TAB); other options are s (space) or c (comma ',');\n";
+	std::cerr << "\t-prec <#>\twrite text output with # decimal digits (default: 3 in files, 6 significant digits on standard output);\n";
+	std::cerr << "\t-bin\t\twrite the output table in the compact binary format (float32 values, or 16-bit surrogate counts for p values);\n";
+	std::cerr << "\t\t\t\tbinary tables are recognized automatically when read back by any netOnZeroDXC program.\n";
 
 	std::cerr << "\n\t-h or --help\tshow this help.\n";
 }
 
 int netOnZeroDXC_xc_parse_options (int argc, char *argv[], bool & read_from_file, bool & write_to_file, bool & print_corr_diagram, bool & compute_pvalue_diagram,
-				bool & use_surrogate_generation, bool & compute_wholesequence_xcorr, bool & enable_parallel_computing,
-				int & index_a, int & index_b, int & tau, int & W, int & L, int & M,
-				std::string & input_filename, std::string & output_filename, char & separator_char)
+				bool & use_surrogate_generation, bool & compute_wholesequence_xcorr, bool & enable_parallel_computing, bool & write_binary,
+				bool & compute_all_pairs, bool & resume, int & index_a, int & index_b, int & tau, int & W, int & L, int & M, int & seed, int & checkpoint_rounds,
+				int & text_format, int & text_precision,
+				std::string & input_filename, std::string & output_filename, std::string & pairs_filename, std::string & output_prefix,
+				char & separator_char, char & filename_delimiter)
 {
 	int	n = 1;
 	while (n < argc) {
@@ -498,6 +484,17 @@ int netOnZeroDXC_xc_parse_options (int argc, char *argv[], bool & read_from_file
 		} else if (strcmp(argv[n], "-s") == 0) {
 			n++;
 			separator_char = argv[n][0];
+		} else if (strcmp(argv[n], "-prefix") == 0) {
+			n++;
+			output_prefix = argv[n];
+		} else if (strcmp(argv[n], "-d") == 0) {
+			n++;
+			filename_delimiter = argv[n][0];
+		} else if (strcmp(argv[n], "-bin") == 0) {
+			write_binary = true;
+		} else if (strcmp(argv[n], "-prec") == 0) {
+			n++;
+			text_precision = atoi(argv[n]);
 
 		} else if (strcmp(argv[n], "-parallel") == 0) {
 			enable_parallel_computing = true;
@@ -525,6 +522,19 @@ int netOnZeroDXC_xc_parse_options (int argc, char *argv[], bool & read_from_file
 
 		} else if( strcmp( argv[n], "-whole-seq" ) == 0 ) {
 			compute_wholesequence_xcorr = true;
+		} else if( strcmp( argv[n], "-all-pairs" ) == 0 ) {
+			compute_all_pairs = true;
+		} else if( strcmp( argv[n], "-pairs" ) == 0 ) {
+			n++;
+			pairs_filename = argv[n];
+		} else if( strcmp( argv[n], "-seed" ) == 0 ) {
+			n++;
+			seed = atoi(argv[n]);
+		} else if( strcmp( argv[n], "-checkpoint" ) == 0 ) {
+			n++;
+			checkpoint_rounds = atoi(argv[n]);
+		} else if( strcmp( argv[n], "-resume" ) == 0 ) {
+			resume = true;
 
 		} else if ((strcmp("-h", argv[n]) == 0) || (strcmp("--help", argv[n]) == 0))  {
 			netOnZeroDXC_xc_help(argv[0]);
@@ -538,7 +548,12 @@ int netOnZeroDXC_xc_parse_options (int argc, char *argv[], bool & read_from_file
 	else if (compute_pvalue_diagram && print_corr_diagram)
 		print_corr_diagram = false;
 
-	if ((!compute_wholesequence_xcorr) && ((index_a <= 0) || (index_b <= 0))) {
+	bool	batch_mode = (!compute_wholesequence_xcorr) && (compute_all_pairs || pairs_filename.size());
+	if (batch_mode && !write_to_file) {
+		std::cerr << "ERROR: an output folder must be set by -o when computing multiple pairs. Use " << argv[0] << " -h for a list of options.\n";
+		return 1;
+	}
+	if ((!compute_wholesequence_xcorr) && (!batch_mode) && ((index_a <= 0) || (index_b <= 0))) {
 		std::cerr << "ERROR: column numbers were not correctly set. Use " << argv[0] << " -h for a list of options.\n";
 		return 1;
 	}
@@ -550,6 +565,27 @@ int netOnZeroDXC_xc_parse_options (int argc, char *argv[], bool & read_from_file
 		std::cerr << "ERROR: base width was not correctly set. Use " << argv[0] << " -h for a list of options.\n";
 		return 1;
 	}
+	if ((!compute_wholesequence_xcorr) && (!print_corr_diagram) && use_surrogate_generation && ((M <= 0) || (M > COUNT_MAX_SURROGATES))) {
+		std::cerr << "ERROR: the number of surrogates must be between 1 and " << COUNT_MAX_SURROGATES << ".\n";
+		return 1;
+	}
+	if ((seed < 0) || (checkpoint_rounds < 0)) {
+		std::cerr << "ERROR: seed and number of surrogates between checkpoints cannot be negative.\n";
+		return 1;
+	}
+	if ((text_precision < -1) || (text_precision > TEXT_MAX_PRECISION)) {
+		std::cerr << "ERROR: number of decimal digits must be between 0 and " << TEXT_MAX_PRECISION << ".\n";
+		return 1;
+	}
+	if (text_precision >= 0) {
+		text_format = TEXT_FORMAT_FIXED;
+	} else if (write_to_file) {
+		text_format = TEXT_FORMAT_FIXED;
+		text_precision = TEXT_FILE_PRECISION;
+	} else {
+		text_format = TEXT_FORMAT_GENERAL;
+		text_precision = TEXT_STREAM_PRECISION;
+	}
 	if (separator_char == 's') {
 		separator_char = ' ';
 	} else if (separator_char == 'c') {
@@ -561,14 +597,14 @@ int netOnZeroDXC_xc_parse_options (int argc, char *argv[], bool & read_from_file
 	return 0;
 }
 
-int netOnZeroDXC_xc_check_sequences (const std::vector < std::vector <double> > & sequences, int na, int nb, int W, int & L, int tau)
+int netOnZeroDXC_xc_check_sequences (const SequenceStore & sequences, int na, int nb, int W, int & L, int tau)
 {
 	if ((na > sequences.size()) || (nb > sequences.size())) {
 		std::cerr << "ERROR: requested column numbers are larger than the number of loaded sequences.\n";
 		return 1;
 	}
 
-	if ((floor((sequences[na].size() - L * W ) / L) - ((tau > 0)? tau : 0)) < 1) {
+	if ((floor((sequences.length() - L * W ) / L) - ((tau > 0)? tau : 0)) < 1) {
 		std::cerr << "ERROR: windowing settings are invalid: negative diagram size expected.\n";
 		return 1;
 	}
@@ -580,3 +616,210 @@ int netOnZeroDXC_xc_check_sequences (const std::vector < std::vector <double> >
 
 	return 0;
 }
+
+int netOnZeroDXC_xc_read_pair_list (std::vector <int> & pair_index_a, std::vector <int> & pair_index_b, std::string file_name, int nr_sequences)
+{
+	std::ifstream	pairs_file_stream;
+	pairs_file_stream.open(file_name.c_str(), std::ifstream::in);
+	if (pairs_file_stream.fail()) {
+		std::cerr << "ERROR: cannot read the selected pair list '" << file_name << "'.\n";
+		return 1;
+	}
+
+	std::string	line;
+	int	na, nb, line_number = 0;
+	pair_index_a.clear();
+	pair_index_b.clear();
+	while (std::getline(pairs_file_stream, line)) {
+		line_number++;
+		if ((!line.size()) || (line[0] == '#'))
+			continue;
+		std::replace(line.begin(), line.end(), ',', ' ');
+		std::istringstream	line_stream(line);
+		if (!(line_stream >> na >> nb)) {
+			std::cerr << "ERROR: line " << line_number << " of the pair list does not contain two column numbers.\n";
+			return 1;
+		}
+		if ((na <= 0) || (nb <= 0) || (na > nr_sequences) || (nb > nr_sequences) || (na == nb)) {
+			std::cerr << "ERROR: invalid pair of column numbers at line " << line_number << " of the pair list.\n";
+			return 1;
+		}
+		pair_index_a.push_back(na - 1);
+		pair_index_b.push_back(nb - 1);
+	}
+	pairs_file_stream.close();
+
+	if (!pair_index_a.size()) {
+		std::cerr << "ERROR: the selected pair list is empty.\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_xc_batch (const SequenceStore & sequences, const std::vector <std::string> & node_labels,
+				const std::vector <int> & pair_index_a, const std::vector <int> & pair_index_b, int W, int L, int tau, int M,
+				bool print_corr_diagram, bool use_surrogate_generation, bool enable_parallel_computing, bool write_binary, int seed, int checkpoint_rounds,
+				bool resume, std::string output_path, std::string output_prefix, char filename_delimiter, char separator_char, int text_format, int text_precision)
+{
+	int	nr_pairs = pair_index_a.size();
+	int	i;
+
+	const std::vector <bool> &	valid_sequences = sequences.validity();
+
+	DiagramSet	correlation_diagrams;
+	DiagramSet	pvalue_diagrams;
+	CountSet	count_diagrams;
+	EarlyStopping	no_stopping = {false, 0.0, 0.0, false};
+	int	error = netOnZeroDXC_compute_cdiagram_set(correlation_diagrams, pvalue_diagrams, sequences, valid_sequences, pair_index_a, pair_index_b, L, W, (tau > 0)? true : false, tau, enable_parallel_computing, no_stopping,
+							std::vector < std::vector <double> > ());
+	if (error) {
+		std::cerr << "ERROR: not enough memory to hold the diagrams of " << nr_pairs << " pairs.\n";
+		return 1;
+	}
+	if (use_surrogate_generation && !print_corr_diagram) {
+		pvalue_diagrams.clear();
+		if (netOnZeroDXC_xc_batch_surrogates(count_diagrams, correlation_diagrams, sequences, node_labels, pair_index_a, pair_index_b, W, L, tau, M,
+							enable_parallel_computing, seed, checkpoint_rounds, resume,
+							netOnZeroDXC_generate_filepath(output_path, output_prefix, "checkpoint", filename_delimiter, "", "")))
+			return 1;
+	}
+
+	std::vector < std::vector <double> >	output_diagram;
+	std::string	output_label = (print_corr_diagram)? "cdiag" : "pdiag";
+	for (i = 0; i < nr_pairs; i++) {
+		if (print_corr_diagram)
+			correlation_diagrams.getTable(output_diagram, i);
+		else if (use_surrogate_generation)
+			count_diagrams.getPvalueTable(output_diagram, i, M);
+		else
+			pvalue_diagrams.getTable(output_diagram, i);
+		std::string	output_filename = netOnZeroDXC_generate_filepath(output_path, output_prefix, output_label, filename_delimiter, node_labels[pair_index_a[i]], node_labels[pair_index_b[i]]);
+		if (write_binary)
+			error = netOnZeroDXC_save_single_file_binary(output_diagram, output_filename, (use_surrogate_generation && !print_corr_diagram)? BINARY_TABLE_COUNTS16 : BINARY_TABLE_FLOAT32,
+							(use_surrogate_generation && !print_corr_diagram)? M : 0);
+		else
+			error = netOnZeroDXC_save_single_file_text(output_diagram, output_filename, separator_char, text_format, text_precision);
+		if (error) {
+			std::cerr << "ERROR: i/o error when writing data on file '" << output_filename << "'. Please check permissions.\n";
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+// Surrogate n of round r is generated with seed + r*N + n, N being the number of sequences, so that a run resumed from a
+// checkpoint adds exactly the rounds that an uninterrupted run would.
+int netOnZeroDXC_xc_batch_surrogates (CountSet & count_diagrams, const DiagramSet & correlation_diagrams, const SequenceStore & sequences,
+				const std::vector <std::string> & node_labels, const std::vector <int> & pair_index_a, const std::vector <int> & pair_index_b,
+				int W, int L, int tau, int M, bool enable_parallel_computing, int seed, int checkpoint_rounds, bool resume, std::string checkpoint_filename)
+{
+	int	nr_pairs = pair_index_a.size();
+	int	i;
+
+	const std::vector <bool> &	valid_sequences = sequences.validity();
+	std::vector <PairOfLabels>	pairs(nr_pairs);
+	for (i = 0; i < nr_pairs; i++) {
+		pairs[i].label_a = node_labels[pair_index_a[i]];
+		pairs[i].label_b = node_labels[pair_index_b[i]];
+	}
+
+	CheckpointInfo	run;
+	netOnZeroDXC_checkpoint_initialize(run);
+	run.seed = (seed > 0)? (unsigned int) seed : (unsigned int) time(NULL);
+	run.nr_surrogates = M;
+	run.nr_nodes = sequences.size();
+	run.nr_pairs = nr_pairs;
+	run.basewidth = L;
+	run.nr_windowwidths = W;
+	run.shift = (tau > 0)? tau : 0;
+	run.length = sequences.length();
+	run.checksum = sequences.checksum();
+
+	int	first_round = 0, last_round;
+	FILE	*checkpoint_file = (resume)? fopen(checkpoint_filename.c_str(), "rb") : NULL;
+	if (checkpoint_file) {
+		fclose(checkpoint_file);
+		CheckpointInfo	saved;
+		if (netOnZeroDXC_checkpoint_load_info(saved, checkpoint_filename)) {
+			std::cerr << "ERROR: cannot read the checkpoint file '" << checkpoint_filename << "'.\n";
+			return 1;
+		}
+		std::string	mismatch = netOnZeroDXC_checkpoint_mismatch(saved, run);
+		if (mismatch.empty() && ((saved.first_pair != run.first_pair) || (saved.nr_pairs != run.nr_pairs)))
+			mismatch = "was saved with different sequences or parameters";
+		if (!mismatch.empty()) {
+			std::cerr << "ERROR: the checkpoint '" << checkpoint_filename << "' " << mismatch << ".\n";
+			return 1;
+		}
+		if ((seed > 0) && (saved.seed != run.seed)) {
+			std::cerr << "ERROR: the checkpoint '" << checkpoint_filename << "' was saved with seed " << saved.seed << ".\n";
+			return 1;
+		}
+		int	missing_pair = 0;
+		int	error = netOnZeroDXC_checkpoint_load(count_diagrams, missing_pair, checkpoint_filename, "pdiag", pairs, W, correlation_diagrams.cols());
+		if (error == 1) {
+			std::cerr << "ERROR: cannot read the checkpoint file '" << checkpoint_filename << "'.\n";
+			return 1;
+		} else if (error == 2) {
+			std::cerr << "ERROR: not enough memory to hold the diagrams of " << nr_pairs << " pairs.\n";
+			return 1;
+		} else if (error == 3) {
+			std::cerr << "ERROR: the checkpoint '" << checkpoint_filename << "' lacks pair '" << pairs[missing_pair].label_a << " " << pairs[missing_pair].label_b << "'.\n";
+			return 1;
+		}
+		run.seed = saved.seed;
+		first_round = saved.completed_rounds;
+		std::cerr << "Resuming from surrogate " << first_round + 1 << " out of " << M << ", seed " << run.seed << ".\n";
+	} else {
+		if (resume)
+			std::cerr << "WARNING: no checkpoint found in '" << checkpoint_filename << "'; starting from the first surrogate.\n";
+		if (netOnZeroDXC_initialize_pdiagram_set(count_diagrams, correlation_diagrams, valid_sequences, pair_index_a, pair_index_b, W)) {
+			std::cerr << "ERROR: not enough memory to hold the diagrams of " << nr_pairs << " pairs.\n";
+			return 1;
+		}
+		if (seed == 0)
+			std::cerr << "Surrogates seed: " << run.seed << ".\n";
+	}
+
+	EarlyStopping		no_stopping = {false, 0.0, 0.0, false};
+	SurrogateScreening	no_screening = {false, 0.0, 0.0};
+	DiagramSet		no_moments;
+	HistogramSet		no_histograms;
+	SurrogateContext	surrogate_context;
+	if (netOnZeroDXC_initialize_surrogate_context(surrogate_context, sequences.size(), sequences.length(), W, correlation_diagrams.cols(), (tau > 0)? true : false,
+							enable_parallel_computing, false)) {
+		std::cerr << "ERROR: not enough memory to hold the surrogate sequences.\n";
+		return 1;
+	}
+	int	rounds_per_step = (checkpoint_rounds > 0)? checkpoint_rounds : M;
+	for (; first_round < M; first_round = last_round) {
+		last_round = (first_round + rounds_per_step < M)? first_round + rounds_per_step : M;
+		if (netOnZeroDXC_update_pdiagram_set(count_diagrams, surrogate_context, correlation_diagrams, sequences, valid_sequences, pair_index_a, pair_index_b, M,
+							first_round, last_round, L, W, (tau > 0)? true : false, tau, run.seed, no_stopping, no_screening,
+							no_moments, no_histograms)) {
+			std::cerr << "ERROR: not enough memory to hold the surrogate sequences.\n";
+			return 1;
+		}
+		if ((checkpoint_rounds > 0) && (last_round < M)) {
+			ArchiveFile	checkpoint_archive;
+			run.completed_rounds = last_round;
+			int	error = netOnZeroDXC_checkpoint_open(checkpoint_archive, checkpoint_filename, run);
+			if (!error)
+				error = netOnZeroDXC_checkpoint_append(checkpoint_archive, count_diagrams, "pdiag", pairs);
+			if (!error)
+				error = netOnZeroDXC_checkpoint_commit(checkpoint_archive, checkpoint_filename);
+			if (error == 2) {
+				std::cerr << "ERROR: cannot replace the checkpoint file '" << checkpoint_filename << "'.\n";
+				return 1;
+			} else if (error) {
+				std::cerr << "ERROR: i/o error when writing data on file '" << checkpoint_filename << ".tmp'. Please check permissions.\n";
+				return 1;
+			}
+		}
+	}
+	remove(checkpoint_filename.c_str());
+
+	return 0;
+}
@@ -0,0 +1,538 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#ifdef _WIN32
+	#include <malloc.h>
+#endif
+
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+
+double * netOnZeroDXC_aligned_alloc (size_t nr_cells)
+{
+	void	*block = NULL;
+#ifdef _WIN32
+	block = _aligned_malloc(nr_cells * sizeof(double), DIAGRAM_ALIGNMENT);
+#else
+	if (posix_memalign(&block, DIAGRAM_ALIGNMENT, nr_cells * sizeof(double)))
+		block = NULL;
+#endif
+	return (double *) block;
+}
+
+void netOnZeroDXC_aligned_free (double * block)
+{
+#ifdef _WIN32
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+
+DiagramSet::DiagramSet ()
+{
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+}
+
+DiagramSet::DiagramSet (const DiagramSet & other)
+{
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+	if (other.m_data && !assign(other.m_count, other.m_rows, other.m_cols, 0.0))
+		std::copy(other.m_data, other.m_data + other.m_count * other.m_rows * other.m_stride, m_data);
+}
+
+DiagramSet::~DiagramSet ()
+{
+	clear();
+}
+
+DiagramSet & DiagramSet::operator= (const DiagramSet & other)
+{
+	DiagramSet	temp_set(other);
+	swap(temp_set);
+	return *this;
+}
+
+// Allocates count diagrams of rows x cols cells, all set to value; existing contents are discarded.
+int DiagramSet::assign (size_t count, int rows, int cols, double value)
+{
+	int	stride = ((cols + DIAGRAM_ROW_PADDING - 1) / DIAGRAM_ROW_PADDING) * DIAGRAM_ROW_PADDING;
+	size_t	nr_cells = count * rows * stride;
+
+	if (nr_cells != m_count * m_rows * m_stride) {
+		clear();
+		if (nr_cells) {
+			m_data = netOnZeroDXC_aligned_alloc(nr_cells);
+			if (!m_data)
+				return 1;
+		}
+	}
+	m_count = count;
+	m_rows = rows;
+	m_cols = cols;
+	m_stride = stride;
+	std::fill(m_data, m_data + nr_cells, value);
+
+	return 0;
+}
+
+void DiagramSet::clear ()
+{
+	if (m_data)
+		netOnZeroDXC_aligned_free(m_data);
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+}
+
+void DiagramSet::swap (DiagramSet & other)
+{
+	std::swap(m_data, other.m_data);
+	std::swap(m_count, other.m_count);
+	std::swap(m_rows, other.m_rows);
+	std::swap(m_cols, other.m_cols);
+	std::swap(m_stride, other.m_stride);
+}
+
+size_t DiagramSet::size () const
+{
+	return m_count;
+}
+
+int DiagramSet::rows () const
+{
+	return m_rows;
+}
+
+int DiagramSet::cols () const
+{
+	return m_cols;
+}
+
+DiagramView DiagramSet::view (size_t index) const
+{
+	DiagramView	diagram;
+	diagram.data = m_data + index * m_rows * m_stride;
+	diagram.rows = m_rows;
+	diagram.cols = m_cols;
+	diagram.stride = m_stride;
+	return diagram;
+}
+
+double * DiagramSet::row (size_t index, int l) const
+{
+	return m_data + (index * m_rows + l) * m_stride;
+}
+
+void DiagramSet::fill (size_t index, double value)
+{
+	std::fill(row(index, 0), row(index, 0) + m_rows * m_stride, value);
+}
+
+int DiagramSet::getTable (std::vector < std::vector <double> > & table, size_t index) const
+{
+	if (index >= m_count)
+		return 1;
+
+	table.resize(m_rows);
+	int	l;
+	for (l = 0; l < m_rows; l++)
+		table[l].assign(row(index, l), row(index, l) + m_cols);
+
+	return 0;
+}
+
+int DiagramSet::setTable (size_t index, const std::vector < std::vector <double> > & table)
+{
+	if ((index >= m_count) || (table.size() != m_rows))
+		return 1;
+
+	int	l;
+	for (l = 0; l < m_rows; l++) {
+		if (table[l].size() != m_cols)
+			return 1;
+		std::copy(table[l].begin(), table[l].end(), row(index, l));
+	}
+
+	return 0;
+}
+
+int Diagram::assign (int rows, int cols, double value)
+{
+	return m_storage.assign(1, rows, cols, value);
+}
+
+void Diagram::clear ()
+{
+	m_storage.clear();
+}
+
+int Diagram::rows () const
+{
+	return m_storage.rows();
+}
+
+int Diagram::cols () const
+{
+	return m_storage.cols();
+}
+
+DiagramView Diagram::view () const
+{
+	return m_storage.view(0);
+}
+
+double * Diagram::row (int l) const
+{
+	return m_storage.row(0, l);
+}
+
+int Diagram::getTable (std::vector < std::vector <double> > & table) const
+{
+	return m_storage.getTable(table, 0);
+}
+
+// Resizes the diagram to the size of the table.
+int Diagram::setTable (const std::vector < std::vector <double> > & table)
+{
+	if (table.empty() || m_storage.assign(1, table.size(), table[0].size(), 0.0))
+		return 1;
+	return m_storage.setTable(0, table);
+}
+
+CountSet::CountSet ()
+{
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+}
+
+CountSet::CountSet (const CountSet & other)
+{
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+	if (other.m_data && !assign(other.m_count, other.m_rows, other.m_cols, 0))
+		std::copy(other.m_data, other.m_data + other.m_count * other.m_rows * other.m_stride, m_data);
+}
+
+CountSet::~CountSet ()
+{
+	clear();
+}
+
+CountSet & CountSet::operator= (const CountSet & other)
+{
+	CountSet	temp_set(other);
+	swap(temp_set);
+	return *this;
+}
+
+// Allocates count diagrams of rows x cols cells, all set to value; existing contents are discarded.
+int CountSet::assign (size_t count, int rows, int cols, uint16_t value)
+{
+	int	stride = ((cols + COUNT_ROW_PADDING - 1) / COUNT_ROW_PADDING) * COUNT_ROW_PADDING;
+	size_t	nr_cells = count * rows * stride;
+
+	if (nr_cells != m_count * m_rows * m_stride) {
+		clear();
+		if (nr_cells) {
+			m_data = (uint16_t *) netOnZeroDXC_aligned_alloc((nr_cells * sizeof(uint16_t) + sizeof(double) - 1) / sizeof(double));
+			if (!m_data)
+				return 1;
+		}
+	}
+	m_count = count;
+	m_rows = rows;
+	m_cols = cols;
+	m_stride = stride;
+	std::fill(m_data, m_data + nr_cells, value);
+
+	return 0;
+}
+
+void CountSet::clear ()
+{
+	if (m_data)
+		netOnZeroDXC_aligned_free((double *) m_data);
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+}
+
+void CountSet::swap (CountSet & other)
+{
+	std::swap(m_data, other.m_data);
+	std::swap(m_count, other.m_count);
+	std::swap(m_rows, other.m_rows);
+	std::swap(m_cols, other.m_cols);
+	std::swap(m_stride, other.m_stride);
+}
+
+size_t CountSet::size () const
+{
+	return m_count;
+}
+
+int CountSet::rows () const
+{
+	return m_rows;
+}
+
+int CountSet::cols () const
+{
+	return m_cols;
+}
+
+CountView CountSet::view (size_t index) const
+{
+	CountView	diagram;
+	diagram.data = m_data + index * m_rows * m_stride;
+	diagram.rows = m_rows;
+	diagram.cols = m_cols;
+	diagram.stride = m_stride;
+	return diagram;
+}
+
+uint16_t * CountSet::row (size_t index, int l) const
+{
+	return m_data + (index * m_rows + l) * m_stride;
+}
+
+void CountSet::fill (size_t index, uint16_t value)
+{
+	std::fill(row(index, 0), row(index, 0) + m_rows * m_stride, value);
+}
+
+// Counts as they are, NaN for undefined cells.
+int CountSet::getTable (std::vector < std::vector <double> > & table, size_t index) const
+{
+	return getPvalueTable(table, index, 1);
+}
+
+// P values count / M, NaN for undefined cells.
+int CountSet::getPvalueTable (std::vector < std::vector <double> > & table, size_t index, int M) const
+{
+	if (index >= m_count)
+		return 1;
+
+	table.resize(m_rows);
+	int	l, k;
+	for (l = 0; l < m_rows; l++) {
+		const uint16_t	*count_row = row(index, l);
+		table[l].resize(m_cols);
+		for (k = 0; k < m_cols; k++)
+			table[l][k] = (count_row[k] == COUNT_UNDEFINED)? std::numeric_limits<double>::quiet_NaN() : (double) count_row[k] / (double) M;
+	}
+
+	return 0;
+}
+
+// Takes a table of counts; NaN cells become undefined.
+int CountSet::setTable (size_t index, const std::vector < std::vector <double> > & table)
+{
+	if ((index >= m_count) || (table.size() != m_rows))
+		return 1;
+
+	int	l, k;
+	for (l = 0; l < m_rows; l++) {
+		if (table[l].size() != m_cols)
+			return 1;
+		uint16_t	*count_row = row(index, l);
+		for (k = 0; k < m_cols; k++)
+			count_row[k] = (std::isnan(table[l][k]) || (table[l][k] < 0.0) || (table[l][k] > COUNT_MAX_SURROGATES))? COUNT_UNDEFINED : (uint16_t) table[l][k];
+	}
+
+	return 0;
+}
+
+HistogramSet::HistogramSet ()
+{
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+}
+
+HistogramSet::HistogramSet (const HistogramSet & other)
+{
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+	if (other.m_data && !assign(other.m_count, other.m_rows, other.m_cols, 0))
+		std::copy(other.m_data, other.m_data + other.m_count * other.m_rows * other.m_stride, m_data);
+}
+
+HistogramSet::~HistogramSet ()
+{
+	clear();
+}
+
+HistogramSet & HistogramSet::operator= (const HistogramSet & other)
+{
+	HistogramSet	temp_set(other);
+	swap(temp_set);
+	return *this;
+}
+
+// Allocates count histograms of rows x cols bins, all set to value; existing contents are discarded.
+int HistogramSet::assign (size_t count, int rows, int cols, uint32_t value)
+{
+	int	stride = ((cols + HISTOGRAM_ROW_PADDING - 1) / HISTOGRAM_ROW_PADDING) * HISTOGRAM_ROW_PADDING;
+	size_t	nr_cells = count * rows * stride;
+
+	if (nr_cells != m_count * m_rows * m_stride) {
+		clear();
+		if (nr_cells) {
+			m_data = (uint32_t *) netOnZeroDXC_aligned_alloc((nr_cells * sizeof(uint32_t) + sizeof(double) - 1) / sizeof(double));
+			if (!m_data)
+				return 1;
+		}
+	}
+	m_count = count;
+	m_rows = rows;
+	m_cols = cols;
+	m_stride = stride;
+	std::fill(m_data, m_data + nr_cells, value);
+
+	return 0;
+}
+
+void HistogramSet::clear ()
+{
+	if (m_data)
+		netOnZeroDXC_aligned_free((double *) m_data);
+	m_data = NULL;
+	m_count = 0;
+	m_rows = 0;
+	m_cols = 0;
+	m_stride = 0;
+}
+
+void HistogramSet::swap (HistogramSet & other)
+{
+	std::swap(m_data, other.m_data);
+	std::swap(m_count, other.m_count);
+	std::swap(m_rows, other.m_rows);
+	std::swap(m_cols, other.m_cols);
+	std::swap(m_stride, other.m_stride);
+}
+
+size_t HistogramSet::size () const
+{
+	return m_count;
+}
+
+int HistogramSet::rows () const
+{
+	return m_rows;
+}
+
+int HistogramSet::cols () const
+{
+	return m_cols;
+}
+
+HistogramView HistogramSet::view (size_t index) const
+{
+	HistogramView	histogram;
+	histogram.data = m_data + index * m_rows * m_stride;
+	histogram.rows = m_rows;
+	histogram.cols = m_cols;
+	histogram.stride = m_stride;
+	return histogram;
+}
+
+uint32_t * HistogramSet::row (size_t index, int l) const
+{
+	return m_data + (index * m_rows + l) * m_stride;
+}
+
+int HistogramSet::getTable (std::vector < std::vector <double> > & table, size_t index) const
+{
+	if (index >= m_count)
+		return 1;
+
+	table.resize(m_rows);
+	int	l;
+	for (l = 0; l < m_rows; l++) {
+		const uint32_t	*histogram_row = row(index, l);
+		table[l].assign(histogram_row, histogram_row + m_cols);
+	}
+
+	return 0;
+}
+
+int HistogramSet::setTable (size_t index, const std::vector < std::vector <double> > & table)
+{
+	if ((index >= m_count) || (table.size() != m_rows))
+		return 1;
+
+	int	l, k;
+	for (l = 0; l < m_rows; l++) {
+		if (table[l].size() != m_cols)
+			return 1;
+		uint32_t	*histogram_row = row(index, l);
+		for (k = 0; k < m_cols; k++) {
+			if (!(table[l][k] >= 0.0) || (table[l][k] > 4294967295.0))		// Also rejects NaN
+				return 1;
+			histogram_row[k] = (uint32_t) table[l][k];
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,190 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstddef>
+#include <stdint.h>
+
+// Diagrams are W x K tables of window widths by window positions. A DiagramSet keeps the diagrams
+// of many pairs in a single block of memory aligned to DIAGRAM_ALIGNMENT bytes; each row starts on
+// an aligned boundary, rows being padded to a multiple of DIAGRAM_ROW_PADDING cells. A DiagramView
+// refers to one diagram of a set and stays valid until the set is reassigned, cleared or destroyed.
+// Nested tables are used only at the boundaries with file i/o (getTable, setTable).
+
+#define DIAGRAM_ALIGNMENT	64
+#define DIAGRAM_ROW_PADDING	8
+
+struct DiagramView {
+	double *	data;
+	int		rows;
+	int		cols;
+	int		stride;
+
+	double * row(int l) const {return data + (size_t) l * stride;}
+};
+
+class DiagramSet
+{
+public:
+	DiagramSet();
+	DiagramSet(const DiagramSet &);
+	~DiagramSet();
+	DiagramSet & operator= (const DiagramSet &);
+
+	int assign(size_t, int, int, double);
+	void clear();
+	void swap(DiagramSet &);
+	size_t size() const;
+	int rows() const;
+	int cols() const;
+
+	DiagramView view(size_t) const;
+	double * row(size_t, int) const;
+	void fill(size_t, double);
+	int getTable(std::vector < std::vector <double> > &, size_t) const;
+	int setTable(size_t, const std::vector < std::vector <double> > &);
+
+private:
+	double *	m_data;
+	size_t		m_count;
+	int		m_rows;
+	int		m_cols;
+	int		m_stride;
+};
+
+// A single diagram, e.g. the working diagram of one surrogate.
+class Diagram
+{
+public:
+	int assign(int, int, double);
+	void clear();
+	int rows() const;
+	int cols() const;
+
+	DiagramView view() const;
+	double * row(int) const;
+	int getTable(std::vector < std::vector <double> > &) const;
+	int setTable(const std::vector < std::vector <double> > &);
+
+private:
+	DiagramSet	m_storage;
+};
+
+// Surrogate p-value diagrams kept as exceedance counts: a CountSet holds them as 16-bit integers, a quarter of the
+// memory of a DiagramSet, with the same layout and alignment; rows are padded to COUNT_ROW_PADDING cells. Cells of
+// undefined diagrams hold COUNT_UNDEFINED, which is never below a count limit, so at most COUNT_MAX_SURROGATES
+// surrogates can be counted. P values are count / M.
+
+#define COUNT_ROW_PADDING	32
+#define COUNT_UNDEFINED		0xFFFF
+#define COUNT_MAX_SURROGATES	65534
+
+struct CountView {
+	uint16_t *	data;
+	int		rows;
+	int		cols;
+	int		stride;
+
+	uint16_t * row(int l) const {return data + (size_t) l * stride;}
+};
+
+class CountSet
+{
+public:
+	CountSet();
+	CountSet(const CountSet &);
+	~CountSet();
+	CountSet & operator= (const CountSet &);
+
+	int assign(size_t, int, int, uint16_t);
+	void clear();
+	void swap(CountSet &);
+	size_t size() const;
+	int rows() const;
+	int cols() const;
+
+	CountView view(size_t) const;
+	uint16_t * row(size_t, int) const;
+	void fill(size_t, uint16_t);
+	int getTable(std::vector < std::vector <double> > &, size_t) const;
+	int getPvalueTable(std::vector < std::vector <double> > &, size_t, int) const;
+	int setTable(size_t, const std::vector < std::vector <double> > &);
+
+private:
+	uint16_t *	m_data;
+	size_t		m_count;
+	int		m_rows;
+	int		m_cols;
+	int		m_stride;
+};
+
+// Histograms of the pooled null, one row of bins per window width, kept as 32-bit counts with the layout and alignment
+// of a DiagramSet; rows are padded to HISTOGRAM_ROW_PADDING cells.
+
+#define HISTOGRAM_ROW_PADDING	16
+
+struct HistogramView {
+	uint32_t *	data;
+	int		rows;
+	int		cols;
+	int		stride;
+
+	uint32_t * row(int l) const {return data + (size_t) l * stride;}
+};
+
+class HistogramSet
+{
+public:
+	HistogramSet();
+	HistogramSet(const HistogramSet &);
+	~HistogramSet();
+	HistogramSet & operator= (const HistogramSet &);
+
+	int assign(size_t, int, int, uint32_t);
+	void clear();
+	void swap(HistogramSet &);
+	size_t size() const;
+	int rows() const;
+	int cols() const;
+
+	HistogramView view(size_t) const;
+	uint32_t * row(size_t, int) const;
+	int getTable(std::vector < std::vector <double> > &, size_t) const;
+	int setTable(size_t, const std::vector < std::vector <double> > &);
+
+private:
+	uint32_t *	m_data;
+	size_t		m_count;
+	int		m_rows;
+	int		m_cols;
+	int		m_stride;
+};
+
+double * netOnZeroDXC_aligned_alloc (size_t);
+void netOnZeroDXC_aligned_free (double *);
@@ -0,0 +1,322 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifndef INCLUDED_IOFUNCTIONS
+	#include "netOnZeroDXC_io.hpp"
+	#define INCLUDED_IOFUNCTIONS
+#endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+#ifndef INCLUDED_DIAGRAMVIEW
+	#include "netOnZeroDXC_diagram_view.hpp"
+	#define INCLUDED_DIAGRAMVIEW
+#endif
+
+MappedRange::MappedRange ()
+{
+	data = NULL;
+	size = 0;
+	m_base = NULL;
+	m_length = 0;
+}
+
+MappedRange::~MappedRange ()
+{
+	unmap();
+}
+
+// Maps size bytes starting at offset; a zero size maps up to the end of the file.
+int MappedRange::map (std::string file_name, uint64_t offset, uint64_t range_size)
+{
+	unmap();
+
+#ifdef _WIN32
+	HANDLE	file_handle = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file_handle == INVALID_HANDLE_VALUE)
+		return 1;
+	LARGE_INTEGER	file_size;
+	if (!GetFileSizeEx(file_handle, &file_size)) {
+		CloseHandle(file_handle);
+		return 1;
+	}
+	uint64_t	total_size = (uint64_t) file_size.QuadPart;
+	SYSTEM_INFO	system_info;
+	GetSystemInfo(&system_info);
+	uint64_t	granularity = system_info.dwAllocationGranularity;
+#else
+	int	descriptor = open(file_name.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		return 1;
+	struct stat	file_status;
+	if (fstat(descriptor, &file_status)) {
+		close(descriptor);
+		return 1;
+	}
+	uint64_t	total_size = (uint64_t) file_status.st_size;
+	uint64_t	granularity = (uint64_t) sysconf(_SC_PAGESIZE);
+#endif
+
+	if (range_size == 0)
+		range_size = (offset < total_size)? total_size - offset : 0;
+	uint64_t	aligned_offset = offset - offset % granularity;	// Mappings must start at a page boundary
+	bool		valid_range = (range_size > 0) && (offset + range_size <= total_size);
+	m_length = (valid_range)? (size_t) (offset - aligned_offset + range_size) : 0;
+
+#ifdef _WIN32
+	HANDLE	mapping_handle = (valid_range)? CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	if (mapping_handle) {
+		m_base = MapViewOfFile(mapping_handle, FILE_MAP_READ, (DWORD) (aligned_offset >> 32), (DWORD) (aligned_offset & 0xFFFFFFFF), m_length);
+		CloseHandle(mapping_handle);		// The view keeps the mapping alive
+	}
+	CloseHandle(file_handle);
+#else
+	if (valid_range) {
+		m_base = mmap(NULL, m_length, PROT_READ, MAP_PRIVATE, descriptor, (off_t) aligned_offset);
+		if (m_base == MAP_FAILED)
+			m_base = NULL;
+	}
+	close(descriptor);			// The mapping stays valid after closing the descriptor
+#endif
+
+	if (!m_base) {
+		m_length = 0;
+		return 1;
+	}
+	data = ((const char *) m_base) + (offset - aligned_offset);
+	size = (size_t) range_size;
+
+	return 0;
+}
+
+void MappedRange::unmap ()
+{
+	if (m_base) {
+#ifdef _WIN32
+		UnmapViewOfFile(m_base);
+#else
+		munmap(m_base, m_length);
+#endif
+	}
+	data = NULL;
+	size = 0;
+	m_base = NULL;
+	m_length = 0;
+}
+
+DiagramCollection::DiagramCollection () {}
+
+void DiagramCollection::clear ()
+{
+	m_sources.clear();
+	m_resident.clear();
+}
+
+size_t DiagramCollection::size () const
+{
+	return m_sources.size();
+}
+
+int DiagramCollection::rows () const
+{
+	return (m_sources.size())? m_sources[0].rows : 0;
+}
+
+int DiagramCollection::cols () const
+{
+	return (m_sources.size())? m_sources[0].cols : 0;
+}
+
+// Same return codes as the loaders: 1 if labels cannot be parsed from the file name, 2 on read errors.
+int DiagramCollection::addFile (std::vector <PairOfLabels> & list_pairs, std::string file_name, std::string quantity, char separator_char, char filename_delimiter_char)
+{
+	PairOfLabels	parsed_label_pair;
+	FILE *		file_pointer;
+	char		magic[8];
+	size_t		n;
+	if (netOnZeroDXC_check_archive(file_name)) {		// One source per selected record, labelled by the table of contents
+		file_pointer = fopen(file_name.c_str(), "rb");
+		if (!file_pointer)
+			return 2;
+		std::vector <ArchiveEntry>	entries;
+		std::vector <ArchiveEntry>	selected;
+		if (netOnZeroDXC_archive_read_toc(entries, file_pointer)) {
+			fclose(file_pointer);
+			return 2;
+		}
+		netOnZeroDXC_archive_select_entries(selected, entries, quantity);
+		for (n = 0; n < selected.size(); n++) {
+			if (addBinaryTable(file_name, file_pointer, selected[n].offset, selected[n].size)) {
+				fclose(file_pointer);
+				return 2;
+			}
+			parsed_label_pair.label_a = selected[n].label_a;
+			parsed_label_pair.label_b = selected[n].label_b;
+			list_pairs.push_back(parsed_label_pair);
+		}
+		fclose(file_pointer);
+		return 0;
+	}
+
+	if (netOnZeroDXC_parse_filename_2labels(parsed_label_pair, file_name, filename_delimiter_char))
+		return 1;
+
+	file_pointer = fopen(file_name.c_str(), "rb");
+	if (!file_pointer)
+		return 2;
+	n = fread(magic, 1, sizeof(magic), file_pointer);
+	if (netOnZeroDXC_check_binary_magic(magic, n)) {
+		int	error = 0;
+		if (ARCHIVE_FSEEK(file_pointer, 0, SEEK_END))
+			error = 1;
+		int64_t	file_size = ARCHIVE_FTELL(file_pointer);
+		if (error || (file_size <= 0) || addBinaryTable(file_name, file_pointer, 0, (uint64_t) file_size)) {
+			fclose(file_pointer);
+			return 2;
+		}
+		fclose(file_pointer);
+		list_pairs.push_back(parsed_label_pair);
+		return 0;
+	}
+	fclose(file_pointer);
+
+	DiagramSource	source;
+	source.file_name = file_name;
+	source.offset = 0;
+	source.size = 0;
+	source.resident_index = m_resident.size();
+	m_resident.push_back(std::vector < std::vector <double> > ());
+	if (netOnZeroDXC_read_data_table(m_resident.back(), file_name, separator_char))
+		return 2;
+	source.rows = m_resident.back().size();
+	source.cols = (source.rows)? m_resident.back()[0].size() : 0;
+	for (n = 1; n < source.rows; n++) {
+		if (m_resident.back()[n].size() != source.cols)
+			source.cols = -1;			// Rejected by checkSizes()
+	}
+	m_sources.push_back(source);
+	list_pairs.push_back(parsed_label_pair);
+
+	return 0;
+}
+
+int DiagramCollection::addBinaryTable (std::string file_name, FILE * file_pointer, uint64_t offset, uint64_t table_size)
+{
+	BinaryTableHeader	header;
+	if (table_size < sizeof(BinaryTableHeader))
+		return 1;
+	if (ARCHIVE_FSEEK(file_pointer, offset, SEEK_SET))
+		return 1;
+	if (fread(&header, sizeof(BinaryTableHeader), 1, file_pointer) != 1)
+		return 1;
+	if (!netOnZeroDXC_check_binary_magic(header.magic, sizeof(header.magic)) || (header.version != BINARY_TABLE_VERSION))
+		return 1;
+	size_t	cell_size = netOnZeroDXC_binary_cell_size(header);
+	if ((cell_size == 0) || (table_size < sizeof(BinaryTableHeader) + ((uint64_t) header.rows) * header.cols * cell_size))
+		return 1;
+
+	DiagramSource	source;
+	source.file_name = file_name;
+	source.offset = offset;
+	source.size = table_size;
+	source.resident_index = 0;
+	source.rows = header.rows;
+	source.cols = header.cols;
+	m_sources.push_back(source);
+
+	return 0;
+}
+
+void DiagramCollection::append (DiagramCollection & other)
+{
+	size_t	i;
+	for (i = 0; i < other.m_sources.size(); i++) {
+		m_sources.push_back(other.m_sources[i]);
+		if (other.m_sources[i].size == 0) {
+			m_sources.back().resident_index = m_resident.size();
+			m_resident.push_back(std::vector < std::vector <double> > ());
+			m_resident.back().swap(other.m_resident[other.m_sources[i].resident_index]);
+		}
+	}
+	other.clear();
+}
+
+int DiagramCollection::checkSizes () const
+{
+	if ((m_sources.size() == 0) || (m_sources[0].rows <= 0) || (m_sources[0].cols <= 0))
+		return 1;
+
+	size_t	i;
+	for (i = 1; i < m_sources.size(); i++) {
+		if ((m_sources[i].rows != m_sources[0].rows) || (m_sources[i].cols != m_sources[0].cols))
+			return 1;
+	}
+
+	return 0;
+}
+
+// Safe to call from several threads at once: every call maps its own range.
+int DiagramCollection::getDiagram (std::vector < std::vector <double> > & diagram, size_t index) const
+{
+	if (index >= m_sources.size())
+		return 1;
+
+	const DiagramSource &	source = m_sources[index];
+	if (source.size == 0) {
+		diagram = m_resident[source.resident_index];
+		return 0;
+	}
+
+	MappedRange	mapped_table;
+	if (mapped_table.map(source.file_name, source.offset, source.size))
+		return 1;
+	if (netOnZeroDXC_parse_binary_table(diagram, mapped_table.data, mapped_table.size))
+		return 1;
+	if ((diagram.size() != source.rows) || (source.rows && (diagram[0].size() != source.cols)))
+		return 1;				// File changed since it was opened
+
+	return 0;
+}
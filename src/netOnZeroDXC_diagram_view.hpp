@@ -0,0 +1,90 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdio>
+#include <stdint.h>
+
+#ifndef INCLUDED_PAIR
+	#include "netOnZeroDXC_pair.hpp"
+	#define INCLUDED_PAIR
+#endif
+
+// A DiagramCollection refers to p-value diagrams without holding them in memory. Diagrams stored
+// in the binary format, either as single files or as archive records, are only indexed when
+// opened (labels and header), and each is memory-mapped, decoded and unmapped again on request.
+// Text diagrams cannot be located without parsing them, hence they are kept in memory.
+
+class MappedRange
+{
+public:
+	MappedRange();
+	~MappedRange();
+
+	int map(std::string, uint64_t, uint64_t);
+	void unmap();
+
+	const char *	data;
+	size_t		size;
+
+private:
+	void *		m_base;
+	size_t		m_length;
+};
+
+struct DiagramSource {
+	std::string	file_name;
+	uint64_t	offset;
+	uint64_t	size;		// Zero for diagrams held in memory
+	size_t		resident_index;
+	int		rows;
+	int		cols;
+};
+
+class DiagramCollection
+{
+public:
+	DiagramCollection();
+
+	void clear();
+	size_t size() const;
+	int rows() const;
+	int cols() const;
+
+	int addFile(std::vector <PairOfLabels> &, std::string, std::string, char, char);
+	void append(DiagramCollection &);
+	int checkSizes() const;
+	int getDiagram(std::vector < std::vector <double> > &, size_t) const;
+
+private:
+	int addBinaryTable(std::string, FILE *, uint64_t, uint64_t);
+
+	std::vector <DiagramSource>				m_sources;
+	std::vector < std::vector < std::vector <double> > >	m_resident;
+};
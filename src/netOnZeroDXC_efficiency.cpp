@@ -33,6 +33,7 @@
 #include <ctime>
 #include <cstring>
 #include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -48,10 +49,20 @@
 	#include "netOnZeroDXC_io.hpp"
 	#define INCLUDED_IOFUNCTIONS
 #endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+#ifndef INCLUDED_FORMAT
+	#include "netOnZeroDXC_format.hpp"
+	#define INCLUDED_FORMAT
+#endif
 
 void netOnZeroDXC_eff_help (char *);
-int netOnZeroDXC_eff_parse_options (int, char **, bool &, bool &, double &, double &, bool &, std::string &, std::string &, char &);
+int netOnZeroDXC_eff_parse_options (int, char **, bool &, bool &, double &, double &, bool &, int &, int &, std::string &, std::string &, std::string &, std::string &, char &);
 int netOnZeroDXC_eff_check_diagram (const std::vector < std::vector <double> > &);
+int netOnZeroDXC_eff_compute_table (std::vector < std::vector <double> > &, const std::vector < std::vector <double> > &, double, double, bool);
+int netOnZeroDXC_eff_process_archive (std::string, std::string, double, double, bool);
 
 int main(int argc, char *argv[]) {
 
@@ -60,19 +71,42 @@ int main(int argc, char *argv[]) {
 	bool	avoid_overlapping_windows = false;
 	double	threshold_significance = -1.0;
 	double	window_basewidth = 1.0;
+	int	text_format = TEXT_FORMAT_GENERAL, text_precision = -1;
 	char	separator_char = 't';
 	std::string	selected_input_filename;
 	std::string	selected_output_filename;
+	std::string	selected_label_a;
+	std::string	selected_label_b;
 
 	int error;
 	error = netOnZeroDXC_eff_parse_options (argc, argv, read_from_file, write_to_file, threshold_significance, window_basewidth, avoid_overlapping_windows,
-					selected_input_filename, selected_output_filename, separator_char);
+					text_format, text_precision, selected_input_filename, selected_output_filename, selected_label_a, selected_label_b, separator_char);
 	if (error)
 		exit(1);
 
 	std::vector < std::vector <double> > 	loaded_diagram;
 
-	if (read_from_file) {
+	if (read_from_file && netOnZeroDXC_check_archive(selected_input_filename)) {
+		if (selected_label_a.size() == 0) {					// No pair selected: process all p-value diagrams of the archive
+			if (!write_to_file) {
+				std::cerr << "ERROR: processing a whole archive requires an output archive to be set by -o.\n";
+				exit(1);
+			}
+			error = netOnZeroDXC_eff_process_archive(selected_input_filename, selected_output_filename, threshold_significance, window_basewidth, avoid_overlapping_windows);
+			if (error)
+				exit(1);
+			return 0;
+		}
+		error = netOnZeroDXC_archive_load_entry(loaded_diagram, selected_input_filename, "pdiag", selected_label_a, selected_label_b);
+		if (error == 1) {
+			std::cerr << "ERROR: cannot read the selected archive '" << selected_input_filename << "'.\n";
+			exit(1);
+		}
+		if (error == 2) {
+			std::cerr << "ERROR: no p-value diagram for pair (" << selected_label_a << ", " << selected_label_b << ") in archive '" << selected_input_filename << "'.\n";
+			exit(1);
+		}
+	} else if (read_from_file) {
 		error = netOnZeroDXC_load_single_table(loaded_diagram, selected_input_filename, separator_char);
 		if (error == 2) {
 			std::cerr << "ERROR: cannot read the selected file '" << selected_input_filename << "'.\n";
@@ -90,69 +124,10 @@ int main(int argc, char *argv[]) {
 		exit(1);
 
 
-	std::vector <double>	window_widths;
-	std::vector <double>	efficiency;
-	bool	valid_row;
-	int	i, j;
-	double	temp_eta;
-	if (!avoid_overlapping_windows) {
-		for (i = 0; i < loaded_diagram.size(); i++) {
-			temp_eta = 0.0;
-			valid_row = true;
-			for (j = 0; j < loaded_diagram[i].size(); j++) {
-				if (loaded_diagram[i][j] != loaded_diagram[i][j]) {
-					temp_eta = std::numeric_limits<double>::quiet_NaN();
-					valid_row = false;
-					break;
-				}
-				if (loaded_diagram[i][j] <= threshold_significance) {
-					temp_eta += 1.0;
-				}
-			}
-			if (valid_row)
-				temp_eta /= (double) loaded_diagram[i].size();
-			window_widths.push_back(window_basewidth * (i+1));
-			efficiency.push_back(temp_eta);
-		}
-	} else if (avoid_overlapping_windows) {
-		double	n;
-		for (i = 0; i < loaded_diagram.size(); i++) {
-			temp_eta = 0.0;
-			n = 0.0;
-			valid_row = true;
-			for (j = 0; j < loaded_diagram[i].size(); j += (i + 1)) {
-				if (loaded_diagram[i][j] != loaded_diagram[i][j]) {
-					temp_eta = std::numeric_limits<double>::quiet_NaN();
-					valid_row = false;
-					break;
-				}
-				if (loaded_diagram[i][j] <= threshold_significance) {
-					temp_eta += 1.0;
-				}
-				n += 1.0;
-			}
-			if (valid_row)
-				temp_eta /= n;
-			window_widths.push_back(window_basewidth * (i+1));
-			efficiency.push_back(temp_eta);
-		}
-	}
-
 	std::vector < std::vector <double> >	output_data;
-	std::vector <double>			w_eta(2, 0.0);
-	for (i = 0; i < window_widths.size(); i++) {
-		w_eta[0] = window_widths[i];
-		w_eta[1] = efficiency[i];
-		output_data.push_back(w_eta);
-	}
+	netOnZeroDXC_eff_compute_table(output_data, loaded_diagram, threshold_significance, window_basewidth, avoid_overlapping_windows);
 
-	if (write_to_file) {
-		error = netOnZeroDXC_save_single_file(output_data, selected_output_filename, separator_char);
-	} else {
-		for (i = 0; i < output_data.size(); i++) {
-			std::cout << output_data[i][0] << separator_char << output_data[i][1] << "\n";
-		}
-	}
+	error = netOnZeroDXC_save_single_file_text(output_data, (write_to_file)? selected_output_filename : "", separator_char, text_format, text_precision);
 	if (error) {
 		std::cerr << "ERROR: i/o error when writing data on file '" << selected_output_filename << "'. Please check permissions.\n";
 		exit(1);
@@ -170,18 +145,21 @@ void netOnZeroDXC_eff_help (char *program_name)
 
 	std::cerr << "\nOptions:\n";
 	std::cerr << "\t-w <#>\t\tset the base window width (corresponding to the first row of the diagram), default is 1;\n";
-	std::cerr << "\t-avoid-overlap\tcompute efficiency by considering non-overlapping windows only.\n";
+	std::cerr << "\t-avoid-overlap\tcompute efficiency by considering non-overlapping windows only;\n";
+	std::cerr << "\t-pair <a> <b>\twhen reading from an archive, select the p value diagram of the pair of nodes labelled 'a' and 'b'.\n";
+	std::cerr << "\t\t\t\tIf no pair is selected, the efficiencies of all the pairs in the archive are appended to the archive set by -o.\n";
 
 	std::cerr << "\nInput/output:\n";
-	std::cerr << "\t-i <fname>\tread from file 'fname' instead of standard input;\n";
+	std::cerr << "\t-i <fname>\tread from file 'fname' instead of standard input (text or binary diagrams, or archives, are accepted);\n";
 	std::cerr << "\t-o <fname>\twrite to file 'fname' instead of standard output;\n";
-	std::cerr << "\t-s <@>\t\tselect label to choose column separator, default t (TAB); other valid options are s (space) or c (comma ',').\n";
+	std::cerr << "\t-s <@>\t\tselect label to choose column separator, default t (TAB); other valid options are s (space) or c (comma ',');\n";
+	std::cerr << "\t-prec <#>\twrite text output with # decimal digits (default: 3 in files, 6 significant digits on standard output).\n";
 
 	std::cerr << "\n\t-h or --help\tshow this help.\n";
 }
 
 int netOnZeroDXC_eff_parse_options (int argc, char *argv[], bool & read_from_file, bool & write_to_file, double & threshold, double & basewidth,
-				bool & avoid_overlapping_windows, std::string & input_filename, std::string & output_filename, char & separator_char)
+				bool & avoid_overlapping_windows, int & text_format, int & text_precision, std::string & input_filename, std::string & output_filename, std::string & label_a, std::string & label_b, char & separator_char)
 {
 	int	n = 1;
 	while (n < argc) {
@@ -200,6 +178,9 @@ int netOnZeroDXC_eff_parse_options (int argc, char *argv[], bool & read_from_fil
 		} else if (strcmp(argv[n], "-s") == 0) {
 			n++;
 			separator_char = argv[n][0];
+		} else if (strcmp(argv[n], "-prec") == 0) {
+			n++;
+			text_precision = atoi(argv[n]);
 
 		} else if( strcmp( argv[n], "-w" ) == 0 ) {
 			n++;
@@ -207,6 +188,11 @@ int netOnZeroDXC_eff_parse_options (int argc, char *argv[], bool & read_from_fil
 
 		} else if( strcmp( argv[n], "-avoid-overlap" ) == 0 ) {
 			avoid_overlapping_windows = true;
+		} else if( strcmp( argv[n], "-pair" ) == 0 ) {
+			n++;
+			label_a = argv[n];
+			n++;
+			label_b = argv[n];
 
 		} else if ((strcmp("-h", argv[n]) == 0) || (strcmp("--help", argv[n]) == 0))  {
 			netOnZeroDXC_eff_help(argv[0]);
@@ -223,6 +209,19 @@ int netOnZeroDXC_eff_parse_options (int argc, char *argv[], bool & read_from_fil
 		std::cerr << "ERROR: base window width is invalid (it is required to be positive).\n";
 		return 1;
 	}
+	if ((text_precision < -1) || (text_precision > TEXT_MAX_PRECISION)) {
+		std::cerr << "ERROR: number of decimal digits must be between 0 and " << TEXT_MAX_PRECISION << ".\n";
+		return 1;
+	}
+	if (text_precision >= 0) {
+		text_format = TEXT_FORMAT_FIXED;
+	} else if (write_to_file) {
+		text_format = TEXT_FORMAT_FIXED;
+		text_precision = TEXT_FILE_PRECISION;
+	} else {
+		text_format = TEXT_FORMAT_GENERAL;
+		text_precision = TEXT_STREAM_PRECISION;
+	}
 	if (separator_char == 's') {
 		separator_char = ' ';
 	} else if (separator_char == 'c') {
@@ -252,3 +251,81 @@ int netOnZeroDXC_eff_check_diagram (const std::vector < std::vector <double> > &
 
 	return 0;
 }
+
+int netOnZeroDXC_eff_compute_table (std::vector < std::vector <double> > & output_data, const std::vector < std::vector <double> > & diagram, double threshold,
+				double basewidth, bool avoid_overlapping_windows)
+{
+	output_data.clear();
+
+	std::vector <double>	window_widths;
+	std::vector <double>	efficiency;
+	SignificanceMask	mask;
+	int	i;
+	if (netOnZeroDXC_significance_mask(mask, diagram, threshold, true))
+		return 1;
+	netOnZeroDXC_mask_efficiency(efficiency, mask, avoid_overlapping_windows, true);	// A NaN cell makes the efficiency of its row NaN
+	for (i = 0; i < diagram.size(); i++)
+		window_widths.push_back(basewidth * (i+1));
+
+	std::vector <double>			w_eta(2, 0.0);
+	for (i = 0; i < window_widths.size(); i++) {
+		w_eta[0] = window_widths[i];
+		w_eta[1] = efficiency[i];
+		output_data.push_back(w_eta);
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_eff_process_archive (std::string input_filename, std::string output_filename, double threshold, double basewidth, bool avoid_overlapping_windows)
+{
+	FILE *	file_pointer = fopen(input_filename.c_str(), "rb");
+	if (!file_pointer) {
+		std::cerr << "ERROR: cannot read the selected archive '" << input_filename << "'.\n";
+		return 1;
+	}
+	std::vector <ArchiveEntry>	entries;
+	std::vector <ArchiveEntry>	selected;
+	if (netOnZeroDXC_archive_read_toc(entries, file_pointer)) {
+		fclose(file_pointer);
+		std::cerr << "ERROR: the table of contents of archive '" << input_filename << "' is missing or damaged.\n";
+		return 1;
+	}
+	netOnZeroDXC_archive_select_entries(selected, entries, "pdiag");
+
+	ArchiveFile	output_archive;
+	if (netOnZeroDXC_archive_open(output_archive, output_filename, true)) {
+		fclose(file_pointer);
+		std::cerr << "ERROR: i/o error when opening archive '" << output_filename << "'. Please check permissions.\n";
+		return 1;
+	}
+
+	std::vector < std::vector <double> >	diagram;
+	std::vector < std::vector <double> >	output_data;
+	size_t	i;
+	for (i = 0; i < selected.size(); i++) {			// One diagram at a time: archives may not fit in memory
+		if (netOnZeroDXC_archive_read_table(diagram, file_pointer, selected[i])) {
+			fclose(file_pointer);
+			std::cerr << "ERROR: cannot read the p-value diagram of pair (" << selected[i].label_a << ", " << selected[i].label_b << ").\n";
+			return 1;
+		}
+		if (netOnZeroDXC_eff_check_diagram(diagram)) {
+			fclose(file_pointer);
+			return 1;
+		}
+		netOnZeroDXC_eff_compute_table(output_data, diagram, threshold, basewidth, avoid_overlapping_windows);
+		if (netOnZeroDXC_archive_append_table(output_archive, output_data, "eff", selected[i].label_a, selected[i].label_b, BINARY_TABLE_FLOAT64, 0)) {
+			fclose(file_pointer);
+			std::cerr << "ERROR: i/o error when writing data on archive '" << output_filename << "'. Please check permissions.\n";
+			return 1;
+		}
+	}
+	fclose(file_pointer);
+
+	if (netOnZeroDXC_archive_close(output_archive)) {
+		std::cerr << "ERROR: i/o error when writing data on archive '" << output_filename << "'. Please check permissions.\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__has_include)
+	#if __has_include(<charconv>)
+		#include <charconv>
+	#endif
+#endif
+
+#ifndef INCLUDED_FORMAT
+	#include "netOnZeroDXC_format.hpp"
+	#define INCLUDED_FORMAT
+#endif
+
+TextTableWriter::TextTableWriter (FILE * file_pointer, int format, int precision)
+{
+	m_file = file_pointer;
+	m_format = format;
+	if (precision < 0)
+		precision = 0;
+	if (precision > TEXT_MAX_PRECISION)
+		precision = TEXT_MAX_PRECISION;
+	m_precision = precision;
+	m_failed = false;
+	m_buffer.resize(TEXT_BUFFER_SIZE);
+	m_used = 0;
+}
+
+TextTableWriter::~TextTableWriter ()
+{
+	flush();
+}
+
+int TextTableWriter::putValue (double value)
+{
+	if (m_buffer.size() - m_used < TEXT_MAX_VALUE_LENGTH) {
+		if (flush())
+			return 1;
+	}
+
+	int	length = netOnZeroDXC_format_value(&m_buffer[m_used], &m_buffer[0] + m_buffer.size(), value, m_format, m_precision);
+	if (length < 0) {
+		m_failed = true;
+		return 1;
+	}
+	m_used += length;
+
+	return 0;
+}
+
+int TextTableWriter::putChar (char character)
+{
+	if (m_used == m_buffer.size()) {
+		if (flush())
+			return 1;
+	}
+	m_buffer[m_used] = character;
+	m_used++;
+
+	return 0;
+}
+
+int TextTableWriter::putRow (const std::vector <double> & row, char separator)
+{
+	int	j;
+	for (j = 0; j < row.size(); j++) {
+		if (j > 0)
+			putChar(separator);
+		putValue(row[j]);
+	}
+
+	return putChar('\n');
+}
+
+int TextTableWriter::putTable (const std::vector < std::vector <double> > & data_table, char separator)
+{
+	int	i;
+	for (i = 0; i < data_table.size(); i++) {
+		if (putRow(data_table[i], separator))
+			return 1;
+	}
+
+	return flush();
+}
+
+int TextTableWriter::flush ()
+{
+	if (m_failed || !m_file)
+		return 1;
+
+	if (m_used > 0) {
+		if (fwrite(&m_buffer[0], 1, m_used, m_file) != m_used)
+			m_failed = true;
+		m_used = 0;
+	}
+	if (fflush(m_file) == EOF)
+		m_failed = true;
+
+	return (m_failed)? 1 : 0;
+}
+
+// Writes value into [first, last) and returns the number of characters, or -1 if they do not fit.
+int netOnZeroDXC_format_value (char * first, char * last, double value, int format, int precision)
+{
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+	std::to_chars_result	result;
+	if (format == TEXT_FORMAT_GENERAL)
+		result = std::to_chars(first, last, value, std::chars_format::general, (precision > 0)? precision : 1);
+	else
+		result = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+	if (result.ec != std::errc())
+		return -1;
+
+	return result.ptr - first;
+#else
+	int	length;
+	if (format == TEXT_FORMAT_GENERAL)
+		length = snprintf(first, last - first, "%.*g", precision, value);
+	else
+		length = snprintf(first, last - first, "%.*f", precision, value);
+	if ((length < 0) || (length >= last - first))
+		return -1;
+
+	return length;
+#endif
+}
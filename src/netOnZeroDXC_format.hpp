@@ -0,0 +1,65 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdio>
+
+// Text tables are formatted into a large buffer and handed to the stream in big writes, instead
+// of one fprintf or std::cout call per cell. Values are formatted with std::to_chars when the
+// standard library provides it, and with snprintf otherwise; both give the same text as printf.
+
+#define TEXT_FORMAT_FIXED		0	// "%.<precision>f", used for files
+#define TEXT_FORMAT_GENERAL		1	// "%.<precision>g", i.e. the std::cout defaults
+#define TEXT_FILE_PRECISION		3
+#define TEXT_STREAM_PRECISION		6
+#define TEXT_MAX_PRECISION		30
+#define TEXT_BUFFER_SIZE		(1 << 18)
+#define TEXT_MAX_VALUE_LENGTH		400	// Longest fixed-point double at TEXT_MAX_PRECISION, plus margin
+
+class TextTableWriter {
+public:
+	TextTableWriter(FILE *, int, int);
+	~TextTableWriter();
+
+	int putValue(double);
+	int putChar(char);
+	int putRow(const std::vector <double> &, char);
+	int putTable(const std::vector < std::vector <double> > &, char);
+	int flush();
+
+private:
+	FILE *			m_file;
+	int			m_format;
+	int			m_precision;
+	bool			m_failed;
+	std::vector <char>	m_buffer;
+	size_t			m_used;
+};
+
+int netOnZeroDXC_format_value(char *, char *, double, int, int);
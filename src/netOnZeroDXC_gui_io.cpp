@@ -39,12 +39,18 @@
 #include <string>
 #include <vector>
 
+#include "omp.h"
+
 #include "wx/arrstr.h"
 
 #ifndef INCLUDED_IOFUNCTIONS
 	#include "netOnZeroDXC_io.hpp"
 	#define INCLUDED_IOFUNCTIONS
 #endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
 #ifndef INCLUDED_IOFUNCTIONS_WX
 	#include "netOnZeroDXC_gui_io.hpp"
 	#define INCLUDED_IOFUNCTIONS_WX
@@ -55,31 +61,26 @@ int netOnZeroDXC_load_multi_sequences(std::vector < std::vector <double> > & seq
 {
 	list_of_files.Sort();
 
-	int	i, j;
-	int	node_index;
+	int	i;
 	int	error = 0;
 	int	nr_files = list_of_files.GetCount();
-	std::string				file_name;
-	std::string				temp_label;
-	std::vector <double>			temp_sequence;
-	std::vector < std::vector <double> >	temp_input;
-	for (i = 0; i < nr_files; i++) {
-		temp_sequence.clear();
-		file_name = list_of_files[i].ToStdString();
-		if (netOnZeroDXC_parse_filename_1label(temp_label, file_name, filename_delimiter_char))
-			return 1;
-		node_labels.push_back(temp_label);
-		error = netOnZeroDXC_read_data_table(temp_input, file_name, separator_char);
-		if (error)
-			return 2;
-		if ((temp_input.size() == 0) || (column_number < 0))
-			return 3;
-		if (column_number > temp_input[0].size())
-			return 3;
-		for (j = 0; j < temp_input.size(); j++) {
-			temp_sequence.push_back(temp_input[j][column_number - 1]);
-		}
-		sequences_table.push_back(temp_sequence);
+	std::vector <std::string>	file_names(nr_files);
+	for (i = 0; i < nr_files; i++)
+		file_names[i] = list_of_files[i].ToStdString();
+
+	std::vector <int>			loading_errors(nr_files, 0);
+	std::vector <std::string>		loaded_labels(nr_files);
+	std::vector < std::vector <double> >	loaded_sequences(nr_files);
+	#pragma omp parallel for schedule(dynamic)
+	for (int f = 0; f < nr_files; f++)
+		loading_errors[f] = netOnZeroDXC_load_sequence_file(loaded_sequences[f], loaded_labels[f], file_names[f], separator_char, filename_delimiter_char, column_number);
+
+	for (i = 0; i < nr_files; i++) {			// Results are collected in the sorted order; the first failing file is reported
+		if (loading_errors[i])
+			return loading_errors[i];
+		node_labels.push_back(loaded_labels[i]);
+		sequences_table.push_back(std::vector <double> ());
+		sequences_table.back().swap(loaded_sequences[i]);
 	}
 
 	error = netOnZeroDXC_check_linear_sizes(sequences_table);
@@ -101,22 +102,28 @@ int netOnZeroDXC_load_multi_diagrams (std::vector < std::vector < std::vector <d
 {
 	list_of_files.Sort();
 
-	int	i;
+	int	i, k;
 	int	error = 0;
 	int	nr_files = list_of_files.GetCount();
-	std::string	file_name;
-	PairOfLabels	parsed_label_pair;
-	std::vector < std::vector <double> >	temp_diagram;
-	for (i = 0; i < nr_files; i++) {
-		file_name = list_of_files[i].ToStdString();
-		error = netOnZeroDXC_parse_filename_2labels(parsed_label_pair, file_name, filename_delimiter_char);
-		if (error)
-			return 1;
-		list_pairs.push_back(parsed_label_pair);
-		error = netOnZeroDXC_read_data_table(temp_diagram, file_name, separator_char);
-		if (error)
-			return 2;
-		diagrams_pvalue.push_back(temp_diagram);
+	std::vector <std::string>	file_names(nr_files);
+	for (i = 0; i < nr_files; i++)
+		file_names[i] = list_of_files[i].ToStdString();
+
+	std::vector <int>						loading_errors(nr_files, 0);
+	std::vector < std::vector <PairOfLabels> >			loaded_pairs(nr_files);
+	std::vector < std::vector < std::vector < std::vector <double> > > >	loaded_diagrams(nr_files);
+	#pragma omp parallel for schedule(dynamic)
+	for (int f = 0; f < nr_files; f++)
+		loading_errors[f] = netOnZeroDXC_load_labelled_tables(loaded_diagrams[f], loaded_pairs[f], file_names[f], "pdiag", separator_char, filename_delimiter_char);
+
+	for (i = 0; i < nr_files; i++) {			// Results are collected in the sorted order; the first failing file is reported
+		if (loading_errors[i])
+			return loading_errors[i];
+		for (k = 0; k < loaded_diagrams[i].size(); k++) {
+			list_pairs.push_back(loaded_pairs[i][k]);
+			diagrams_pvalue.push_back(std::vector < std::vector <double> > ());
+			diagrams_pvalue.back().swap(loaded_diagrams[i][k]);
+		}
 	}
 
 	error = netOnZeroDXC_check_table_sizes(diagrams_pvalue);
@@ -130,6 +137,45 @@ int netOnZeroDXC_load_multi_diagrams (std::vector < std::vector < std::vector <d
 	return 0;
 }
 
+// Like netOnZeroDXC_load_multi_diagrams, but binary diagrams are only indexed, not loaded.
+int netOnZeroDXC_open_multi_diagrams (DiagramCollection & diagrams, std::vector <PairOfLabels> & list_pairs,
+				wxArrayString & list_of_files, char separator_char, char filename_delimiter_char)
+{
+	list_of_files.Sort();
+
+	int	i, k;
+	int	error = 0;
+	int	nr_files = list_of_files.GetCount();
+	std::vector <std::string>	file_names(nr_files);
+	for (i = 0; i < nr_files; i++)
+		file_names[i] = list_of_files[i].ToStdString();
+
+	std::vector <int>				loading_errors(nr_files, 0);
+	std::vector < std::vector <PairOfLabels> >	loaded_pairs(nr_files);
+	std::vector <DiagramCollection>			opened_diagrams(nr_files);
+	#pragma omp parallel for schedule(dynamic)
+	for (int f = 0; f < nr_files; f++)
+		loading_errors[f] = opened_diagrams[f].addFile(loaded_pairs[f], file_names[f], "pdiag", separator_char, filename_delimiter_char);
+
+	for (i = 0; i < nr_files; i++) {			// Results are collected in the sorted order; the first failing file is reported
+		if (loading_errors[i])
+			return loading_errors[i];
+		for (k = 0; k < loaded_pairs[i].size(); k++)
+			list_pairs.push_back(loaded_pairs[i][k]);
+		diagrams.append(opened_diagrams[i]);
+	}
+
+	error = diagrams.checkSizes();
+	if (error)
+		return 3;
+
+	error = netOnZeroDXC_check_list_pairs(list_pairs);
+	if (error)
+		return 4;
+
+	return 0;
+}
+
 int netOnZeroDXC_load_multi_efficiencies (std::vector < std::vector <double> > & efficiencies, std::vector <PairOfLabels> & list_pairs,
 					std::vector <double> & window_widths, wxArrayString & list_of_files, char separator_char,
 					char filename_delimiter_char)
@@ -139,37 +185,45 @@ int netOnZeroDXC_load_multi_efficiencies (std::vector < std::vector <double> > &
 	efficiencies.clear();
 
 	bool	inconsistent_w_found = 0;
-	int	i, j;
+	int	i, j, k;
 	int	error = 0;
 	int	nr_files = list_of_files.GetCount();
-	std::string	file_name;
+	std::vector <std::string>	file_names(nr_files);
+	for (i = 0; i < nr_files; i++)
+		file_names[i] = list_of_files[i].ToStdString();
+
+	std::vector <int>						loading_errors(nr_files, 0);
+	std::vector < std::vector <PairOfLabels> >			loaded_pairs(nr_files);
+	std::vector < std::vector < std::vector < std::vector <double> > > >	loaded_tables(nr_files);
+	#pragma omp parallel for schedule(dynamic)
+	for (int f = 0; f < nr_files; f++)
+		loading_errors[f] = netOnZeroDXC_load_labelled_tables(loaded_tables[f], loaded_pairs[f], file_names[f], "eff", separator_char, filename_delimiter_char);
+
 	std::vector <double>	temp_eta;
-	std::vector < std::vector <double> >	temp_efficiency;
-	PairOfLabels	parsed_label_pair;
-	for (i = 0; i < nr_files; i++) {
-		file_name = list_of_files[i].ToStdString();
-		temp_eta.clear();
-		error = netOnZeroDXC_parse_filename_2labels(parsed_label_pair, file_name, filename_delimiter_char);
-		if (error)
-			return 1;
-		list_pairs.push_back(parsed_label_pair);
-		error = netOnZeroDXC_read_data_table(temp_efficiency, file_name, separator_char);
-		if (error)
-			return 2;
-		for (j = 0; j < temp_efficiency.size(); j++) {
-			if (i) {
-				if (window_widths[j] != temp_efficiency[j][0]) {
-					inconsistent_w_found = 1;
-					break;
+	for (i = 0; i < nr_files; i++) {			// Results are collected in the sorted order; the first failing file is reported
+		if (loading_errors[i])
+			return loading_errors[i];
+		for (k = 0; k < loaded_tables[i].size(); k++) {
+			list_pairs.push_back(loaded_pairs[i][k]);
+			temp_eta.clear();
+			for (j = 0; j < loaded_tables[i][k].size(); j++) {
+				if (loaded_tables[i][k][j].size() < 2)
+					return 3;
+				if (efficiencies.size()) {
+					if ((j >= window_widths.size()) || (window_widths[j] != loaded_tables[i][k][j][0])) {
+						inconsistent_w_found = 1;
+						break;
+					}
+				} else {
+					window_widths.push_back(loaded_tables[i][k][j][0]);
 				}
-			} else {
-				window_widths.push_back(temp_efficiency[j][0]);
+				temp_eta.push_back(loaded_tables[i][k][j][1]);
 			}
-			temp_eta.push_back(temp_efficiency[j][1]);
+			if (inconsistent_w_found)
+				return 3;
+			efficiencies.push_back(temp_eta);
 		}
-		if (inconsistent_w_found)
-			return 3;
-		efficiencies.push_back(temp_eta);
+		loaded_tables[i].clear();
 	}
 
 	error = netOnZeroDXC_check_linear_sizes(efficiencies);
@@ -182,3 +236,46 @@ int netOnZeroDXC_load_multi_efficiencies (std::vector < std::vector <double> > &
 
 	return 0;
 }
+
+int netOnZeroDXC_load_sequence_file (std::vector <double> & sequence, std::string & node_label, std::string file_name,
+				char separator_char, char filename_delimiter_char, int column_number)
+{
+	if (netOnZeroDXC_parse_filename_1label(node_label, file_name, filename_delimiter_char))
+		return 1;
+
+	std::vector < std::vector <double> >	temp_input;
+	if (netOnZeroDXC_read_data_table(temp_input, file_name, separator_char))
+		return 2;
+	if ((temp_input.size() == 0) || (column_number < 0))
+		return 3;
+	if (column_number > temp_input[0].size())
+		return 3;
+
+	int	j;
+	sequence.clear();
+	for (j = 0; j < temp_input.size(); j++) {
+		sequence.push_back(temp_input[j][column_number - 1]);
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_load_labelled_tables (std::vector < std::vector < std::vector <double> > > & tables, std::vector <PairOfLabels> & list_pairs,
+				std::string file_name, std::string quantity, char separator_char, char filename_delimiter_char)
+{
+	if (netOnZeroDXC_check_archive(file_name)) {		// All tables of this quantity stored in the archive, labelled by its table of contents
+		if (netOnZeroDXC_archive_load_quantity(tables, list_pairs, file_name, quantity))
+			return 2;
+		return 0;
+	}
+
+	PairOfLabels	parsed_label_pair;
+	if (netOnZeroDXC_parse_filename_2labels(parsed_label_pair, file_name, filename_delimiter_char))
+		return 1;
+	list_pairs.push_back(parsed_label_pair);
+	tables.resize(1);
+	if (netOnZeroDXC_read_data_table(tables[0], file_name, separator_char))
+		return 2;
+
+	return 0;
+}
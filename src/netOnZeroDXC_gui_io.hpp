@@ -32,7 +32,14 @@
 	#include "netOnZeroDXC_pair.hpp"
 	#define INCLUDED_PAIR
 #endif
+#ifndef INCLUDED_DIAGRAMVIEW
+	#include "netOnZeroDXC_diagram_view.hpp"
+	#define INCLUDED_DIAGRAMVIEW
+#endif
 
 int netOnZeroDXC_load_multi_sequences(std::vector < std::vector <double> > &, std::vector <std::string> &, wxArrayString &, char, char, int);
 int netOnZeroDXC_load_multi_diagrams(std::vector < std::vector < std::vector <double> > > &, std::vector <PairOfLabels> &, wxArrayString &, char, char);
+int netOnZeroDXC_open_multi_diagrams(DiagramCollection &, std::vector <PairOfLabels> &, wxArrayString &, char, char);
 int netOnZeroDXC_load_multi_efficiencies(std::vector < std::vector <double> > &, std::vector <PairOfLabels> &, std::vector <double> &, wxArrayString &, char, char);
+int netOnZeroDXC_load_sequence_file(std::vector <double> &, std::string &, std::string, char, char, int);
+int netOnZeroDXC_load_labelled_tables(std::vector < std::vector < std::vector <double> > > &, std::vector <PairOfLabels> &, std::string, std::string, char, char);
@@ -31,14 +31,27 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <cctype>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <string>
 
+#ifdef _WIN32
+	#include <io.h>
+	#include <fcntl.h>
+#endif
+
+#ifndef INCLUDED_FORMAT
+	#include "netOnZeroDXC_format.hpp"
+	#define INCLUDED_FORMAT
+#endif
 #ifndef INCLUDED_IOFUNCTIONS
 	#include "netOnZeroDXC_io.hpp"
 	#define INCLUDED_IOFUNCTIONS
@@ -47,6 +60,17 @@
 int netOnZeroDXC_read_data_table (std::vector < std::vector <double> > & data_table, std::string file_path, char separator)
 {
 	data_table.clear();
+
+	char	magic[sizeof(BinaryTableHeader::magic)];
+	size_t	magic_size = 0;
+	FILE *	file_pointer = fopen(file_path.c_str(), "rb");
+	if (!file_pointer)
+		return 1;
+	magic_size = fread(magic, 1, sizeof(magic), file_pointer);
+	fclose(file_pointer);
+	if (netOnZeroDXC_check_binary_magic(magic, magic_size))		// Binary tables are detected by their header, whatever the extension
+		return netOnZeroDXC_read_binary_table(data_table, file_path);
+
 	std::ifstream	selected_file_stream;
 	selected_file_stream.open(file_path.c_str(), std::ifstream::in);
 	if (selected_file_stream.fail())
@@ -69,6 +93,97 @@ int netOnZeroDXC_read_data_table (std::vector < std::vector <double> > & data_ta
 	return 0;
 }
 
+bool netOnZeroDXC_check_binary_magic (const char * data, size_t size)
+{
+	if (size < sizeof(BinaryTableHeader::magic))
+		return false;
+
+	return (memcmp(data, BINARY_TABLE_MAGIC, sizeof(BinaryTableHeader::magic)) == 0);
+}
+
+int netOnZeroDXC_read_binary_table (std::vector < std::vector <double> > & data_table, std::string file_path)
+{
+	data_table.clear();
+	FILE *	file_pointer = fopen(file_path.c_str(), "rb");
+	if (!file_pointer)
+		return 1;
+
+	std::vector <char>	content;
+	char	buffer[65536];
+	size_t	n;
+	while ((n = fread(buffer, 1, sizeof(buffer), file_pointer)) > 0)
+		content.insert(content.end(), buffer, buffer + n);
+	fclose(file_pointer);
+
+	if (netOnZeroDXC_parse_binary_table(data_table, content.data(), content.size()))
+		return 1;
+
+	return 0;
+}
+
+size_t netOnZeroDXC_binary_cell_size (const BinaryTableHeader & header)
+{
+	if (header.cell_type == BINARY_TABLE_FLOAT32)
+		return sizeof(float);
+	else if (header.cell_type == BINARY_TABLE_FLOAT64)
+		return sizeof(double);
+	else if ((header.cell_type == BINARY_TABLE_COUNTS16) && (header.nr_surrogates > 0))
+		return sizeof(uint16_t);
+	else if (header.cell_type == BINARY_TABLE_COUNTS32)
+		return sizeof(uint32_t);
+
+	return 0;
+}
+
+int netOnZeroDXC_parse_binary_table (std::vector < std::vector <double> > & data_table, const char * data, size_t size)
+{
+	data_table.clear();
+
+	BinaryTableHeader	header;
+	if (size < sizeof(BinaryTableHeader))
+		return 1;
+	memcpy(&header, data, sizeof(BinaryTableHeader));
+	if (!netOnZeroDXC_check_binary_magic(header.magic, sizeof(header.magic)) || (header.version != BINARY_TABLE_VERSION))
+		return 1;	// Also rejects files written on a host with different byte order
+
+	size_t	cell_size = netOnZeroDXC_binary_cell_size(header);
+	if (cell_size == 0)
+		return 1;
+	if (size < sizeof(BinaryTableHeader) + ((size_t) header.rows) * header.cols * cell_size)
+		return 1;
+
+	const char *	cells = data + sizeof(BinaryTableHeader);
+	double		M = (double) header.nr_surrogates;
+	float		value_float;
+	uint16_t	value_count;
+	uint32_t	value_count32;
+	size_t		i, j;
+	std::vector <double>	temp_row(header.cols, 0.0);
+	for (i = 0; i < header.rows; i++) {
+		for (j = 0; j < header.cols; j++) {
+			if (header.cell_type == BINARY_TABLE_FLOAT32) {
+				memcpy(&value_float, cells, sizeof(float));
+				temp_row[j] = (double) value_float;
+			} else if (header.cell_type == BINARY_TABLE_FLOAT64) {
+				memcpy(&temp_row[j], cells, sizeof(double));
+			} else if (header.cell_type == BINARY_TABLE_COUNTS32) {
+				memcpy(&value_count32, cells, sizeof(uint32_t));
+				temp_row[j] = (double) value_count32;
+			} else {
+				memcpy(&value_count, cells, sizeof(uint16_t));
+				if (value_count == BINARY_TABLE_NAN_COUNT)
+					temp_row[j] = std::numeric_limits<double>::quiet_NaN();
+				else
+					temp_row[j] = ((double) value_count) / M;
+			}
+			cells += cell_size;
+		}
+		data_table.push_back(temp_row);
+	}
+
+	return 0;
+}
+
 int netOnZeroDXC_parse_line (std::vector <double> & data_line, std::string & text_line, char separator)
 {
 	size_t	found = text_line.find_first_of(separator);
@@ -173,7 +288,6 @@ int netOnZeroDXC_load_single_file (std::vector < std::vector <double> > & data_t
 		return 3;
 
 	int	i, j;
-	char	temp_label[16];
 	std::vector <double>	temp_sequence;
 	for (i = 0; i < temp_table[0].size(); i++) {
 		temp_sequence.clear();
@@ -181,6 +295,20 @@ int netOnZeroDXC_load_single_file (std::vector < std::vector <double> > & data_t
 			temp_sequence.push_back(temp_table[j][i]);
 		}
 		data_table.push_back(temp_sequence);
+	}
+	netOnZeroDXC_generate_node_labels(node_labels, temp_table[0].size());
+
+	if (data_table.size() < 2)
+		return 5;
+
+	return 0;
+}
+
+int netOnZeroDXC_generate_node_labels (std::vector <std::string> & node_labels, int nr_nodes)
+{
+	int	i;
+	char	temp_label[16];
+	for (i = 0; i < nr_nodes; i++) {
 		if ((i+1) < 10) {
 			sprintf(temp_label, "00%d", i + 1);
 		} else if ((i+1) < 100) {
@@ -192,9 +320,6 @@ int netOnZeroDXC_load_single_file (std::vector < std::vector <double> > & data_t
 		node_labels.push_back(label_string);
 	}
 
-	if (data_table.size() < 2)
-		return 5;
-
 	return 0;
 }
 
@@ -202,17 +327,25 @@ int netOnZeroDXC_load_stdin (std::vector < std::vector <double> > & data_table,
 {
 	data_table.clear();
 
+#ifdef _WIN32
+	_setmode(_fileno(stdin), _O_BINARY);
+#endif
+	std::string	content((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+	if (netOnZeroDXC_check_binary_magic(content.data(), content.size()))
+		return netOnZeroDXC_parse_binary_table(data_table, content.data(), content.size());
+
+	std::istringstream	content_stream(content);
 	char *buffered_line = new char[16384];
 	std::string	line;
 	std::vector <double>	temp_vector;
-	while(std::cin.getline(buffered_line, 16384)) {
+	while(content_stream.getline(buffered_line, 16384)) {
 		line = buffered_line;
 		if ((line.size()) && (line[0] != '#')) {
 			netOnZeroDXC_parse_line(temp_vector, line, separator_char);
 			data_table.push_back(temp_vector);
 		}
 	}
-	delete	buffered_line;
+	delete[]	buffered_line;
 
 	return 0;
 }
@@ -574,6 +707,41 @@ int netOnZeroDXC_associate_index_of_pair (const std::vector <PairOfLabels> & nod
 	return -1;
 }
 
+int netOnZeroDXC_fill_pair_index_table (std::vector < std::vector <int> > & pair_indices, const std::vector <PairOfLabels> & node_pairs, const std::vector <std::string> & node_labels)
+{
+	int	N = node_labels.size();
+	int	i, a, b;
+
+	std::map <std::string, int>	label_index;
+	for (i = N - 1; i >= 0; i--)
+		label_index[node_labels[i]] = i;
+
+	pair_indices.assign(N, std::vector <int> (N, -1));
+	std::map <std::string, int>::const_iterator	found_a, found_b;
+	for (i = 0; i < node_pairs.size(); i++) {
+		found_a = label_index.find(node_pairs[i].label_a);
+		found_b = label_index.find(node_pairs[i].label_b);
+		if ((found_a == label_index.end()) || (found_b == label_index.end()))
+			continue;
+		a = found_a->second;
+		b = found_b->second;
+		if (pair_indices[a][b] < 0) {			// As in netOnZeroDXC_associate_index_of_pair, the first matching pair wins
+			pair_indices[a][b] = i;
+			pair_indices[b][a] = i;
+		}
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_triangular_index_of_pair (int a, int b, int N)
+{
+	if (a > b)
+		std::swap(a, b);
+
+	return (int) ((long long) a * N - ((long long) a * (a + 1)) / 2 + (b - a - 1));
+}
+
 int netOnZeroDXC_check_new_label_pairs (std::vector <PairOfLabels> & temp_label_pairs, const std::vector <PairOfLabels> & already_known)
 {
 	int	i, j;
@@ -603,16 +771,13 @@ int netOnZeroDXC_save_diagram (const std::vector < std::vector <double> > & diag
 	if (!file_pointer)
 		return 1;
 
-	int	i, j;
-	for (i = 0; i < diagram.size(); i++) {
-		fprintf(file_pointer, "%.3f", diagram[i][0]);
-		for (j = 1; j < diagram[i].size(); j++) {
-			fprintf(file_pointer, "%c%.3f", separator, diagram[i][j]);
-		}
-		fprintf(file_pointer, "\n");
+	int	error;
+	{
+		TextTableWriter	text_writer(file_pointer, TEXT_FORMAT_FIXED, TEXT_FILE_PRECISION);
+		error = text_writer.putTable(diagram, separator);
 	}
 
-	if(fclose(file_pointer) == EOF)
+	if ((fclose(file_pointer) == EOF) || error)
 		return 1;
 
 	return 0;
@@ -632,38 +797,153 @@ int netOnZeroDXC_save_linear_data (const std::vector <double> & x, const std::ve
 	if (!file_pointer)
 		return 1;
 
-	int	i, j;
-	for (i = 0; i < x.size(); i++)
-		fprintf(file_pointer, "%.3f\t%.3f\n", x[i], y[i]);
+	int	i, error;
+	{
+		TextTableWriter	text_writer(file_pointer, TEXT_FORMAT_FIXED, TEXT_FILE_PRECISION);
+		for (i = 0; i < x.size(); i++) {
+			text_writer.putValue(x[i]);
+			text_writer.putChar('\t');
+			text_writer.putValue(y[i]);
+			text_writer.putChar('\n');
+		}
+		error = text_writer.flush();
+	}
 
-	if(fclose(file_pointer) == EOF)
+	if ((fclose(file_pointer) == EOF) || error)
 		return 1;
 
 	return 0;
 }
 
 int netOnZeroDXC_save_single_file (const std::vector < std::vector <double> > & data_table, std::string file_name, char separator)
+{
+	return netOnZeroDXC_save_single_file_text(data_table, file_name, separator, TEXT_FORMAT_FIXED, TEXT_FILE_PRECISION);
+}
+
+int netOnZeroDXC_save_single_file_text (const std::vector < std::vector <double> > & data_table, std::string file_name, char separator, int format, int precision)
 {
 	FILE *	file_pointer;
-	file_pointer = fopen(file_name.c_str(), "w");
+	if (file_name.size())
+		file_pointer = fopen(file_name.c_str(), "w");
+	else						// Empty file name means standard output
+		file_pointer = stdout;
 	if (!file_pointer)
 		return 1;
 
-	int	i, j;
+	int	error;
+	{
+		TextTableWriter	text_writer(file_pointer, format, precision);
+		error = text_writer.putTable(data_table, separator);
+	}
+
+	if (file_pointer == stdout)
+		return error;
+	if ((fclose(file_pointer) == EOF) || error)
+		return 1;
+
+	return 0;
+}
+
+int netOnZeroDXC_write_binary_table (const std::vector < std::vector <double> > & data_table, FILE * file_pointer, int cell_type, int nr_surrogates)
+{
+	BinaryTableHeader	header;
+	memcpy(header.magic, BINARY_TABLE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_TABLE_VERSION;
+	header.rows = data_table.size();
+	header.cols = (data_table.size())? data_table[0].size() : 0;
+	header.reserved = 0;
+	if ((cell_type == BINARY_TABLE_COUNTS16) && (nr_surrogates > 0) && (nr_surrogates <= BINARY_TABLE_MAX_SURROGATES)) {
+		header.cell_type = BINARY_TABLE_COUNTS16;
+		header.nr_surrogates = nr_surrogates;
+	} else if ((cell_type == BINARY_TABLE_FLOAT64) || (cell_type == BINARY_TABLE_COUNTS32)) {
+		header.cell_type = cell_type;
+		header.nr_surrogates = 0;
+	} else {						// No surrogates (or too many for 16 bits): plain float32 values
+		header.cell_type = BINARY_TABLE_FLOAT32;
+		header.nr_surrogates = 0;
+	}
+
+	size_t	i, j;
 	for (i = 0; i < data_table.size(); i++) {
-		fprintf(file_pointer, "%.3f", data_table[i][0]);
-		for (j = 1; j < data_table[i].size(); j++) {
-			fprintf(file_pointer, "%c%.3f", separator, data_table[i][j]);
-		}
-		fprintf(file_pointer, "\n");
+		if (data_table[i].size() != header.cols)
+			return 1;
 	}
 
-	if(fclose(file_pointer) == EOF)
+	if (fwrite(&header, sizeof(BinaryTableHeader), 1, file_pointer) != 1)
 		return 1;
 
+	if (header.cell_type == BINARY_TABLE_COUNTS16) {
+		std::vector <uint16_t>	row_buffer(header.cols);
+		for (i = 0; i < header.rows; i++) {
+			for (j = 0; j < header.cols; j++) {
+				if (data_table[i][j] != data_table[i][j])
+					row_buffer[j] = BINARY_TABLE_NAN_COUNT;
+				else
+					row_buffer[j] = (uint16_t) lround(data_table[i][j] * (double) nr_surrogates);
+			}
+			if (fwrite(row_buffer.data(), sizeof(uint16_t), header.cols, file_pointer) != header.cols)
+				return 1;
+		}
+	} else if (header.cell_type == BINARY_TABLE_FLOAT64) {
+		for (i = 0; i < header.rows; i++) {
+			if (fwrite(data_table[i].data(), sizeof(double), header.cols, file_pointer) != header.cols)
+				return 1;
+		}
+	} else if (header.cell_type == BINARY_TABLE_COUNTS32) {
+		std::vector <uint32_t>	row_buffer(header.cols);
+		for (i = 0; i < header.rows; i++) {
+			for (j = 0; j < header.cols; j++)
+				row_buffer[j] = (data_table[i][j] > 0.0)? (uint32_t) data_table[i][j] : 0;
+			if (fwrite(row_buffer.data(), sizeof(uint32_t), header.cols, file_pointer) != header.cols)
+				return 1;
+		}
+	} else {
+		std::vector <float>	row_buffer(header.cols);
+		for (i = 0; i < header.rows; i++) {
+			for (j = 0; j < header.cols; j++)
+				row_buffer[j] = (float) data_table[i][j];
+			if (fwrite(row_buffer.data(), sizeof(float), header.cols, file_pointer) != header.cols)
+				return 1;
+		}
+	}
+
 	return 0;
 }
 
+int netOnZeroDXC_save_diagram_binary (const std::vector < std::vector <double> > & diagram, std::string path, std::string prefix, std::string label,
+			char delimiter, std::string label_a, std::string label_b, int cell_type, int nr_surrogates)
+{
+	std::string	filename = netOnZeroDXC_generate_filepath(path, prefix, label, delimiter, label_a, label_b);
+
+	return netOnZeroDXC_save_single_file_binary(diagram, filename, cell_type, nr_surrogates);
+}
+
+int netOnZeroDXC_save_single_file_binary (const std::vector < std::vector <double> > & data_table, std::string file_name, int cell_type, int nr_surrogates)
+{
+	FILE *	file_pointer;
+	if (file_name.size()) {
+		file_pointer = fopen(file_name.c_str(), "wb");
+	} else {						// Empty file name means standard output
+#ifdef _WIN32
+		_setmode(_fileno(stdout), _O_BINARY);
+#endif
+		file_pointer = stdout;
+	}
+	if (!file_pointer)
+		return 1;
+
+	int	error = netOnZeroDXC_write_binary_table(data_table, file_pointer, cell_type, nr_surrogates);
+
+	if (file_pointer == stdout) {
+		if (fflush(file_pointer) == EOF)
+			return 1;
+	} else if (fclose(file_pointer) == EOF) {
+		return 1;
+	}
+
+	return error;
+}
+
 int netOnZeroDXC_save_log_file (const std::stringstream & content, std::string file_name)
 {
 	FILE *		file_pointer;
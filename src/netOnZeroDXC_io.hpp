@@ -28,19 +28,46 @@
 //
 // --------------------------------------------------------------------------
 
+#include <cstdio>
+#include <stdint.h>
+
 #ifndef INCLUDED_PAIR
 	#include "netOnZeroDXC_pair.hpp"
 	#define INCLUDED_PAIR
 #endif
 
+struct BinaryTableHeader {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	cell_type;
+	uint32_t	rows;
+	uint32_t	cols;
+	uint32_t	nr_surrogates;
+	uint32_t	reserved;
+};
+
+#define BINARY_TABLE_MAGIC		"NZDXCBIN"
+#define BINARY_TABLE_VERSION		1
+#define BINARY_TABLE_FLOAT32		0	// Cells stored as float32 (correlation diagrams, F-test p values, matrices)
+#define BINARY_TABLE_COUNTS16		1	// Cells stored as uint16 exceedance counts, p = count / M
+#define BINARY_TABLE_FLOAT64		2	// Cells stored as float64 (efficiencies, whose window widths must be compared exactly)
+#define BINARY_TABLE_COUNTS32		3	// Cells stored as uint32 counts (histograms of the pooled null)
+#define BINARY_TABLE_NAN_COUNT		0xFFFF
+#define BINARY_TABLE_MAX_SURROGATES	65534
+
 int netOnZeroDXC_load_single_file (std::vector < std::vector <double> > &, std::vector <std::string> &, std::string, char);
 int netOnZeroDXC_load_single_matrix (std::vector < std::vector <double> > &, std::string, char);
 int netOnZeroDXC_load_labels_dictionary (std::vector <std::string> &, std::string, char);
+int netOnZeroDXC_generate_node_labels (std::vector <std::string> &, int);
 int netOnZeroDXC_load_stdin (std::vector < std::vector <double> > &, char);
 int netOnZeroDXC_load_single_table (std::vector < std::vector <double> > &, std::string, char);
 
 int netOnZeroDXC_read_dictionary (std::vector <std::string> &, std::string, char);
 int netOnZeroDXC_read_data_table (std::vector < std::vector <double> > &, std::string, char);
+int netOnZeroDXC_read_binary_table (std::vector < std::vector <double> > &, std::string);
+int netOnZeroDXC_parse_binary_table (std::vector < std::vector <double> > &, const char *, size_t);
+bool netOnZeroDXC_check_binary_magic (const char *, size_t);
+size_t netOnZeroDXC_binary_cell_size (const BinaryTableHeader &);
 int netOnZeroDXC_parse_line (std::vector <double> &, std::string &, char);
 int netOnZeroDXC_parse_dictionary_line (std::string &, int &, std::string &, char);
 int netOnZeroDXC_parse_configuration_line (std::string &, std::string &, bool &, std::string &, std::string &, char);
@@ -58,10 +85,16 @@ int netOnZeroDXC_check_label_format (const std::string &);
 int netOnZeroDXC_fill_list_pairs(std::vector <PairOfLabels> &, const std::vector <std::string> &);
 int netOnZeroDXC_postfill_list_labels(std::vector <std::string> &, const std::vector <PairOfLabels> &);
 int netOnZeroDXC_associate_index_of_pair(const std::vector <PairOfLabels> &, const std::vector <std::string> &, int, int);
+int netOnZeroDXC_fill_pair_index_table(std::vector < std::vector <int> > &, const std::vector <PairOfLabels> &, const std::vector <std::string> &);
+int netOnZeroDXC_triangular_index_of_pair(int, int, int);
 int netOnZeroDXC_check_new_label_pairs(std::vector <PairOfLabels> &, const std::vector <PairOfLabels> &);
 
 std::string netOnZeroDXC_generate_filepath(std::string, std::string, std::string, char, std::string, std::string);
 int netOnZeroDXC_save_diagram(const std::vector < std::vector <double> > &, std::string, std::string, std::string, char, std::string, std::string, char);
 int netOnZeroDXC_save_linear_data(const std::vector <double> &, const std::vector <double> &, std::string, std::string, std::string, char, std::string, std::string, char);
 int netOnZeroDXC_save_single_file(const std::vector < std::vector <double> > &, std::string, char);
+int netOnZeroDXC_save_single_file_text(const std::vector < std::vector <double> > &, std::string, char, int, int);
+int netOnZeroDXC_save_diagram_binary(const std::vector < std::vector <double> > &, std::string, std::string, std::string, char, std::string, std::string, int, int);
+int netOnZeroDXC_save_single_file_binary(const std::vector < std::vector <double> > &, std::string, int, int);
+int netOnZeroDXC_write_binary_table(const std::vector < std::vector <double> > &, FILE *, int, int);
 int netOnZeroDXC_save_log_file(const std::stringstream &, std::string);
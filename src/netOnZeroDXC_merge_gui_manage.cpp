@@ -150,6 +150,8 @@ void GuiFrame::validatePreprocessData (wxCommandEvent& WXUNUSED(event))
 		int	s, r, eta_index;
 		std::vector <double>	temp_row(data_container->number_of_nodes, -1.0);
 		std::vector < std::vector <double> >	temp_matrix;
+		std::vector < std::vector <int> >	pair_indices;
+		netOnZeroDXC_fill_pair_index_table(pair_indices, data_container->node_pairs, data_container->node_labels);
 		for (s = 0; s < data_container->number_of_systems; s++) {
 			for (r = 0; r < data_container->number_of_recordings; r++) {
 				for (eta_index = 0; eta_index <= 100; eta_index++) {
@@ -158,9 +160,12 @@ void GuiFrame::validatePreprocessData (wxCommandEvent& WXUNUSED(event))
 					for (i = 0; i < data_container->number_of_nodes - 1; i++) {
 						temp_matrix[i][i] = 0.0;
 						for (j = i + 1; j < data_container->number_of_nodes; j++) {
-							k = netOnZeroDXC_associate_index_of_pair(data_container->node_pairs, data_container->node_labels, i, j);
-							temp_matrix[i][j] = netOnZeroDXC_compute_wmatrix_element(data_container->systems_stored[s].recordings_stored[r].efficiencies[k],
-														data_container->window_widths, ((double) eta_index) / 100.0);
+							k = pair_indices[i][j];
+							if (k < 0)
+								temp_matrix[i][j] = std::numeric_limits<double>::quiet_NaN();
+							else
+								temp_matrix[i][j] = netOnZeroDXC_compute_wmatrix_element(data_container->systems_stored[s].recordings_stored[r].efficiencies[k],
+															data_container->window_widths, ((double) eta_index) / 100.0);
 							if (temp_matrix[i][j] != temp_matrix[i][j])
 								temp_matrix[j][i] = std::numeric_limits<double>::quiet_NaN();
 							else
@@ -43,6 +43,10 @@
 	#include "netOnZeroDXC_io.hpp"
 	#define INCLUDED_IOFUNCTIONS
 #endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
 #ifndef INCLUDED_IOFUNCTIONS_WX
 	#include "netOnZeroDXC_gui_io.hpp"
 	#define INCLUDED_IOFUNCTIONS_WX
@@ -533,28 +537,32 @@ int GuiFrame::loadConfiguredRecording (ObservedRecording & recording, std::vecto
 		}
 	} else {
 		std::string		selected_file_name = file_fullpath.str();
-		std::ifstream		selected_file_stream;
-		selected_file_stream.open(selected_file_name.c_str(), std::ifstream::in);
-		if (selected_file_stream.fail()) {
-			sstm << "Error in opening efficiencies list " << selected_file_name << "\nCannot load anything.";
-			wxMessageBox(sstm.str(), "Error!", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
-			return 1;
-		}
-		wxArrayString	list_of_files;
-		std::string	line;
-		char	*buffered_line = new char[256];
-		while(selected_file_stream.getline(buffered_line, 256)) {
-			std::stringstream	temp_file_path;
-			std::string		line = buffered_line;
-			if (line.size()) {
-				temp_file_path << folder_name;
-				if ((folder_name.find_last_of(directory_char) != folder_name.size()) && (line.find_first_of(directory_char) != 0))
-					temp_file_path << directory_char;
-				temp_file_path << line;
+		wxArrayString		list_of_files;
+		if (netOnZeroDXC_check_archive(selected_file_name)) {		// The recording is a whole archive, rather than a list of efficiency files
+			list_of_files.Add(selected_file_name);
+		} else {
+			std::ifstream		selected_file_stream;
+			selected_file_stream.open(selected_file_name.c_str(), std::ifstream::in);
+			if (selected_file_stream.fail()) {
+				sstm << "Error in opening efficiencies list " << selected_file_name << "\nCannot load anything.";
+				wxMessageBox(sstm.str(), "Error!", wxOK | wxICON_ERROR, NULL, wxDefaultCoord, wxDefaultCoord);
+				return 1;
+			}
+			std::string	line;
+			char	*buffered_line = new char[256];
+			while(selected_file_stream.getline(buffered_line, 256)) {
+				std::stringstream	temp_file_path;
+				std::string		line = buffered_line;
+				if (line.size()) {
+					temp_file_path << folder_name;
+					if ((folder_name.find_last_of(directory_char) != folder_name.size()) && (line.find_first_of(directory_char) != 0))
+						temp_file_path << directory_char;
+					temp_file_path << line;
+				}
+				list_of_files.Add(temp_file_path.str());
 			}
-			list_of_files.Add(temp_file_path.str());
+			delete buffered_line;
 		}
-		delete buffered_line;
 		loading_error = netOnZeroDXC_load_multi_efficiencies(recording.efficiencies, label_pairs, recording.window_widths, list_of_files, separator, filename_delimiter);
 		switch (loading_error) {
 			case 1:
@@ -0,0 +1,547 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "omp.h"
+
+#ifndef INCLUDED_PIPELINE
+	#include "netOnZeroDXC_pipeline_main.hpp"
+	#define INCLUDED_PIPELINE
+#endif
+
+void netOnZeroDXC_pipeline_help (char *);
+int netOnZeroDXC_pipeline_parse_options (int, char **, std::string &, std::string &, std::string &, std::string &, std::string &, std::string &, std::string &, int &, bool &, bool &);
+int netOnZeroDXC_pipeline_parse_bool (bool &, const std::string &);
+int netOnZeroDXC_pipeline_parse_int (int &, const std::string &);
+int netOnZeroDXC_pipeline_parse_double (double &, const std::string &);
+int netOnZeroDXC_pipeline_parse_shard (int &, int &, const std::string &);
+
+int main(int argc, char *argv[]) {
+
+	bool		verbose = false;
+	bool		resume = false;
+	std::string	selected_parameter_filename;
+	std::string	selected_input_filename;
+	std::string	selected_output_folder;
+	std::string	selected_output_prefix;
+	std::string	selected_separator;
+	std::string	selected_delimiter;
+	std::string	selected_shard;
+	int		merge_nr_shards = 0;
+
+	int	error;
+	error = netOnZeroDXC_pipeline_parse_options(argc, argv, selected_parameter_filename, selected_input_filename, selected_output_folder,
+							selected_output_prefix, selected_separator, selected_delimiter, selected_shard, merge_nr_shards, resume, verbose);
+	if (error)
+		exit(1);
+
+	ContainerPipeline	pipeline;
+	if (selected_parameter_filename.size()) {
+		error = pipeline.readParameterFile(selected_parameter_filename);
+		if (error)
+			exit(1);
+	}
+	if (selected_input_filename.size())			// Command line settings override the parameter file
+		pipeline.path_input_file = selected_input_filename;
+	if (selected_output_folder.size())
+		pipeline.path_output_folder = selected_output_folder;
+	if (selected_output_prefix.size())
+		pipeline.path_output_prefix = selected_output_prefix;
+	if (selected_separator.size())
+		pipeline.path_separator_char = selected_separator[0];
+	if (selected_delimiter.size())
+		pipeline.path_filename_delimiter = selected_delimiter[0];
+	if (verbose)
+		pipeline.parameter_verbose = true;
+	if (resume)
+		pipeline.parameter_resume = true;
+	if (selected_shard.size() && netOnZeroDXC_pipeline_parse_shard(pipeline.parameter_shard_index, pipeline.parameter_nr_shards, selected_shard)) {
+		std::cerr << "ERROR: shard must be set as i/n, with 0 <= i < n. Use " << argv[0] << " -h for a list of options.\n";
+		exit(1);
+	}
+	if (pipeline.path_separator_char == 's')
+		pipeline.path_separator_char = ' ';
+	else if (pipeline.path_separator_char == 'c')
+		pipeline.path_separator_char = ',';
+	else if (pipeline.path_separator_char == 't')
+		pipeline.path_separator_char = '\t';
+
+	if (!pipeline.path_output_folder.size()) {
+		std::cerr << "ERROR: no output folder was set. Use " << argv[0] << " -h for a list of options.\n";
+		exit(1);
+	}
+	if (merge_nr_shards > 0) {
+		error = netOnZeroDXC_pipeline_merge(pipeline, merge_nr_shards);
+		if (error)
+			exit(1);
+		return 0;
+	}
+
+	if (!pipeline.path_input_file.size()) {
+		std::cerr << "ERROR: no input file was set. Use " << argv[0] << " -h for a list of options.\n";
+		exit(1);
+	}
+
+	error = netOnZeroDXC_pipeline_load_sequences(pipeline);
+	if (error)
+		exit(1);
+
+	error = pipeline.validateParameterTable();
+	if (error)
+		exit(1);
+
+	error = netOnZeroDXC_pipeline_run(pipeline);
+	if (error)
+		exit(1);
+
+	return 0;
+}
+
+ContainerPipeline::ContainerPipeline ()
+{
+	clearWorkspace();
+}
+
+void ContainerPipeline::clearWorkspace ()
+{
+	parameter_computation_target = 3;
+	parameter_basewidth = 20;
+	parameter_nr_windowwidths = 100;
+	parameter_nr_surrogates = 1000;
+	parameter_shift_value = 1;
+	parameter_samplingperiod = 1.0;
+	parameter_thr_significance = 0.01;
+	parameter_thr_efficiency = 0.5;
+	parameter_screening_band = 0.0;
+	parameter_pvalue_by_surrogate = true;
+	parameter_autocorrelation_correction = false;
+	parameter_parametric_null = false;
+	parameter_pooled_null = false;
+	parameter_single_precision = false;
+	parameter_use_shift = false;
+	parameter_overlapping_windows = false;
+	parameter_print_cdiagrams = false;
+	parameter_print_pdiagrams = false;
+	parameter_print_efficiencies = false;
+	parameter_print_wholeseq_xcorr = false;
+	parameter_print_sweeps = false;
+	parameter_print_binary = false;
+	parameter_print_archive = false;
+	parameter_use_parallel = false;
+	parameter_numthreads = 1;
+	parameter_verbose = false;
+	parameter_shard_index = 0;
+	parameter_nr_shards = 1;
+	parameter_seed = 0;
+	parameter_checkpoint_rounds = 0;
+	parameter_resume = false;
+
+	sequences.clear();
+	diagrams_correlation.clear();
+	diagrams_pvalue.clear();
+	diagrams_count.clear();
+	diagrams_null_moments.clear();
+	diagrams_null_histograms.clear();
+	efficiencies.clear();
+	window_widths.clear();
+	node_labels.clear();
+	node_valid.clear();
+	node_pairs.clear();
+	node_pairs_index_a.clear();
+	node_pairs_index_b.clear();
+	node_pairs_valid.clear();
+	node_pairs_first = 0;
+	node_pairs_total = 0;
+	wholeseq_xcorr.clear();
+	wholeseq_pvalue.clear();
+	timescale_matrix.clear();
+	efficiencies_multialpha.clear();
+	surrogate_seed = 0;
+
+	path_separator_char = '\t';
+	path_filename_delimiter = '_';
+	path_input_file.clear();
+	path_output_folder.clear();
+	path_output_prefix.clear();
+}
+
+int ContainerPipeline::readParameterFile (std::string file_name)
+{
+	std::ifstream	parameter_file_stream;
+	parameter_file_stream.open(file_name.c_str(), std::ifstream::in);
+	if (parameter_file_stream.fail()) {
+		std::cerr << "ERROR: cannot read the parameter file '" << file_name << "'.\n";
+		return 1;
+	}
+
+	std::string	line, name, value;
+	size_t		found;
+	int		line_number = 0;
+	int		error;
+	while (std::getline(parameter_file_stream, line)) {
+		line_number++;
+		found = line.find_first_of('#');
+		if (found != std::string::npos)
+			line.erase(found);
+		found = line.find_first_of('=');
+		if (found != std::string::npos)
+			line[found] = ' ';
+		std::istringstream	line_stream(line);
+		if (!(line_stream >> name))
+			continue;
+		std::getline(line_stream >> std::ws, value);
+		found = value.find_last_not_of(" \t\r");
+		value.erase((found == std::string::npos)? 0 : found + 1);
+
+		error = 0;
+		if (name == "computation_target")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_computation_target, value);
+		else if (name == "samplingperiod")
+			error = netOnZeroDXC_pipeline_parse_double(parameter_samplingperiod, value);
+		else if (name == "basewidth")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_basewidth, value);
+		else if (name == "nr_windowwidths")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_nr_windowwidths, value);
+		else if (name == "nr_surrogates")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_nr_surrogates, value);
+		else if (name == "thr_significance")
+			error = netOnZeroDXC_pipeline_parse_double(parameter_thr_significance, value);
+		else if (name == "thr_efficiency")
+			error = netOnZeroDXC_pipeline_parse_double(parameter_thr_efficiency, value);
+		else if (name == "screening_band")
+			error = netOnZeroDXC_pipeline_parse_double(parameter_screening_band, value);
+		else if (name == "pvalue_by_surrogate")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_pvalue_by_surrogate, value);
+		else if (name == "autocorrelation_correction")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_autocorrelation_correction, value);
+		else if (name == "parametric_null")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_parametric_null, value);
+		else if (name == "pooled_null")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_pooled_null, value);
+		else if (name == "single_precision")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_single_precision, value);
+		else if (name == "use_shift")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_use_shift, value);
+		else if (name == "shift_value")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_shift_value, value);
+		else if (name == "overlapping_windows")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_overlapping_windows, value);
+		else if (name == "print_cdiagrams")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_cdiagrams, value);
+		else if (name == "print_pdiagrams")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_pdiagrams, value);
+		else if (name == "print_efficiencies")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_efficiencies, value);
+		else if (name == "print_wholeseq_xcorr")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_wholeseq_xcorr, value);
+		else if (name == "print_sweeps")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_sweeps, value);
+		else if (name == "print_binary")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_binary, value);
+		else if (name == "print_archive")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_print_archive, value);
+		else if (name == "use_parallel")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_use_parallel, value);
+		else if (name == "numthreads")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_numthreads, value);
+		else if (name == "verbose")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_verbose, value);
+		else if (name == "shard")
+			error = netOnZeroDXC_pipeline_parse_shard(parameter_shard_index, parameter_nr_shards, value);
+		else if (name == "seed")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_seed, value);
+		else if (name == "checkpoint_rounds")
+			error = netOnZeroDXC_pipeline_parse_int(parameter_checkpoint_rounds, value);
+		else if (name == "resume")
+			error = netOnZeroDXC_pipeline_parse_bool(parameter_resume, value);
+		else if (name == "input_file")
+			path_input_file = value;
+		else if (name == "output_folder")
+			path_output_folder = value;
+		else if (name == "output_prefix")
+			path_output_prefix = value;
+		else if ((name == "separator") && (value.size() == 1))
+			path_separator_char = value[0];
+		else if ((name == "filename_delimiter") && (value.size() == 1))
+			path_filename_delimiter = value[0];
+		else
+			error = 2;
+
+		if (error == 2) {
+			std::cerr << "ERROR: unknown parameter '" << name << "' at line " << line_number << " of the parameter file.\n";
+			return 2;
+		} else if (error) {
+			std::cerr << "ERROR: invalid value for parameter '" << name << "' at line " << line_number << " of the parameter file.\n";
+			return 2;
+		}
+	}
+	parameter_file_stream.close();
+
+	return 0;
+}
+
+int ContainerPipeline::validateParameterTable ()
+{
+	if ((parameter_computation_target < 0) || (parameter_computation_target > 5)) {
+		std::cerr << "ERROR: computation target must be between 0 and 5.\n";
+		return 1;
+	}
+	if (parameter_computation_target < 4) {
+		if ((parameter_samplingperiod <= 0) || (parameter_basewidth <= 0) || (parameter_nr_windowwidths <= 0)) {
+			std::cerr << "ERROR: sampling period, base width and number of window widths must be positive.\n";
+			return 1;
+		}
+		if ((parameter_basewidth % 2 ) != 0) {
+			parameter_basewidth = parameter_basewidth - 1;
+			std::cerr << "WARNING: window base width was an odd number; it is now reduced to " << parameter_basewidth << ".\n";
+		}
+		if (parameter_basewidth * parameter_nr_windowwidths + ((parameter_use_shift)? parameter_shift_value : 0) >= sequences.length()) {
+			std::cerr << "ERROR: too large / too many windows: window settings and sequences length are incompatible.\n";
+			return 2;
+		}
+	}
+	if (parameter_pvalue_by_surrogate && (parameter_computation_target != 0) && (parameter_computation_target != 4) && (parameter_nr_surrogates <= 0)) {
+		std::cerr << "ERROR: number of surrogates must be positive.\n";
+		return 1;
+	}
+	if ((parameter_screening_band != 0.0) && (!(parameter_screening_band >= 1.0))) {
+		std::cerr << "ERROR: the screening band must be 0 (no screening) or at least 1.\n";
+		return 1;
+	}
+	if ((parameter_parametric_null || parameter_pooled_null) && (parameter_screening_band != 0.0)) {
+		std::cerr << "ERROR: a parametric or pooled null needs the surrogates of all cells: screening_band must be 0.\n";
+		return 1;
+	}
+	if (parameter_parametric_null && parameter_pooled_null) {
+		std::cerr << "ERROR: choose either a parametric or a pooled null.\n";
+		return 1;
+	}
+	if ((parameter_nr_shards > 1) && (parameter_computation_target >= 4)) {
+		std::cerr << "ERROR: whole-sequences targets cannot be split in shards.\n";
+		return 1;
+	}
+	if ((parameter_seed < 0) || (parameter_checkpoint_rounds < 0)) {
+		std::cerr << "ERROR: seed and checkpoint_rounds cannot be negative.\n";
+		return 1;
+	}
+	if (parameter_use_shift && (parameter_shift_value <= 0)) {
+		std::cerr << "ERROR: the delay tau must be positive.\n";
+		return 1;
+	}
+
+	if (path_output_prefix.size()) {
+		if (path_output_prefix.find_first_of(" ") != std::string::npos) {
+			std::cerr << "ERROR: bad file names: prefix of file names should not contain spaces.\n";
+			return 3;
+		}
+	}
+
+	if (parameter_use_parallel && (parameter_numthreads > omp_get_max_threads())) {
+		std::cerr << "WARNING: too many requested threads (" << parameter_numthreads << "); using the maximum number of threads (" << omp_get_max_threads() << ").\n";
+		parameter_numthreads = omp_get_max_threads();
+	}
+	if (parameter_use_parallel && (parameter_numthreads < 1))
+		parameter_numthreads = 1;
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_parse_bool (bool & target, const std::string & value)
+{
+	if ((value == "1") || (value == "true") || (value == "yes")) {
+		target = true;
+	} else if ((value == "0") || (value == "false") || (value == "no")) {
+		target = false;
+	} else {
+		return 1;
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_parse_int (int & target, const std::string & value)
+{
+	char *	end_pointer;
+	long	temp_value = strtol(value.c_str(), &end_pointer, 10);
+	if ((!value.size()) || (*end_pointer != '\0'))
+		return 1;
+	target = (int) temp_value;
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_parse_double (double & target, const std::string & value)
+{
+	char *	end_pointer;
+	double	temp_value = strtod(value.c_str(), &end_pointer);
+	if ((!value.size()) || (*end_pointer != '\0'))
+		return 1;
+	target = temp_value;
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_parse_shard (int & shard_index, int & nr_shards, const std::string & value)
+{
+	size_t	found = value.find_first_of('/');
+	if (found == std::string::npos)
+		return 1;
+
+	int	temp_index, temp_number;
+	if (netOnZeroDXC_pipeline_parse_int(temp_index, value.substr(0, found)) || netOnZeroDXC_pipeline_parse_int(temp_number, value.substr(found + 1)))
+		return 1;
+	if ((temp_number < 1) || (temp_index < 0) || (temp_index >= temp_number))
+		return 1;
+	shard_index = temp_index;
+	nr_shards = temp_number;
+
+	return 0;
+}
+
+void netOnZeroDXC_pipeline_help (char *program_name)
+{
+	std::cerr << "Usage:\n";
+	std::cerr << "\t" << program_name << " -P <fname> (<Options>)\n";
+	std::cerr << "\nRuns the analysis of the netOnZeroDXC_analysis program without graphical interface:\n";
+	std::cerr << "sequences are loaded once, and all the stages up to the selected target are computed in memory.\n";
+
+	std::cerr << "\nOptions:\n";
+	std::cerr << "\t-P <fname>\tread analysis parameters from file 'fname' (see below);\n";
+	std::cerr << "\t-i <fname>\tread sequences from file 'fname' (one sequence per column); overrides 'input_file';\n";
+	std::cerr << "\t-o <path>\twrite output files in folder 'path'; overrides 'output_folder';\n";
+	std::cerr << "\t-prefix <str>\tprepend 'str' to output file names; overrides 'output_prefix';\n";
+	std::cerr << "\t-s <@>\t\tset column separator of the input file, default t (TAB); other options are s (space) or c (comma ',');\n";
+	std::cerr << "\t-d <@>\t\tset the file name delimiter, default '_';\n";
+	std::cerr << "\t-v\t\tprint the stage being computed on standard error;\n";
+	std::cerr << "\t-shard <i>/<n>\tcompute only the i-th of n blocks (0 <= i < n) of the pairs, numbered as in the triangular list\n";
+	std::cerr << "\t\t\t\t(1,2), (1,3), ..., (2,3), ...; overrides 'shard'. With targets 2 and 3, efficiencies are saved in\n";
+	std::cerr << "\t\t\t\tshard_<i>_<n>.dat in the output folder, and the matrix of time scales is left to -merge;\n";
+	std::cerr << "\t-merge <n>\tassemble the efficiencies of n shards found in the output folder, check that all pairs are\n";
+	std::cerr << "\t\t\t\tpresent and that all shards share the settings of the p values and efficiencies, and write the\n";
+	std::cerr << "\t\t\t\tmatrix of time scales (and efficiencies, if print_efficiencies is set).\n";
+	std::cerr << "\t\t\t\tNo input file is required.\n";
+	std::cerr << "\t-resume\t\tcontinue the p-value diagrams from the checkpoint found in the output folder, if any; overrides 'resume'.\n";
+
+	std::cerr << "\nParameter file:\n";
+	std::cerr << "\tone 'name value' (or 'name = value') pair per line; text following '#' is ignored.\n";
+	std::cerr << "\tNames match the settings of the analysis program; defaults in brackets:\n";
+	std::cerr << "\tcomputation_target\t0 correlation diagrams, 1 p-value diagrams, 2 efficiencies, 3 matrix of time scales,\n";
+	std::cerr << "\t\t\t\t4 whole-sequences cross-correlation, 5 whole-sequences p-values [3];\n";
+	std::cerr << "\tsamplingperiod [1], basewidth [20], nr_windowwidths [100], nr_surrogates [1000],\n";
+	std::cerr << "\tthr_significance [0.01], thr_efficiency [0.5], pvalue_by_surrogate [1] (0 for F-test),\n";
+	std::cerr << "\tautocorrelation_correction [0]\twith the F-test, use the effective sample size of each window width, given the\n";
+	std::cerr << "\t\t\t\tautocorrelation of both sequences (Bartlett), instead of the width,\n";
+	std::cerr << "\tscreening_band [0]\twith surrogates, test by surrogates only the cells whose F-test p value lies within a factor\n";
+	std::cerr << "\t\t\t\tscreening_band of thr_significance; the other cells keep the F-test p value. 0 tests all cells,\n";
+	std::cerr << "\tparametric_null [0]\twith surrogates, fit for each window width a normal law to the Fisher-z transformed\n";
+	std::cerr << "\t\t\t\tsurrogate coefficients of all positions, and take the p values from the fit: 50-100 surrogates\n";
+	std::cerr << "\t\t\t\tsuffice. With print_pdiagrams, the fit of each pair is written in nullfit_<a>_<b>.dat\n";
+	std::cerr << "\t\t\t\t(width, mean, deviation, skewness, excess kurtosis),\n";
+	std::cerr << "\tpooled_null [0]\twith surrogates, compare each cell with the surrogate coefficients of all positions of its\n";
+	std::cerr << "\t\t\t\twindow width, binned in a histogram, instead of the same cell alone: p values resolve\n";
+	std::cerr << "\t\t\t\tdown to about 1/(positions*nr_surrogates) instead of 1/nr_surrogates,\n";
+	std::cerr << "\tsingle_precision [0]\twith surrogates, generate and correlate surrogates in single precision; the data keep\n";
+	std::cerr << "\t\t\t\tdouble precision, and the largest error of the single-precision coefficients on the data\n";
+	std::cerr << "\t\t\t\tis reported (errors above 1e-5 are warned about),\n";
+	std::cerr << "\tuse_shift [0], shift_value [1], overlapping_windows [0] (1 to avoid overlapping windows),\n";
+	std::cerr << "\tprint_cdiagrams, print_pdiagrams, print_efficiencies, print_wholeseq_xcorr, print_binary, print_archive [0],\n";
+	std::cerr << "\tprint_sweeps [0]\t(target 3: also write the matrices for all thresholds, e.g. matrix_a010_e050.dat for alpha = 0.010 and eta = 0.50),\n";
+	std::cerr << "\tuse_parallel [0], numthreads [1], verbose [0], shard [0/1],\n";
+	std::cerr << "\tseed [0]\t\tseed of the surrogate generator; 0 draws it from the clock (it is shown with -v),\n";
+	std::cerr << "\tcheckpoint_rounds [0]\tsave the partial p-value diagrams every that many surrogates in checkpoint.dat\n";
+	std::cerr << "\t\t\t\t(checkpoint_<i>_<n>.dat for shards), replaced atomically and removed at the end; 0 disables checkpoints,\n";
+	std::cerr << "\tresume [0]\t\tcontinue from the checkpoint: results are identical to those of an uninterrupted run;\n";
+	std::cerr << "\t\t\t\ta checkpoint saved from other sequence data (told by a checksum) or settings is refused,\n";
+	std::cerr << "\tinput_file, output_folder, output_prefix, separator [t], filename_delimiter [_].\n";
+	std::cerr << "\tOutput files are named as by the analysis program; the matrix of time scales is always written.\n";
+
+	std::cerr << "\n\t-h or --help\tshow this help.\n";
+}
+
+int netOnZeroDXC_pipeline_parse_options (int argc, char *argv[], std::string & parameter_filename, std::string & input_filename, std::string & output_folder,
+					std::string & output_prefix, std::string & separator, std::string & delimiter, std::string & shard, int & merge_nr_shards, bool & resume, bool & verbose)
+{
+	int	n = 1;
+	while (n < argc) {
+		if (strcmp(argv[n], "-P") == 0) {
+			n++;
+			parameter_filename = argv[n];
+		} else if (strcmp(argv[n], "-i") == 0) {
+			n++;
+			input_filename = argv[n];
+		} else if (strcmp(argv[n], "-o") == 0) {
+			n++;
+			output_folder = argv[n];
+		} else if (strcmp(argv[n], "-prefix") == 0) {
+			n++;
+			output_prefix = argv[n];
+		} else if (strcmp(argv[n], "-s") == 0) {
+			n++;
+			separator = argv[n];
+		} else if (strcmp(argv[n], "-d") == 0) {
+			n++;
+			delimiter = argv[n];
+		} else if (strcmp(argv[n], "-v") == 0) {
+			verbose = true;
+		} else if ((strcmp(argv[n], "-resume") == 0) || (strcmp(argv[n], "--resume") == 0)) {
+			resume = true;
+		} else if ((strcmp(argv[n], "-shard") == 0) || (strcmp(argv[n], "--shard") == 0)) {
+			n++;
+			shard = argv[n];
+		} else if ((strcmp(argv[n], "-merge") == 0) || (strcmp(argv[n], "--merge") == 0)) {
+			n++;
+			merge_nr_shards = atoi(argv[n]);
+			if (merge_nr_shards < 1) {
+				std::cerr << "ERROR: the number of shards to be merged must be positive.\n";
+				return 1;
+			}
+
+		} else if ((strcmp("-h", argv[n]) == 0) || (strcmp("--help", argv[n]) == 0))  {
+			netOnZeroDXC_pipeline_help(argv[0]);
+			exit(0);
+		}
+		n++;
+	}
+
+	if (!parameter_filename.size() && !input_filename.size() && !merge_nr_shards) {
+		std::cerr << "ERROR: neither a parameter file nor an input file was set. Use " << argv[0] << " -h for a list of options.\n";
+		return 1;
+	}
+
+	return 0;
+}
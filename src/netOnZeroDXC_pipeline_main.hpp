@@ -0,0 +1,139 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#ifndef INCLUDED_PAIR
+	#include "netOnZeroDXC_pair.hpp"
+	#define INCLUDED_PAIR
+#endif
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+#ifndef INCLUDED_WRITER
+	#include "netOnZeroDXC_writer.hpp"
+	#define INCLUDED_WRITER
+#endif
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+#ifndef INCLUDED_SEQUENCESTORE
+	#include "netOnZeroDXC_sequence_store.hpp"
+	#define INCLUDED_SEQUENCESTORE
+#endif
+
+#define SHARD_INFO_SIZE 15		// Columns of the shard info table, see netOnZeroDXC_pipeline_save_shard
+
+class ContainerPipeline
+{
+public:
+	ContainerPipeline();
+	void clearWorkspace();
+	int readParameterFile(std::string);
+	int validateParameterTable();
+
+	int	parameter_computation_target;
+	int	parameter_basewidth;
+	int	parameter_nr_windowwidths;
+	int	parameter_nr_surrogates;
+	int	parameter_shift_value;
+	double	parameter_samplingperiod;
+	double	parameter_thr_significance;
+	double	parameter_thr_efficiency;
+	double	parameter_screening_band;
+	bool	parameter_pvalue_by_surrogate;
+	bool	parameter_autocorrelation_correction;
+	bool	parameter_parametric_null;
+	bool	parameter_pooled_null;
+	bool	parameter_single_precision;
+	bool	parameter_use_shift;
+	bool	parameter_overlapping_windows;
+	bool	parameter_print_cdiagrams;
+	bool	parameter_print_pdiagrams;
+	bool	parameter_print_efficiencies;
+	bool	parameter_print_wholeseq_xcorr;
+	bool	parameter_print_sweeps;
+	bool	parameter_print_binary;
+	bool	parameter_print_archive;
+
+	bool	parameter_use_parallel;
+	int	parameter_numthreads;
+	bool	parameter_verbose;
+	int	parameter_shard_index;
+	int	parameter_nr_shards;
+	int	parameter_seed;
+	int	parameter_checkpoint_rounds;
+	bool	parameter_resume;
+
+	SequenceStore						sequences;
+	DiagramSet						diagrams_correlation;
+	DiagramSet						diagrams_pvalue;
+	CountSet						diagrams_count;		// Surrogate counts, when they are all the p values are made of
+	DiagramSet						diagrams_null_moments;
+	HistogramSet						diagrams_null_histograms;
+	std::vector < std::vector <double> >			efficiencies;
+	std::vector <double>					window_widths;
+	std::vector <std::string>				node_labels;
+	std::vector <bool>					node_valid;
+	std::vector <PairOfLabels>				node_pairs;
+	std::vector <int>					node_pairs_index_a;
+	std::vector <int>					node_pairs_index_b;
+	std::vector <bool>					node_pairs_valid;
+	int							node_pairs_first;	// Triangular index of the first pair of this shard
+	int							node_pairs_total;	// Number of pairs of the whole network
+	std::vector < std::vector <double> >			wholeseq_xcorr;
+	std::vector < std::vector <double> >			wholeseq_pvalue;
+	std::vector < std::vector <double> >			timescale_matrix;
+
+	std::vector < std::vector < std::vector <double> > >	efficiencies_multialpha;
+	unsigned int						surrogate_seed;		// Seed of the first surrogate, as used by the run
+
+	char		path_separator_char;
+	char		path_filename_delimiter;
+	std::string	path_input_file;
+	std::string	path_output_folder;
+	std::string	path_output_prefix;
+};
+
+int netOnZeroDXC_pipeline_load_sequences (ContainerPipeline &);
+int netOnZeroDXC_pipeline_run (ContainerPipeline &);
+int netOnZeroDXC_pipeline_wholeseq (ContainerPipeline &);
+int netOnZeroDXC_pipeline_cdiagrams (ContainerPipeline &, AsyncWriter &, ArchiveFile &);
+int netOnZeroDXC_pipeline_pdiagrams (ContainerPipeline &, AsyncWriter &, ArchiveFile &);
+int netOnZeroDXC_pipeline_efficiencies (ContainerPipeline &, AsyncWriter &, ArchiveFile &);
+int netOnZeroDXC_pipeline_matrix (ContainerPipeline &, AsyncWriter &, ArchiveFile &);
+int netOnZeroDXC_pipeline_write_efficiencies (ContainerPipeline &, AsyncWriter &, ArchiveFile &);
+int netOnZeroDXC_pipeline_save_shard (ContainerPipeline &);
+int netOnZeroDXC_pipeline_merge (ContainerPipeline &, int);
+std::string netOnZeroDXC_pipeline_shard_filepath (const ContainerPipeline &, std::string, int, int);
+void netOnZeroDXC_pipeline_shard_range (int &, int &, int, int, int);
+int netOnZeroDXC_pipeline_save_checkpoint (const ContainerPipeline &, std::string, int);
+int netOnZeroDXC_pipeline_load_checkpoint (ContainerPipeline &, std::string, int &);
+void netOnZeroDXC_pipeline_message (const ContainerPipeline &, std::string);
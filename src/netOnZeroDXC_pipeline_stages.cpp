@@ -0,0 +1,964 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "omp.h"
+
+#ifndef INCLUDED_PIPELINE
+	#include "netOnZeroDXC_pipeline_main.hpp"
+	#define INCLUDED_PIPELINE
+#endif
+#ifndef INCLUDED_ALGORITHM
+	#include "netOnZeroDXC_algorithm.hpp"
+	#define INCLUDED_ALGORITHM
+#endif
+#ifndef INCLUDED_IOFUNCTIONS
+	#include "netOnZeroDXC_io.hpp"
+	#define INCLUDED_IOFUNCTIONS
+#endif
+#ifndef INCLUDED_CHECKPOINT
+	#include "netOnZeroDXC_checkpoint.hpp"
+	#define INCLUDED_CHECKPOINT
+#endif
+
+int netOnZeroDXC_pipeline_write_diagram (ContainerPipeline &, AsyncWriter &, ArchiveFile &, std::vector < std::vector <double> >, std::string, std::string, std::string, int, int);
+
+static bool netOnZeroDXC_pipeline_parametric (const ContainerPipeline & pipeline)
+{
+	return pipeline.parameter_pvalue_by_surrogate && pipeline.parameter_parametric_null;
+}
+
+static bool netOnZeroDXC_pipeline_pooled (const ContainerPipeline & pipeline)
+{
+	return pipeline.parameter_pvalue_by_surrogate && pipeline.parameter_pooled_null;
+}
+
+// When the matrix at the given thresholds is all the run writes, rows of a diagram past the first crossing are not needed;
+// a parametric or pooled null is built from all rows, though
+static EarlyStopping netOnZeroDXC_pipeline_early_stopping (const ContainerPipeline & pipeline)
+{
+	EarlyStopping	stopping;
+	stopping.enabled = (pipeline.parameter_computation_target == 3) && (pipeline.parameter_nr_shards <= 1) && (!netOnZeroDXC_pipeline_parametric(pipeline))
+				&& (!netOnZeroDXC_pipeline_pooled(pipeline)) && (!pipeline.parameter_print_cdiagrams)
+				&& (!pipeline.parameter_print_pdiagrams) && (!pipeline.parameter_print_efficiencies) && (!pipeline.parameter_print_sweeps);
+	stopping.threshold_alpha = (stopping.enabled)? pipeline.parameter_thr_significance : 0.0;
+	stopping.threshold_eta = (stopping.enabled)? pipeline.parameter_thr_efficiency : 0.0;
+	stopping.avoid_overlapping = (stopping.enabled)? pipeline.parameter_overlapping_windows : false;
+
+	return stopping;
+}
+
+static SurrogateScreening netOnZeroDXC_pipeline_screening (const ContainerPipeline & pipeline)
+{
+	SurrogateScreening	screening;
+	screening.enabled = pipeline.parameter_pvalue_by_surrogate && (pipeline.parameter_screening_band >= 1.0);
+	screening.lower_pvalue = (screening.enabled)? pipeline.parameter_thr_significance / pipeline.parameter_screening_band : 0.0;
+	screening.upper_pvalue = (screening.enabled)? pipeline.parameter_thr_significance * pipeline.parameter_screening_band : 0.0;
+
+	return screening;
+}
+
+// P-value diagrams made of surrogate counts alone are held as integer counts (diagrams_count); screened cells and
+// fitted or pooled nulls give p values that are not counts, held in diagrams_pvalue
+static bool netOnZeroDXC_pipeline_counted (const ContainerPipeline & pipeline)
+{
+	return pipeline.parameter_pvalue_by_surrogate && (!netOnZeroDXC_pipeline_screening(pipeline).enabled) && (!netOnZeroDXC_pipeline_parametric(pipeline))
+		&& (!netOnZeroDXC_pipeline_pooled(pipeline)) && (pipeline.parameter_nr_surrogates <= COUNT_MAX_SURROGATES);
+}
+
+int netOnZeroDXC_pipeline_load_sequences (ContainerPipeline & pipeline)
+{
+	std::vector < std::vector <double> >	loaded_sequences;
+	int	error = netOnZeroDXC_load_single_file(loaded_sequences, pipeline.node_labels, pipeline.path_input_file, pipeline.path_separator_char);
+	if (error == 2) {
+		std::cerr << "ERROR: cannot read the selected file '" << pipeline.path_input_file << "'.\n";
+		return 1;
+	} else if (error) {
+		std::cerr << "ERROR: inconsistent sequences sizes found, or only one sequence detected.\n";
+		return 1;
+	}
+	if (pipeline.sequences.assign(loaded_sequences)) {
+		std::cerr << "ERROR: not enough memory to hold the sequences.\n";
+		return 1;
+	}
+	pipeline.node_valid = pipeline.sequences.validity();
+
+	int	i, j;
+
+	int		N = pipeline.node_labels.size();
+	int		first_pair, last_pair, k = 0;
+	PairOfLabels	temp_pair;
+	pipeline.node_pairs_total = N * (N - 1) / 2;
+	netOnZeroDXC_pipeline_shard_range(first_pair, last_pair, pipeline.node_pairs_total, pipeline.parameter_shard_index, pipeline.parameter_nr_shards);
+	pipeline.node_pairs_first = first_pair;
+	pipeline.node_pairs.clear();
+	pipeline.node_pairs_index_a.clear();
+	pipeline.node_pairs_index_b.clear();
+	pipeline.node_pairs_valid.clear();
+	for (i = 0; i < N - 1; i++) {
+		for (j = i + 1; j < N; j++, k++) {		// Pairs in the order of netOnZeroDXC_fill_list_pairs, k being the triangular index
+			if ((k < first_pair) || (k >= last_pair))
+				continue;
+			temp_pair.label_a = pipeline.node_labels[i];
+			temp_pair.label_b = pipeline.node_labels[j];
+			pipeline.node_pairs.push_back(temp_pair);
+			pipeline.node_pairs_index_a.push_back(i);
+			pipeline.node_pairs_index_b.push_back(j);
+			pipeline.node_pairs_valid.push_back(pipeline.node_valid[i] && pipeline.node_valid[j]);
+		}
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_run (ContainerPipeline & pipeline)
+{
+	int	target = pipeline.parameter_computation_target;
+	bool	sharded = (pipeline.parameter_nr_shards > 1);
+	int	error;
+
+	if (pipeline.parameter_use_parallel)
+		omp_set_num_threads(pipeline.parameter_numthreads);
+
+	pipeline.surrogate_seed = (pipeline.parameter_seed > 0)? (unsigned int) pipeline.parameter_seed : (unsigned int) time(NULL);
+	if (pipeline.parameter_pvalue_by_surrogate && (target != 0) && (target != 4)) {
+		std::stringstream	message_seed;
+		message_seed << "Surrogates seed: " << pipeline.surrogate_seed << ".";
+		netOnZeroDXC_pipeline_message(pipeline, message_seed.str());
+	}
+
+	if (target >= 4)
+		return netOnZeroDXC_pipeline_wholeseq(pipeline);
+
+	ArchiveFile	output_archive;							// Closed (and indexed) on any exit path
+	AsyncWriter	output_writer(WRITER_QUEUE_SIZE);				// Declared later, hence drained before the archive is closed
+	if (pipeline.parameter_print_archive && (pipeline.parameter_print_cdiagrams || pipeline.parameter_print_pdiagrams || pipeline.parameter_print_efficiencies || pipeline.parameter_print_sweeps || (target < 3))) {
+		std::string	archive_filename;
+		if (sharded)
+			archive_filename = netOnZeroDXC_pipeline_shard_filepath(pipeline, ARCHIVE_LABEL, pipeline.parameter_shard_index, pipeline.parameter_nr_shards);
+		else
+			archive_filename = netOnZeroDXC_generate_filepath(pipeline.path_output_folder, pipeline.path_output_prefix, ARCHIVE_LABEL, pipeline.path_filename_delimiter, "", "");
+		if (netOnZeroDXC_archive_open(output_archive, archive_filename, pipeline.parameter_resume)) {		// A resumed run adds to the records it left
+			std::cerr << "ERROR: i/o error when writing data on file '" << archive_filename << "'. Please check permissions.\n";
+			return 1;
+		}
+	}
+
+	error = netOnZeroDXC_pipeline_cdiagrams(pipeline, output_writer, output_archive);
+	if ((!error) && (target >= 1))
+		error = netOnZeroDXC_pipeline_pdiagrams(pipeline, output_writer, output_archive);
+	if ((!error) && (target >= 2))
+		error = netOnZeroDXC_pipeline_efficiencies(pipeline, output_writer, output_archive);
+	if ((!error) && (target >= 2) && sharded)
+		error = netOnZeroDXC_pipeline_save_shard(pipeline);
+	if ((!error) && (target >= 3) && (!sharded))		// The matrix needs all pairs, hence it is left to the merge of shards
+		error = netOnZeroDXC_pipeline_matrix(pipeline, output_writer, output_archive);
+
+	if (output_writer.finish() || netOnZeroDXC_archive_close(output_archive)) {
+		if (!error)
+			std::cerr << "ERROR: i/o error when writing data on file '" << output_writer.failedOutput() << "'. Please check permissions.\n";
+		return 1;
+	}
+
+	return error;
+}
+
+int netOnZeroDXC_pipeline_wholeseq (ContainerPipeline & pipeline)
+{
+	bool	apply_shift = pipeline.parameter_use_shift;
+	bool	parallel = pipeline.parameter_use_parallel;
+	int	shift_value = pipeline.parameter_shift_value;
+	int	M = pipeline.parameter_nr_surrogates;
+	int	N = pipeline.node_labels.size();
+	int	nr_pairs = pipeline.node_pairs.size();
+	int	i, s;
+
+	netOnZeroDXC_pipeline_message(pipeline, "Computing whole-sequences cross correlations.");
+	netOnZeroDXC_compute_wholeseq_crosscorr_matrix(pipeline.wholeseq_xcorr, pipeline.sequences, pipeline.node_valid, apply_shift, shift_value, parallel);
+
+	int	error;
+	if (pipeline.parameter_print_wholeseq_xcorr || (pipeline.parameter_computation_target == 4)) {
+		error = netOnZeroDXC_save_diagram(pipeline.wholeseq_xcorr, pipeline.path_output_folder, pipeline.path_output_prefix, "wholeseqxcorr", pipeline.path_filename_delimiter, "", "", '\t');
+		if (error) {
+			std::cerr << "ERROR: i/o error when writing the whole-sequences cross correlations. Please check permissions.\n";
+			return 1;
+		}
+	}
+	if (pipeline.parameter_computation_target == 4)
+		return 0;
+
+	netOnZeroDXC_pipeline_message(pipeline, "Computing whole-sequences cross correlation p-values.");
+	netOnZeroDXC_initialize_temp_diagram(pipeline.wholeseq_pvalue, N, N);
+	for (i = 0; i < N; i++)
+		pipeline.wholeseq_pvalue[i][i] = (pipeline.node_valid[i])? 0.0 : std::numeric_limits<double>::quiet_NaN();
+	for (i = 0; i < nr_pairs; i++) {
+		if (!pipeline.node_pairs_valid[i]) {
+			pipeline.wholeseq_pvalue[pipeline.node_pairs_index_a[i]][pipeline.node_pairs_index_b[i]] = std::numeric_limits<double>::quiet_NaN();
+			pipeline.wholeseq_pvalue[pipeline.node_pairs_index_b[i]][pipeline.node_pairs_index_a[i]] = std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+
+	if (pipeline.parameter_pvalue_by_surrogate) {
+		std::vector < std::vector <double> >	values_distributions(N);
+		std::vector < std::vector <double> >	fft_amplitudes(N);
+		std::vector <SurrogateWorkspace>	surrogate_workspaces;		// One per thread
+		SequenceStore				surrogate_sequences;
+		if (netOnZeroDXC_initialize_surrogate_workspaces(surrogate_workspaces, (parallel)? omp_get_max_threads() : 1, pipeline.sequences.length(), pipeline.parameter_single_precision)
+			|| surrogate_sequences.assign(N, pipeline.sequences.length(), 0.0)) {
+			std::cerr << "ERROR: not enough memory to hold the surrogate sequences.\n";
+			return 1;
+		}
+		std::vector < std::vector <double> >	surrogate_xcorr;
+
+		#pragma omp parallel for schedule(dynamic) if(parallel)
+		for (int n = 0; n < N; n++) {
+			if (pipeline.node_valid[n])
+				netOnZeroDXC_initialize_surrogate_generation(values_distributions[n], fft_amplitudes[n], pipeline.sequences.span(n), surrogate_workspaces[omp_get_thread_num()]);
+		}
+
+		unsigned int	seed = pipeline.surrogate_seed;
+		for (s = 0; s < M; s++) {					// One surrogate per sequence and round, shared by all pairs
+			#pragma omp parallel for schedule(dynamic) if(parallel)
+			for (int n = 0; n < N; n++) {
+				if (pipeline.node_valid[n])
+					netOnZeroDXC_generate_surrogate_sequence(surrogate_sequences.data(n), pipeline.sequences.span(n), values_distributions[n], fft_amplitudes[n], TOLERANCE_SURROGATES, seed + s*N + n, surrogate_workspaces[omp_get_thread_num()]);
+			}
+
+			netOnZeroDXC_compute_wholeseq_crosscorr_matrix(surrogate_xcorr, surrogate_sequences, pipeline.node_valid, apply_shift, shift_value, parallel);
+			for (int p = 0; p < nr_pairs; p++) {
+				int	a = pipeline.node_pairs_index_a[p];
+				int	b = pipeline.node_pairs_index_b[p];
+				if (pipeline.node_pairs_valid[p] && (pipeline.wholeseq_xcorr[a][b] < surrogate_xcorr[a][b])) {
+					pipeline.wholeseq_pvalue[a][b] += 1.0 / ((double) M);
+					pipeline.wholeseq_pvalue[b][a] = pipeline.wholeseq_pvalue[a][b];
+				}
+			}
+			if (((s + 1) % 100 == 0) || (s + 1 == M)) {
+				std::stringstream	message_updated;
+				message_updated << "Surrogate " << s + 1 << " out of " << M << ".";
+				netOnZeroDXC_pipeline_message(pipeline, message_updated.str());
+			}
+		}
+	} else {
+		double	temp_cc2, temp_n, f_statistics;
+		for (i = 0; i < nr_pairs; i++) {
+			int	a = pipeline.node_pairs_index_a[i];
+			int	b = pipeline.node_pairs_index_b[i];
+			if (!pipeline.node_pairs_valid[i])
+				continue;
+			temp_cc2 = pipeline.wholeseq_xcorr[a][b]*pipeline.wholeseq_xcorr[a][b];
+			temp_n = (double) (pipeline.sequences.length() - ((apply_shift)? shift_value : 0));
+			f_statistics = 1.0/(1.0/temp_cc2 - 1.0);
+			f_statistics *= temp_n;
+			pipeline.wholeseq_pvalue[a][b] = netOnZeroDXC_cdf_f_distribution_Q(f_statistics, 1, temp_n - 2);
+			pipeline.wholeseq_pvalue[b][a] = pipeline.wholeseq_pvalue[a][b];
+		}
+	}
+
+	error = netOnZeroDXC_save_diagram(pipeline.wholeseq_pvalue, pipeline.path_output_folder, pipeline.path_output_prefix, "wholeseqpvalue", pipeline.path_filename_delimiter, "", "", '\t');
+	if (error) {
+		std::cerr << "ERROR: i/o error when writing the whole-sequences p-values. Please check permissions.\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_cdiagrams (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive)
+{
+	netOnZeroDXC_pipeline_message(pipeline, "Computing correlation diagrams.");
+	if (netOnZeroDXC_pipeline_early_stopping(pipeline).enabled)
+		netOnZeroDXC_pipeline_message(pipeline, "Window widths past the first crossing of the efficiency threshold are skipped.");
+	// F-test p values come for free with the correlation coefficients; they are kept as p-value diagrams until the next stage.
+	// Surrogates need the whole correlation diagrams, hence these stop early only for the F test.
+	EarlyStopping	stopping = netOnZeroDXC_pipeline_early_stopping(pipeline);
+	stopping.enabled = stopping.enabled && (!pipeline.parameter_pvalue_by_surrogate);
+	std::vector < std::vector <double> >	autocorrelations;
+	if (pipeline.parameter_autocorrelation_correction && (!pipeline.parameter_pvalue_by_surrogate)) {
+		netOnZeroDXC_pipeline_message(pipeline, "Correcting F-test degrees of freedom for autocorrelation.");
+		if (netOnZeroDXC_compute_autocorrelations(autocorrelations, pipeline.sequences, pipeline.node_valid, pipeline.parameter_basewidth * pipeline.parameter_nr_windowwidths / 5,
+								pipeline.parameter_use_parallel)) {
+			std::cerr << "ERROR: not enough memory to compute the autocorrelations of the sequences.\n";
+			return 1;
+		}
+	}
+	if (netOnZeroDXC_compute_cdiagram_set(pipeline.diagrams_correlation, pipeline.diagrams_pvalue, pipeline.sequences, pipeline.node_valid, pipeline.node_pairs_index_a,
+					pipeline.node_pairs_index_b, pipeline.parameter_basewidth, pipeline.parameter_nr_windowwidths, pipeline.parameter_use_shift,
+					pipeline.parameter_shift_value, pipeline.parameter_use_parallel, stopping, autocorrelations)) {
+		std::cerr << "ERROR: not enough memory to hold the diagrams of " << pipeline.node_pairs.size() << " pairs.\n";
+		return 1;
+	}
+
+	if (pipeline.parameter_print_cdiagrams || (pipeline.parameter_computation_target == 0)) {
+		std::vector < std::vector <double> >	temp_diagram;
+		int	i;
+		for (i = 0; i < pipeline.node_pairs.size(); i++) {
+			pipeline.diagrams_correlation.getTable(temp_diagram, i);
+			if (netOnZeroDXC_pipeline_write_diagram(pipeline, output_writer, output_archive, std::move(temp_diagram), "cdiag", pipeline.node_pairs[i].label_a, pipeline.node_pairs[i].label_b, BINARY_TABLE_FLOAT32, 0))
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
+// Replaces the surrogate counts by the p values of the fitted null, reports how far the transformed surrogate
+// coefficients are from normal, and writes the fits along with the p-value diagrams
+static int netOnZeroDXC_pipeline_parametric_pdiagrams (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive)
+{
+	std::vector < std::vector <double> >	temp_table;
+	double	worst_skewness = 0.0, worst_kurtosis = 0.0;
+	int	nr_unfitted = 0;
+	int	i, l;
+	for (i = 0; i < pipeline.node_pairs.size(); i++) {
+		if (!pipeline.node_pairs_valid[i])
+			continue;
+		netOnZeroDXC_compute_parametric_pdiagram(pipeline.diagrams_pvalue.view(i), pipeline.diagrams_correlation.view(i), pipeline.diagrams_null_moments.view(i));
+		netOnZeroDXC_null_fit_table(temp_table, pipeline.diagrams_null_moments.view(i), pipeline.parameter_basewidth * pipeline.parameter_samplingperiod);
+		for (l = 0; l < temp_table.size(); l++) {
+			if (std::isnan(temp_table[l][2])) {
+				nr_unfitted++;
+				continue;
+			}
+			worst_skewness = std::max(worst_skewness, fabs(temp_table[l][3]));
+			worst_kurtosis = std::max(worst_kurtosis, fabs(temp_table[l][4]));
+		}
+		if (pipeline.parameter_print_pdiagrams || (pipeline.parameter_computation_target == 1)) {
+			if (netOnZeroDXC_pipeline_write_diagram(pipeline, output_writer, output_archive, std::move(temp_table), "nullfit", pipeline.node_pairs[i].label_a, pipeline.node_pairs[i].label_b, BINARY_TABLE_FLOAT64, 0))
+				return 1;
+		}
+	}
+	pipeline.diagrams_null_moments.clear();
+
+	std::stringstream	message_fit;
+	message_fit << "Null fits: largest |skewness| " << worst_skewness << ", largest |excess kurtosis| " << worst_kurtosis << ".";
+	netOnZeroDXC_pipeline_message(pipeline, message_fit.str());
+	if ((worst_skewness > 0.5) || (worst_kurtosis > 1.0))
+		std::cerr << "WARNING: the transformed surrogate coefficients are far from normal (|skewness| up to " << worst_skewness << ", |excess kurtosis| up to "
+			<< worst_kurtosis << "); p values from the fit may be inaccurate in the tails.\n";
+	if (nr_unfitted)
+		std::cerr << "WARNING: " << nr_unfitted << " window widths have no spread in the surrogate coefficients; their p values are undefined.\n";
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_pdiagrams (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive)
+{
+	int	M = 0;
+	int	cell_type = BINARY_TABLE_FLOAT32;
+	if (pipeline.parameter_pvalue_by_surrogate) {
+		SurrogateScreening	screening = netOnZeroDXC_pipeline_screening(pipeline);
+		netOnZeroDXC_pipeline_message(pipeline, "Computing p-value diagrams by surrogate generation.");
+		M = pipeline.parameter_nr_surrogates;
+		cell_type = BINARY_TABLE_COUNTS16;
+		if (screening.enabled) {						// Cells keeping the F-test p value are not counts
+			std::stringstream	message_screening;
+			message_screening << "Surrogates only for cells with F-test p values between " << screening.lower_pvalue << " and " << screening.upper_pvalue << ".";
+			netOnZeroDXC_pipeline_message(pipeline, message_screening.str());
+			cell_type = BINARY_TABLE_FLOAT32;
+		}
+		if (netOnZeroDXC_pipeline_parametric(pipeline)) {
+			netOnZeroDXC_pipeline_message(pipeline, "P values from a normal fit of the Fisher-z transformed surrogate coefficients of each window width.");
+			cell_type = BINARY_TABLE_FLOAT32;
+		}
+		if (netOnZeroDXC_pipeline_pooled(pipeline)) {
+			netOnZeroDXC_pipeline_message(pipeline, "P values from the surrogate coefficients of all positions of each window width.");
+			cell_type = BINARY_TABLE_FLOAT32;
+		}
+		if (pipeline.parameter_single_precision) {				// Checked on the data, which keep double precision
+			double	max_error, mean_error;
+			if (netOnZeroDXC_single_precision_error(max_error, mean_error, pipeline.diagrams_correlation, pipeline.sequences, pipeline.node_valid, pipeline.node_pairs_index_a,
+								pipeline.node_pairs_index_b, pipeline.parameter_basewidth, pipeline.parameter_nr_windowwidths, pipeline.parameter_use_shift,
+								pipeline.parameter_shift_value, pipeline.parameter_use_parallel)) {
+				std::cerr << "ERROR: not enough memory to check the single-precision correlation coefficients.\n";
+				return 1;
+			}
+			std::stringstream	message_precision;
+			message_precision << "Surrogates in single precision: correlation coefficients of the data differ from double precision by " << mean_error
+						<< " on average, " << max_error << " at most.";
+			netOnZeroDXC_pipeline_message(pipeline, message_precision.str());
+			if (max_error > 1e-5)
+				std::cerr << "WARNING: single-precision correlation coefficients differ by up to " << max_error << " from double precision.\n";
+		}
+
+		std::string	checkpoint_filename;
+		if (pipeline.parameter_nr_shards > 1)
+			checkpoint_filename = netOnZeroDXC_pipeline_shard_filepath(pipeline, "checkpoint", pipeline.parameter_shard_index, pipeline.parameter_nr_shards);
+		else
+			checkpoint_filename = netOnZeroDXC_generate_filepath(pipeline.path_output_folder, pipeline.path_output_prefix, "checkpoint", pipeline.path_filename_delimiter, "", "");
+
+		bool	counted = netOnZeroDXC_pipeline_counted(pipeline);
+		if (counted)
+			pipeline.diagrams_pvalue.clear();			// The F-test p values are not needed
+		int	first_round = 0, last_round;
+		FILE	*checkpoint_file = (pipeline.parameter_resume)? fopen(checkpoint_filename.c_str(), "rb") : NULL;
+		if (checkpoint_file) {
+			fclose(checkpoint_file);
+			if (netOnZeroDXC_pipeline_load_checkpoint(pipeline, checkpoint_filename, first_round))
+				return 1;
+			std::stringstream	message_resumed;
+			message_resumed << "Resuming from surrogate " << first_round + 1 << " out of " << M << ", seed " << pipeline.surrogate_seed << ".";
+			netOnZeroDXC_pipeline_message(pipeline, message_resumed.str());
+		} else {
+			if (pipeline.parameter_resume)
+				std::cerr << "WARNING: no checkpoint found in '" << checkpoint_filename << "'; starting from the first surrogate.\n";
+			if ((counted)? netOnZeroDXC_initialize_pdiagram_set(pipeline.diagrams_count, pipeline.diagrams_correlation, pipeline.node_valid, pipeline.node_pairs_index_a,
+										pipeline.node_pairs_index_b, pipeline.parameter_nr_windowwidths)
+					: netOnZeroDXC_initialize_pdiagram_set(pipeline.diagrams_pvalue, pipeline.diagrams_correlation, pipeline.node_valid, pipeline.node_pairs_index_a,
+										pipeline.node_pairs_index_b, pipeline.parameter_basewidth, pipeline.parameter_nr_windowwidths, screening)) {
+				std::cerr << "ERROR: not enough memory to hold the diagrams of " << pipeline.node_pairs.size() << " pairs.\n";
+				return 1;
+			}
+			if (netOnZeroDXC_pipeline_parametric(pipeline)
+				&& pipeline.diagrams_null_moments.assign(pipeline.node_pairs.size(), pipeline.parameter_nr_windowwidths, NULL_MOMENTS, 0.0)) {
+				std::cerr << "ERROR: not enough memory to hold the diagrams of " << pipeline.node_pairs.size() << " pairs.\n";
+				return 1;
+			}
+			if (netOnZeroDXC_pipeline_pooled(pipeline)
+				&& pipeline.diagrams_null_histograms.assign(pipeline.node_pairs.size(), pipeline.parameter_nr_windowwidths, NULL_HISTOGRAM_BINS, 0)) {
+				std::cerr << "ERROR: not enough memory to hold the diagrams of " << pipeline.node_pairs.size() << " pairs.\n";
+				return 1;
+			}
+		}
+
+		SurrogateContext	surrogate_context;			// Shared by all steps
+		if (netOnZeroDXC_initialize_surrogate_context(surrogate_context, pipeline.sequences.size(), pipeline.sequences.length(), pipeline.parameter_nr_windowwidths,
+								pipeline.diagrams_correlation.cols(), pipeline.parameter_use_shift, pipeline.parameter_use_parallel, pipeline.parameter_single_precision)) {
+			std::cerr << "ERROR: not enough memory to hold the surrogate sequences.\n";
+			return 1;
+		}
+		int	rounds_per_step = (pipeline.parameter_checkpoint_rounds > 0)? pipeline.parameter_checkpoint_rounds : M;
+		for (; first_round < M; first_round = last_round) {
+			last_round = (first_round + rounds_per_step < M)? first_round + rounds_per_step : M;
+			if ((counted)? netOnZeroDXC_update_pdiagram_set(pipeline.diagrams_count, surrogate_context, pipeline.diagrams_correlation, pipeline.sequences, pipeline.node_valid,
+								pipeline.node_pairs_index_a, pipeline.node_pairs_index_b, M, first_round, last_round, pipeline.parameter_basewidth,
+								pipeline.parameter_nr_windowwidths, pipeline.parameter_use_shift, pipeline.parameter_shift_value, pipeline.surrogate_seed,
+								netOnZeroDXC_pipeline_early_stopping(pipeline), screening, pipeline.diagrams_null_moments, pipeline.diagrams_null_histograms)
+					: netOnZeroDXC_update_pdiagram_set(pipeline.diagrams_pvalue, surrogate_context, pipeline.diagrams_correlation, pipeline.sequences, pipeline.node_valid,
+								pipeline.node_pairs_index_a, pipeline.node_pairs_index_b, M, first_round, last_round, pipeline.parameter_basewidth,
+								pipeline.parameter_nr_windowwidths, pipeline.parameter_use_shift, pipeline.parameter_shift_value, pipeline.surrogate_seed,
+								netOnZeroDXC_pipeline_early_stopping(pipeline), screening, pipeline.diagrams_null_moments, pipeline.diagrams_null_histograms)) {
+				std::cerr << "ERROR: not enough memory to hold the surrogate sequences.\n";
+				return 1;
+			}
+			if ((pipeline.parameter_checkpoint_rounds > 0) && (last_round < M)) {
+				if (netOnZeroDXC_pipeline_save_checkpoint(pipeline, checkpoint_filename, last_round))
+					return 1;
+			}
+			std::stringstream	message_updated;
+			message_updated << "Surrogate " << last_round << " out of " << M << ".";
+			netOnZeroDXC_pipeline_message(pipeline, message_updated.str());
+		}
+		remove(checkpoint_filename.c_str());			// The p-value diagrams are complete: a later resume must not pick up stale counts
+		if (netOnZeroDXC_pipeline_parametric(pipeline) && netOnZeroDXC_pipeline_parametric_pdiagrams(pipeline, output_writer, output_archive))
+			return 1;
+		if (netOnZeroDXC_pipeline_pooled(pipeline)) {
+			int	i;
+			for (i = 0; i < pipeline.node_pairs.size(); i++) {
+				if (pipeline.node_pairs_valid[i])
+					netOnZeroDXC_compute_pooled_pdiagram(pipeline.diagrams_pvalue.view(i), pipeline.diagrams_correlation.view(i), pipeline.diagrams_null_histograms.view(i));
+			}
+			pipeline.diagrams_null_histograms.clear();
+		}
+	} else {
+		netOnZeroDXC_pipeline_message(pipeline, "Computing p-value diagrams by F-test.");
+	}
+	if (pipeline.parameter_computation_target > 1)
+		pipeline.diagrams_correlation.clear();
+
+	if (pipeline.parameter_print_pdiagrams || (pipeline.parameter_computation_target == 1)) {
+		std::vector < std::vector <double> >	temp_diagram;
+		int	i;
+		for (i = 0; i < pipeline.node_pairs.size(); i++) {
+			if (pipeline.diagrams_count.size())
+				pipeline.diagrams_count.getPvalueTable(temp_diagram, i, M);
+			else
+				pipeline.diagrams_pvalue.getTable(temp_diagram, i);
+			if (netOnZeroDXC_pipeline_write_diagram(pipeline, output_writer, output_archive, std::move(temp_diagram), "pdiag", pipeline.node_pairs[i].label_a, pipeline.node_pairs[i].label_b, cell_type, (cell_type == BINARY_TABLE_COUNTS16)? M : 0))
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_efficiencies (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive)
+{
+	netOnZeroDXC_pipeline_message(pipeline, "Computing efficiencies.");
+
+	bool	avoid_overlapping_windows = pipeline.parameter_overlapping_windows;
+	bool	multi_alpha = (pipeline.parameter_computation_target == 3) && pipeline.parameter_print_sweeps;
+	double	alpha = pipeline.parameter_thr_significance;
+	int	nr_diagrams = pipeline.node_pairs.size();
+	bool	counted = (pipeline.diagrams_count.size() > 0);		// Thresholds become limits on the counts of M surrogates
+	int	M = pipeline.parameter_nr_surrogates;
+	int	i;
+
+	pipeline.window_widths.clear();
+	for (i = 0; i < pipeline.parameter_nr_windowwidths; i++)
+		pipeline.window_widths.push_back((i + 1) * pipeline.parameter_basewidth * pipeline.parameter_samplingperiod);
+	pipeline.efficiencies.assign(nr_diagrams, std::vector <double> ());
+	if (multi_alpha)		// Efficiencies at different significance thresholds, computed while each diagram is at hand
+		pipeline.efficiencies_multialpha.assign(101, std::vector < std::vector <double> > (nr_diagrams));
+
+	std::vector <int>	count_limits(101, 0);
+	if (counted) {
+		for (i = 0; i <= 100; i++)
+			count_limits[i] = netOnZeroDXC_count_limit(((double) i) / 1000.0, M);
+	}
+
+	#pragma omp parallel for schedule(dynamic) if(pipeline.parameter_use_parallel)
+	for (int p = 0; p < nr_diagrams; p++) {
+		int	k;
+		if (pipeline.node_pairs_valid[p] && counted) {
+			CountView	count_diagram = pipeline.diagrams_count.view(p);
+			netOnZeroDXC_compute_efficiency(pipeline.efficiencies[p], count_diagram, netOnZeroDXC_count_limit(alpha, M), avoid_overlapping_windows);
+			if (multi_alpha) {
+				for (k = 0; k <= 100; k++)
+					netOnZeroDXC_compute_efficiency(pipeline.efficiencies_multialpha[k][p], count_diagram, count_limits[k], avoid_overlapping_windows);
+			}
+		} else if (pipeline.node_pairs_valid[p]) {
+			DiagramView	pvalue_diagram = pipeline.diagrams_pvalue.view(p);
+			netOnZeroDXC_compute_efficiency(pipeline.efficiencies[p], pvalue_diagram, alpha, avoid_overlapping_windows);
+			if (multi_alpha) {
+				for (k = 0; k <= 100; k++)
+					netOnZeroDXC_compute_efficiency(pipeline.efficiencies_multialpha[k][p], pvalue_diagram, ((double) k) / 1000.0, avoid_overlapping_windows);
+			}
+		} else {
+			netOnZeroDXC_initialize_nan_efficiency(pipeline.efficiencies[p], pipeline.window_widths.size());
+			if (multi_alpha) {
+				for (k = 0; k <= 100; k++)
+					netOnZeroDXC_initialize_nan_efficiency(pipeline.efficiencies_multialpha[k][p], pipeline.window_widths.size());
+			}
+		}
+	}
+	pipeline.diagrams_pvalue.clear();
+	pipeline.diagrams_count.clear();
+
+	if (pipeline.parameter_print_efficiencies || (pipeline.parameter_computation_target == 2))
+		return netOnZeroDXC_pipeline_write_efficiencies(pipeline, output_writer, output_archive);
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_write_efficiencies (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive)
+{
+	int	error, i, j;
+	std::vector < std::vector <double> >	temp_w_eta(pipeline.window_widths.size(), std::vector <double> (2, 0.0));
+	for (i = 0; i < pipeline.node_pairs.size(); i++) {
+		if (pipeline.parameter_print_archive) {
+			for (j = 0; j < pipeline.window_widths.size(); j++) {
+				temp_w_eta[j][0] = pipeline.window_widths[j];
+				temp_w_eta[j][1] = pipeline.efficiencies[i][j];
+			}
+			error = output_writer.appendArchive(output_archive, temp_w_eta, "eff", pipeline.node_pairs[i].label_a, pipeline.node_pairs[i].label_b, BINARY_TABLE_FLOAT64, 0);
+		} else {
+			error = output_writer.saveLinearData(pipeline.window_widths, pipeline.efficiencies[i], pipeline.path_output_folder, pipeline.path_output_prefix, "eff", pipeline.path_filename_delimiter, pipeline.node_pairs[i].label_a, pipeline.node_pairs[i].label_b, '\t');
+		}
+		if (error) {
+			std::cerr << "ERROR: i/o error when writing data on file '" << output_writer.failedOutput() << "'. Please check permissions.\n";
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_matrix (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive)
+{
+	netOnZeroDXC_pipeline_message(pipeline, "Computing the matrix of time scales.");
+
+	std::vector < std::vector <int> >	pair_indices;
+	netOnZeroDXC_fill_pair_index_table(pair_indices, pipeline.node_pairs, pipeline.node_labels);
+	netOnZeroDXC_compute_timescale_matrix(pipeline.timescale_matrix, pipeline.efficiencies, pipeline.window_widths, pipeline.node_valid, pair_indices, pipeline.parameter_thr_efficiency);
+
+	int	error;
+	error = netOnZeroDXC_save_diagram(pipeline.timescale_matrix, pipeline.path_output_folder, pipeline.path_output_prefix, "matrix", pipeline.path_filename_delimiter, "", "", '\t');
+	if (error) {
+		std::cerr << "ERROR: i/o error when writing the matrix of time scales. Please check permissions.\n";
+		return 1;
+	}
+
+	if (pipeline.parameter_print_sweeps && pipeline.efficiencies_multialpha.size()) {
+		netOnZeroDXC_pipeline_message(pipeline, "Computing the matrices of time scales for all thresholds.");
+		std::vector < std::vector <double> >	temp_matrix;
+		char	label_alpha[16], label_eta[16];
+		int	alpha_index, eta_index;
+		for (alpha_index = 0; alpha_index <= 100; alpha_index++) {
+			for (eta_index = 0; eta_index <= 100; eta_index++) {
+				netOnZeroDXC_compute_timescale_matrix(temp_matrix, pipeline.efficiencies_multialpha[alpha_index], pipeline.window_widths, pipeline.node_valid, pair_indices, ((double) eta_index) / 100.0);
+				sprintf(label_alpha, "a%03d", alpha_index);
+				sprintf(label_eta, "e%03d", eta_index);
+				if (netOnZeroDXC_pipeline_write_diagram(pipeline, output_writer, output_archive, std::move(temp_matrix), "matrix", label_alpha, label_eta, BINARY_TABLE_FLOAT32, 0))
+					return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_save_shard (ContainerPipeline & pipeline)
+{
+	int	N = pipeline.node_labels.size();
+	int	i;
+	std::string	shard_filename = netOnZeroDXC_pipeline_shard_filepath(pipeline, "shard", pipeline.parameter_shard_index, pipeline.parameter_nr_shards);
+
+	std::vector < std::vector <double> >	shard_info(1, std::vector <double> (SHARD_INFO_SIZE, 0.0));
+	std::vector < std::vector <double> >	shard_nodes(1, std::vector <double> (N, 0.0));
+	shard_info[0][0] = pipeline.parameter_shard_index;
+	shard_info[0][1] = pipeline.parameter_nr_shards;
+	shard_info[0][2] = N;
+	shard_info[0][3] = pipeline.node_pairs_total;
+	shard_info[0][4] = pipeline.node_pairs_first;
+	shard_info[0][5] = pipeline.node_pairs_first + pipeline.node_pairs.size();
+	shard_info[0][6] = pipeline.parameter_thr_significance;			// Settings the efficiencies depend on, in the order of netOnZeroDXC_pipeline_merge
+	shard_info[0][7] = (pipeline.parameter_overlapping_windows)? 1 : 0;
+	shard_info[0][8] = (pipeline.parameter_pvalue_by_surrogate)? 1 : 0;
+	shard_info[0][9] = (pipeline.parameter_pvalue_by_surrogate)? pipeline.parameter_nr_surrogates : 0;
+	shard_info[0][10] = (netOnZeroDXC_pipeline_screening(pipeline).enabled)? pipeline.parameter_screening_band : 0;
+	shard_info[0][11] = (netOnZeroDXC_pipeline_parametric(pipeline))? 1 : 0;
+	shard_info[0][12] = (netOnZeroDXC_pipeline_pooled(pipeline))? 1 : 0;
+	shard_info[0][13] = (pipeline.parameter_autocorrelation_correction && (!pipeline.parameter_pvalue_by_surrogate))? 1 : 0;
+	shard_info[0][14] = (pipeline.parameter_use_shift)? pipeline.parameter_shift_value : 0;
+	for (i = 0; i < N; i++)
+		shard_nodes[0][i] = (pipeline.node_valid[i])? 1.0 : 0.0;
+
+	ArchiveFile	shard_archive;				// Results of a previous run of the same shard are replaced, not updated
+	int	error = netOnZeroDXC_archive_open(shard_archive, shard_filename, false);
+	if (!error)
+		error = netOnZeroDXC_archive_append_table(shard_archive, shard_info, "shard", "info", "", BINARY_TABLE_FLOAT64, 0);
+	if (!error)
+		error = netOnZeroDXC_archive_append_table(shard_archive, shard_nodes, "shard", "nodes", "", BINARY_TABLE_FLOAT64, 0);
+
+	std::vector < std::vector <double> >	temp_w_eta(pipeline.window_widths.size(), std::vector <double> (2, 0.0));
+	int	j;
+	for (i = 0; (i < pipeline.node_pairs.size()) && (!error); i++) {
+		for (j = 0; j < pipeline.window_widths.size(); j++) {
+			temp_w_eta[j][0] = pipeline.window_widths[j];
+			temp_w_eta[j][1] = pipeline.efficiencies[i][j];
+		}
+		error = netOnZeroDXC_archive_append_table(shard_archive, temp_w_eta, "eff", pipeline.node_pairs[i].label_a, pipeline.node_pairs[i].label_b, BINARY_TABLE_FLOAT64, 0);
+	}
+	if (netOnZeroDXC_archive_close(shard_archive) || error) {		// The table of contents is written last: a shard that did not finish cannot be merged
+		std::cerr << "ERROR: i/o error when writing data on file '" << shard_filename << "'. Please check permissions.\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+int netOnZeroDXC_pipeline_merge (ContainerPipeline & pipeline, int nr_shards)
+{
+	netOnZeroDXC_pipeline_message(pipeline, "Merging the efficiencies of all shards.");
+
+	const char	*shard_settings[SHARD_INFO_SIZE - 6] = {"thr_significance", "overlapping_windows", "pvalue_by_surrogate", "nr_surrogates", "screening_band",
+							"parametric_null", "pooled_null", "autocorrelation_correction", "shift_value"};
+	std::vector <double>	settings;
+	int	N = -1, nr_pairs = -1;
+	int	first_pair, last_pair;
+	int	a, b, k, t;
+	size_t	i;
+	std::vector < std::vector < std::vector <double> > >	temp_tables;
+	std::vector <PairOfLabels>				temp_pairs;
+	std::vector <bool>					pair_found;
+	std::map <std::string, int>				label_index;
+
+	for (k = 0; k < nr_shards; k++) {
+		std::string	shard_filename = netOnZeroDXC_pipeline_shard_filepath(pipeline, "shard", k, nr_shards);
+		temp_tables.clear();
+		temp_pairs.clear();
+		if (netOnZeroDXC_archive_load_quantity(temp_tables, temp_pairs, shard_filename, "shard") || (temp_tables.size() != 2)) {
+			std::cerr << "ERROR: shard " << k << " of " << nr_shards << " is missing, unfinished or unreadable ('" << shard_filename << "').\n";
+			return 1;
+		}
+		const std::vector < std::vector <double> > &	shard_info = (temp_pairs[0].label_a == "info")? temp_tables[0] : temp_tables[1];
+		const std::vector < std::vector <double> > &	shard_nodes = (temp_pairs[0].label_a == "info")? temp_tables[1] : temp_tables[0];
+		if ((shard_info.size() != 1) || (shard_info[0].size() != SHARD_INFO_SIZE) || (shard_info[0][0] != k) || (shard_info[0][1] != nr_shards)) {
+			std::cerr << "ERROR: file '" << shard_filename << "' does not hold shard " << k << " of " << nr_shards << ".\n";
+			return 1;
+		}
+		if (k == 0) {
+			N = (int) shard_info[0][2];
+			nr_pairs = (int) shard_info[0][3];
+			if ((N < 2) || (nr_pairs != N * (N - 1) / 2) || (shard_nodes.size() != 1) || (shard_nodes[0].size() != N)) {
+				std::cerr << "ERROR: invalid network size in shard 0.\n";
+				return 1;
+			}
+			netOnZeroDXC_generate_node_labels(pipeline.node_labels, N);
+			netOnZeroDXC_fill_list_pairs(pipeline.node_pairs, pipeline.node_labels);
+			for (a = 0; a < N; a++) {
+				pipeline.node_valid.push_back(shard_nodes[0][a] != 0.0);
+				label_index[pipeline.node_labels[a]] = a;
+			}
+			pipeline.efficiencies.assign(nr_pairs, std::vector <double> ());
+			pair_found.assign(nr_pairs, false);
+			settings.assign(shard_info[0].begin() + 6, shard_info[0].end());
+		} else if ((shard_info[0][2] != N) || (shard_info[0][3] != nr_pairs) || (shard_nodes.size() != 1) || (shard_nodes[0].size() != N)) {
+			std::cerr << "ERROR: shard " << k << " was computed on a different network than shard 0.\n";
+			return 1;
+		}
+		for (a = 0; a < settings.size(); a++) {			// Efficiencies of different tests or thresholds cannot go in one matrix
+			if (shard_info[0][6 + a] != settings[a]) {
+				std::cerr << "ERROR: shard " << k << " was computed with a different " << shard_settings[a] << " than shard 0.\n";
+				return 1;
+			}
+		}
+		netOnZeroDXC_pipeline_shard_range(first_pair, last_pair, nr_pairs, k, nr_shards);
+		if ((shard_info[0][4] != first_pair) || (shard_info[0][5] != last_pair)) {
+			std::cerr << "ERROR: shard " << k << " does not cover the expected block of pairs (" << first_pair << " to " << last_pair - 1 << ").\n";
+			return 1;
+		}
+
+		temp_tables.clear();
+		temp_pairs.clear();
+		if (netOnZeroDXC_archive_load_quantity(temp_tables, temp_pairs, shard_filename, "eff")) {
+			std::cerr << "ERROR: cannot read the efficiencies of shard " << k << ".\n";
+			return 1;
+		}
+		for (i = 0; i < temp_pairs.size(); i++) {
+			if ((!label_index.count(temp_pairs[i].label_a)) || (!label_index.count(temp_pairs[i].label_b))) {
+				std::cerr << "ERROR: unknown pair '" << temp_pairs[i].label_a << " " << temp_pairs[i].label_b << "' in shard " << k << ".\n";
+				return 1;
+			}
+			a = label_index[temp_pairs[i].label_a];
+			b = label_index[temp_pairs[i].label_b];
+			t = netOnZeroDXC_triangular_index_of_pair(a, b, N);
+			if ((a == b) || (t < first_pair) || (t >= last_pair) || pair_found[t]) {
+				std::cerr << "ERROR: unexpected pair '" << temp_pairs[i].label_a << " " << temp_pairs[i].label_b << "' in shard " << k << ".\n";
+				return 1;
+			}
+			if (pipeline.window_widths.empty()) {
+				for (a = 0; a < temp_tables[i].size(); a++)
+					pipeline.window_widths.push_back(temp_tables[i][a][0]);
+			}
+			if (temp_tables[i].size() != pipeline.window_widths.size()) {
+				std::cerr << "ERROR: inconsistent window widths in shard " << k << ".\n";
+				return 1;
+			}
+			pipeline.efficiencies[t].clear();
+			for (a = 0; a < temp_tables[i].size(); a++) {
+				if (temp_tables[i][a][0] != pipeline.window_widths[a]) {
+					std::cerr << "ERROR: inconsistent window widths in shard " << k << ".\n";
+					return 1;
+				}
+				pipeline.efficiencies[t].push_back(temp_tables[i][a][1]);
+			}
+			pair_found[t] = true;
+		}
+		for (t = first_pair; t < last_pair; t++) {
+			if (!pair_found[t]) {
+				std::cerr << "ERROR: shard " << k << " is incomplete: " << temp_pairs.size() << " out of " << last_pair - first_pair << " pairs found.\n";
+				return 1;
+			}
+		}
+	}
+
+	ArchiveFile	output_archive;
+	AsyncWriter	output_writer(WRITER_QUEUE_SIZE);
+	if (pipeline.parameter_print_archive && pipeline.parameter_print_efficiencies) {
+		std::string	archive_filename = netOnZeroDXC_generate_filepath(pipeline.path_output_folder, pipeline.path_output_prefix, ARCHIVE_LABEL, pipeline.path_filename_delimiter, "", "");
+		if (netOnZeroDXC_archive_open(output_archive, archive_filename, false)) {
+			std::cerr << "ERROR: i/o error when writing data on file '" << archive_filename << "'. Please check permissions.\n";
+			return 1;
+		}
+	}
+	if (pipeline.parameter_print_sweeps)
+		std::cerr << "WARNING: matrices for all thresholds cannot be computed from merged shards, and are not written.\n";
+
+	int	error = 0;
+	if (pipeline.parameter_print_efficiencies)
+		error = netOnZeroDXC_pipeline_write_efficiencies(pipeline, output_writer, output_archive);
+	if (!error)
+		error = netOnZeroDXC_pipeline_matrix(pipeline, output_writer, output_archive);
+	if (output_writer.finish() || netOnZeroDXC_archive_close(output_archive)) {
+		if (!error)
+			std::cerr << "ERROR: i/o error when writing data on file '" << output_writer.failedOutput() << "'. Please check permissions.\n";
+		return 1;
+	}
+
+	return error;
+}
+
+// Settings the partial counts of the run depend on
+static CheckpointInfo netOnZeroDXC_pipeline_checkpoint_info (const ContainerPipeline & pipeline, int completed_rounds)
+{
+	EarlyStopping	stopping = netOnZeroDXC_pipeline_early_stopping(pipeline);
+	CheckpointInfo	info;
+	netOnZeroDXC_checkpoint_initialize(info);
+	info.seed = pipeline.surrogate_seed;
+	info.nr_surrogates = pipeline.parameter_nr_surrogates;
+	info.completed_rounds = completed_rounds;
+	info.nr_nodes = pipeline.node_labels.size();
+	info.first_pair = pipeline.node_pairs_first;
+	info.nr_pairs = pipeline.node_pairs.size();
+	info.basewidth = pipeline.parameter_basewidth;
+	info.nr_windowwidths = pipeline.parameter_nr_windowwidths;
+	info.shift = (pipeline.parameter_use_shift)? pipeline.parameter_shift_value : 0;
+	info.length = pipeline.sequences.length();
+	info.early_stopping = stopping.enabled;
+	info.threshold_alpha = pipeline.parameter_thr_significance;
+	info.threshold_eta = stopping.threshold_eta;
+	info.avoid_overlapping = stopping.avoid_overlapping;
+	info.screening_band = (netOnZeroDXC_pipeline_screening(pipeline).enabled)? pipeline.parameter_screening_band : 0;
+	info.parametric = netOnZeroDXC_pipeline_parametric(pipeline);
+	info.pooled = netOnZeroDXC_pipeline_pooled(pipeline);
+	info.single_precision = pipeline.parameter_single_precision;
+	info.checksum = pipeline.sequences.checksum();
+
+	return info;
+}
+
+int netOnZeroDXC_pipeline_save_checkpoint (const ContainerPipeline & pipeline, std::string checkpoint_filename, int completed_rounds)
+{
+	ArchiveFile	checkpoint_archive;
+	int	error = netOnZeroDXC_checkpoint_open(checkpoint_archive, checkpoint_filename, netOnZeroDXC_pipeline_checkpoint_info(pipeline, completed_rounds));
+	if ((!error) && pipeline.diagrams_count.size())
+		error = netOnZeroDXC_checkpoint_append(checkpoint_archive, pipeline.diagrams_count, "pdiag", pipeline.node_pairs);
+	else if (!error)
+		error = netOnZeroDXC_checkpoint_append(checkpoint_archive, pipeline.diagrams_pvalue, "pdiag", pipeline.node_pairs);
+	if (!error)
+		error = netOnZeroDXC_checkpoint_append(checkpoint_archive, pipeline.diagrams_null_moments, "nullmoments", pipeline.node_pairs);
+	if (!error)
+		error = netOnZeroDXC_checkpoint_append(checkpoint_archive, pipeline.diagrams_null_histograms, "nullhist", pipeline.node_pairs);
+	if (!error)
+		error = netOnZeroDXC_checkpoint_commit(checkpoint_archive, checkpoint_filename);
+	if (error == 2) {
+		std::cerr << "ERROR: cannot replace the checkpoint file '" << checkpoint_filename << "'.\n";
+		return 1;
+	} else if (error) {
+		std::cerr << "ERROR: i/o error when writing data on file '" << checkpoint_filename << ".tmp'. Please check permissions.\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+// Loads the tables saved under label for each pair of the run, in the order of the pairs, into a DiagramSet, CountSet or HistogramSet
+template <class Set> static int netOnZeroDXC_pipeline_load_checkpoint_tables (Set & tables, const ContainerPipeline & pipeline, std::string checkpoint_filename, std::string label, int rows, int cols)
+{
+	int	missing_pair = 0;
+	int	error = netOnZeroDXC_checkpoint_load(tables, missing_pair, checkpoint_filename, label, pipeline.node_pairs, rows, cols);
+	if (error == 1)
+		std::cerr << "ERROR: cannot read the checkpoint file '" << checkpoint_filename << "'.\n";
+	else if (error == 2)
+		std::cerr << "ERROR: not enough memory to hold the diagrams of " << pipeline.node_pairs.size() << " pairs.\n";
+	else if (error)
+		std::cerr << "ERROR: the checkpoint '" << checkpoint_filename << "' lacks pair '" << pipeline.node_pairs[missing_pair].label_a << " " << pipeline.node_pairs[missing_pair].label_b << "'.\n";
+
+	return error;
+}
+
+int netOnZeroDXC_pipeline_load_checkpoint (ContainerPipeline & pipeline, std::string checkpoint_filename, int & completed_rounds)
+{
+	CheckpointInfo	saved;
+	if (netOnZeroDXC_checkpoint_load_info(saved, checkpoint_filename)) {
+		std::cerr << "ERROR: cannot read the checkpoint file '" << checkpoint_filename << "'.\n";
+		return 1;
+	}
+	CheckpointInfo	run = netOnZeroDXC_pipeline_checkpoint_info(pipeline, 0);
+	std::string	mismatch = netOnZeroDXC_checkpoint_mismatch(saved, run);
+	if (mismatch.empty() && ((saved.first_pair != run.first_pair) || (saved.nr_pairs != run.nr_pairs)))
+		mismatch = "was saved with different sequences or parameters";
+	if (!mismatch.empty()) {
+		std::cerr << "ERROR: the checkpoint '" << checkpoint_filename << "' " << mismatch << ".\n";
+		return 1;
+	}
+	if ((pipeline.parameter_seed > 0) && (saved.seed != (unsigned int) pipeline.parameter_seed)) {
+		std::cerr << "ERROR: the checkpoint '" << checkpoint_filename << "' was saved with seed " << saved.seed << ".\n";
+		return 1;
+	}
+	completed_rounds = saved.completed_rounds;
+
+	if (netOnZeroDXC_pipeline_counted(pipeline)) {
+		if (netOnZeroDXC_pipeline_load_checkpoint_tables(pipeline.diagrams_count, pipeline, checkpoint_filename, "pdiag", pipeline.diagrams_correlation.rows(), pipeline.diagrams_correlation.cols()))
+			return 1;
+	} else if (netOnZeroDXC_pipeline_load_checkpoint_tables(pipeline.diagrams_pvalue, pipeline, checkpoint_filename, "pdiag", pipeline.diagrams_correlation.rows(), pipeline.diagrams_correlation.cols())) {
+		return 1;
+	}
+	if (saved.parametric && netOnZeroDXC_pipeline_load_checkpoint_tables(pipeline.diagrams_null_moments, pipeline, checkpoint_filename, "nullmoments", pipeline.parameter_nr_windowwidths, NULL_MOMENTS))
+		return 1;
+	if (saved.pooled && netOnZeroDXC_pipeline_load_checkpoint_tables(pipeline.diagrams_null_histograms, pipeline, checkpoint_filename, "nullhist", pipeline.parameter_nr_windowwidths, NULL_HISTOGRAM_BINS))
+		return 1;
+	pipeline.surrogate_seed = saved.seed;
+
+	return 0;
+}
+
+std::string netOnZeroDXC_pipeline_shard_filepath (const ContainerPipeline & pipeline, std::string label, int shard_index, int nr_shards)
+{
+	char	label_index[16], label_number[16];
+	sprintf(label_index, "%03d", shard_index);
+	sprintf(label_number, "%03d", nr_shards);
+
+	return netOnZeroDXC_generate_filepath(pipeline.path_output_folder, pipeline.path_output_prefix, label, pipeline.path_filename_delimiter, label_index, label_number);
+}
+
+void netOnZeroDXC_pipeline_shard_range (int & first_pair, int & last_pair, int nr_pairs, int shard_index, int nr_shards)
+{
+	first_pair = (int) (((long long) nr_pairs * shard_index) / nr_shards);
+	last_pair = (int) (((long long) nr_pairs * (shard_index + 1)) / nr_shards);
+}
+
+int netOnZeroDXC_pipeline_write_diagram (ContainerPipeline & pipeline, AsyncWriter & output_writer, ArchiveFile & output_archive, std::vector < std::vector <double> > diagram,
+					std::string label, std::string label_a, std::string label_b, int cell_type, int nr_surrogates)
+{
+	int	error;
+	if (pipeline.parameter_print_archive)
+		error = output_writer.appendArchive(output_archive, std::move(diagram), label, label_a, label_b, cell_type, nr_surrogates);
+	else if (pipeline.parameter_print_binary)
+		error = output_writer.saveDiagramBinary(std::move(diagram), pipeline.path_output_folder, pipeline.path_output_prefix, label, pipeline.path_filename_delimiter, label_a, label_b, cell_type, nr_surrogates);
+	else
+		error = output_writer.saveDiagram(std::move(diagram), pipeline.path_output_folder, pipeline.path_output_prefix, label, pipeline.path_filename_delimiter, label_a, label_b, '\t');
+	if (error) {
+		std::cerr << "ERROR: i/o error when writing data on file '" << output_writer.failedOutput() << "'. Please check permissions.\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+void netOnZeroDXC_pipeline_message (const ContainerPipeline & pipeline, std::string message)
+{
+	if (pipeline.parameter_verbose)
+		std::cerr << message << "\n";
+}
@@ -0,0 +1,243 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#ifndef INCLUDED_SEQUENCESTORE
+	#include "netOnZeroDXC_sequence_store.hpp"
+	#define INCLUDED_SEQUENCESTORE
+#endif
+
+SequenceStore::SequenceStore ()
+{
+	m_data = NULL;
+	m_count = 0;
+	m_length = 0;
+	m_stride = 0;
+	m_data_single = NULL;
+}
+
+SequenceStore::SequenceStore (const SequenceStore & other)
+{
+	m_data = NULL;
+	m_count = 0;
+	m_length = 0;
+	m_stride = 0;
+	m_data_single = NULL;
+	if (other.m_data && !assign(other.m_count, other.m_length, 0.0)) {
+		std::copy(other.m_data, other.m_data + (size_t) other.m_count * other.m_stride, m_data);
+		m_valid = other.m_valid;
+		if (other.m_data_single)
+			assign_single();
+	}
+}
+
+SequenceStore::~SequenceStore ()
+{
+	clear();
+}
+
+SequenceStore & SequenceStore::operator= (const SequenceStore & other)
+{
+	SequenceStore	temp_store(other);
+	swap(temp_store);
+	return *this;
+}
+
+// Copies a table of sequences, one per row, and checks their validity. Returns 1 if lengths differ, 2 if out of memory.
+int SequenceStore::assign (const std::vector < std::vector <double> > & sequences)
+{
+	int	count = sequences.size();
+	int	length = (count)? sequences[0].size() : 0;
+	int	n, t;
+	for (n = 0; n < count; n++) {
+		if (sequences[n].size() != length)
+			return 1;
+	}
+	if (assign(count, length, 0.0))
+		return 2;
+
+	for (n = 0; n < count; n++) {
+		std::copy(sequences[n].begin(), sequences[n].end(), data(n));
+		for (t = 0; t < length; t++) {
+			if (sequences[n][t] != sequences[n][t]) {
+				m_valid[n] = false;
+				break;
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Allocates count valid sequences of the given length, all set to value; existing contents are discarded.
+int SequenceStore::assign (int count, int length, double value)
+{
+	int	stride = ((length + DIAGRAM_ROW_PADDING - 1) / DIAGRAM_ROW_PADDING) * DIAGRAM_ROW_PADDING;
+	size_t	nr_samples = (size_t) count * stride;
+
+	if (nr_samples != (size_t) m_count * m_stride) {
+		clear();
+		if (nr_samples) {
+			m_data = netOnZeroDXC_aligned_alloc(nr_samples);
+			if (!m_data)
+				return 1;
+		}
+	}
+	m_count = count;
+	m_length = length;
+	m_stride = stride;
+	m_valid.assign(count, true);
+	delete[] m_data_single;
+	m_data_single = NULL;
+	m_centers.clear();
+	std::fill(m_data, m_data + nr_samples, value);
+
+	return 0;
+}
+
+// Adds a single-precision copy of all sequences. Returns 1 if out of memory.
+int SequenceStore::assign_single ()
+{
+	size_t	nr_samples = (size_t) m_count * m_stride;
+
+	delete[] m_data_single;
+	m_data_single = (nr_samples)? new (std::nothrow) float[nr_samples] : NULL;
+	if (nr_samples && !m_data_single)
+		return 1;
+	std::fill(m_data_single, m_data_single + nr_samples, 0.0f);
+	m_centers.assign(m_count, 0.0);
+
+	int	n;
+	for (n = 0; n < m_count; n++)
+		update_single(n);
+
+	return 0;
+}
+
+// Copies sequence index again into the single-precision copy, if any, after its values were changed.
+void SequenceStore::update_single (int index)
+{
+	if (!m_data_single)
+		return;
+
+	const double	*sequence = data(index);
+	float		*sequence_single = m_data_single + (size_t) index * m_stride;
+	double		center = 0.0;
+	int		t;
+	for (t = 0; t < m_length; t++)
+		center += sequence[t];
+	center /= (double) m_length;
+	for (t = 0; t < m_length; t++)
+		sequence_single[t] = (float) (sequence[t] - center);
+	m_centers[index] = center;
+}
+
+void SequenceStore::clear ()
+{
+	if (m_data)
+		netOnZeroDXC_aligned_free(m_data);
+	m_data = NULL;
+	m_count = 0;
+	m_length = 0;
+	m_stride = 0;
+	m_valid.clear();
+	delete[] m_data_single;
+	m_data_single = NULL;
+	m_centers.clear();
+}
+
+void SequenceStore::swap (SequenceStore & other)
+{
+	std::swap(m_data, other.m_data);
+	std::swap(m_count, other.m_count);
+	std::swap(m_length, other.m_length);
+	std::swap(m_stride, other.m_stride);
+	m_valid.swap(other.m_valid);
+	std::swap(m_data_single, other.m_data_single);
+	m_centers.swap(other.m_centers);
+}
+
+int SequenceStore::size () const
+{
+	return m_count;
+}
+
+int SequenceStore::length () const
+{
+	return m_length;
+}
+
+SequenceSpan SequenceStore::span (int index) const
+{
+	SequenceSpan	sequence;
+	sequence.data = m_data + (size_t) index * m_stride;
+	sequence.length = m_length;
+	sequence.data_single = (m_data_single)? m_data_single + (size_t) index * m_stride : NULL;
+	sequence.center = (m_data_single)? m_centers[index] : 0.0;
+	return sequence;
+}
+
+double * SequenceStore::data (int index)
+{
+	return m_data + (size_t) index * m_stride;
+}
+
+bool SequenceStore::valid (int index) const
+{
+	return m_valid[index];
+}
+
+const std::vector <bool> & SequenceStore::validity () const
+{
+	return m_valid;
+}
+
+// FNV-1a hash of the samples of all sequences, taken a 64-bit word at a time; padding is left out.
+uint64_t SequenceStore::checksum () const
+{
+	uint64_t	hash = 14695981039346656037ULL;
+	uint64_t	word;
+	int		n, i;
+	for (n = 0; n < m_count; n++) {
+		const double	*sequence = m_data + (size_t) n * m_stride;
+		for (i = 0; i < m_length; i++) {
+			memcpy(&word, sequence + i, sizeof(word));
+			hash ^= word;
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	return hash;
+}
@@ -0,0 +1,87 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+
+// A SequenceStore holds the sequences of all nodes, which share the same length, one after the other in
+// a single block of memory; each sequence starts on a DIAGRAM_ALIGNMENT boundary. Sequences containing
+// NaN values are marked as invalid once, when they are stored. Kernels read sequences through spans,
+// which refer either to loaded data or to surrogates generated in place.
+// A store may also keep a single-precision copy of its sequences, each one centered on its own mean so that
+// an offset much larger than the fluctuations does not eat up the precision; spans then carry the copy and
+// the center, and kernels may read the copy instead. Sequences must be copied again once modified.
+// The checksum of a store tells whether a run saved along the way was computed from the same samples.
+
+struct SequenceSpan {
+	const double *	data;
+	int		length;
+	const float *	data_single;
+	double		center;
+
+	double operator[] (int i) const {return data[i];}
+};
+
+class SequenceStore
+{
+public:
+	SequenceStore();
+	SequenceStore(const SequenceStore &);
+	~SequenceStore();
+	SequenceStore & operator= (const SequenceStore &);
+
+	int assign(const std::vector < std::vector <double> > &);
+	int assign(int, int, double);
+	int assign_single();
+	void update_single(int);
+	void clear();
+	void swap(SequenceStore &);
+	int size() const;
+	int length() const;
+
+	SequenceSpan span(int) const;
+	double * data(int);
+	bool valid(int) const;
+	const std::vector <bool> & validity() const;
+	uint64_t checksum() const;
+
+private:
+	double *		m_data;
+	int			m_count;
+	int			m_length;
+	int			m_stride;
+	std::vector <bool>	m_valid;
+	float *			m_data_single;
+	std::vector <double>	m_centers;
+};
@@ -0,0 +1,156 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#ifndef INCLUDED_DIAGRAMSET
+	#include "netOnZeroDXC_diagram_set.hpp"
+	#define INCLUDED_DIAGRAMSET
+#endif
+#ifndef INCLUDED_SURROGATEWORKSPACE
+	#include "netOnZeroDXC_surrogate_workspace.hpp"
+	#define INCLUDED_SURROGATEWORKSPACE
+#endif
+
+SurrogateWorkspace::SurrogateWorkspace ()
+{
+	data = NULL;
+	data_prev_iter = NULL;
+	pool = NULL;
+	ranks = NULL;
+	random_generator = NULL;
+	wavetable_real = NULL;
+	wavetable_halfcomplex = NULL;
+	fft_workspace = NULL;
+	data_single = NULL;
+	data_prev_iter_single = NULL;
+	wavetable_real_single = NULL;
+	wavetable_halfcomplex_single = NULL;
+	fft_workspace_single = NULL;
+	m_length = 0;
+	m_single_precision = false;
+}
+
+SurrogateWorkspace::~SurrogateWorkspace ()
+{
+	clear();
+}
+
+// Sizes the workspace for sequences of the given length, in single precision or not; nothing is reallocated if
+// neither changed. Returns 1 if out of memory.
+int SurrogateWorkspace::assign (int length, bool single_precision)
+{
+	if (random_generator && (length == m_length) && (single_precision == m_single_precision))
+		return 0;
+
+	clear();
+	if (length < 1)
+		return 0;
+
+	data = netOnZeroDXC_aligned_alloc(length);
+	data_prev_iter = netOnZeroDXC_aligned_alloc(length);
+	pool = netOnZeroDXC_aligned_alloc(length);
+	ranks = new (std::nothrow) PairValueId[length];
+	random_generator = gsl_rng_alloc(gsl_rng_mt19937);
+	wavetable_real = gsl_fft_real_wavetable_alloc(length);
+	wavetable_halfcomplex = gsl_fft_halfcomplex_wavetable_alloc(length);
+	fft_workspace = gsl_fft_real_workspace_alloc(length);
+	if (!data || !data_prev_iter || !pool || !ranks || !random_generator || !wavetable_real || !wavetable_halfcomplex || !fft_workspace) {
+		clear();
+		return 1;
+	}
+	if (single_precision) {
+		data_single = new (std::nothrow) float[length];
+		data_prev_iter_single = new (std::nothrow) float[length];
+		wavetable_real_single = gsl_fft_real_wavetable_float_alloc(length);
+		wavetable_halfcomplex_single = gsl_fft_halfcomplex_wavetable_float_alloc(length);
+		fft_workspace_single = gsl_fft_real_workspace_float_alloc(length);
+		if (!data_single || !data_prev_iter_single || !wavetable_real_single || !wavetable_halfcomplex_single || !fft_workspace_single) {
+			clear();
+			return 1;
+		}
+	}
+	m_length = length;
+	m_single_precision = single_precision;
+
+	return 0;
+}
+
+void SurrogateWorkspace::clear ()
+{
+	netOnZeroDXC_aligned_free(data);
+	netOnZeroDXC_aligned_free(data_prev_iter);
+	netOnZeroDXC_aligned_free(pool);
+	delete[] ranks;
+	if (random_generator)
+		gsl_rng_free(random_generator);
+	if (wavetable_real)
+		gsl_fft_real_wavetable_free(wavetable_real);
+	if (wavetable_halfcomplex)
+		gsl_fft_halfcomplex_wavetable_free(wavetable_halfcomplex);
+	if (fft_workspace)
+		gsl_fft_real_workspace_free(fft_workspace);
+	delete[] data_single;
+	delete[] data_prev_iter_single;
+	if (wavetable_real_single)
+		gsl_fft_real_wavetable_float_free(wavetable_real_single);
+	if (wavetable_halfcomplex_single)
+		gsl_fft_halfcomplex_wavetable_float_free(wavetable_halfcomplex_single);
+	if (fft_workspace_single)
+		gsl_fft_real_workspace_float_free(fft_workspace_single);
+
+	data = NULL;
+	data_prev_iter = NULL;
+	pool = NULL;
+	ranks = NULL;
+	random_generator = NULL;
+	wavetable_real = NULL;
+	wavetable_halfcomplex = NULL;
+	fft_workspace = NULL;
+	data_single = NULL;
+	data_prev_iter_single = NULL;
+	wavetable_real_single = NULL;
+	wavetable_halfcomplex_single = NULL;
+	fft_workspace_single = NULL;
+	m_length = 0;
+	m_single_precision = false;
+}
+
+int SurrogateWorkspace::length () const
+{
+	return m_length;
+}
+
+bool SurrogateWorkspace::single_precision () const
+{
+	return m_single_precision;
+}
@@ -0,0 +1,79 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_fft_real.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+#include <gsl/gsl_fft_real_float.h>
+#include <gsl/gsl_fft_halfcomplex_float.h>
+
+struct PairValueId {
+	int index;
+	double value;
+};
+
+// A SurrogateWorkspace holds the scratch buffers, FFT tables and random generator used to generate
+// surrogates of sequences of a given length. Each thread owns its own workspace, sized once before the
+// surrogate loop, so that generating a surrogate does not touch the heap. A single-precision workspace
+// also holds float buffers and FFT tables, with which the iterations run in single precision.
+
+class SurrogateWorkspace
+{
+public:
+	SurrogateWorkspace();
+	~SurrogateWorkspace();
+
+	int assign(int, bool);
+	void clear();
+	int length() const;
+	bool single_precision() const;
+
+	double *			data;
+	double *			data_prev_iter;
+	double *			pool;
+	PairValueId *			ranks;
+	gsl_rng *			random_generator;
+	gsl_fft_real_wavetable *	wavetable_real;
+	gsl_fft_halfcomplex_wavetable *	wavetable_halfcomplex;
+	gsl_fft_real_workspace *	fft_workspace;
+
+	float *					data_single;
+	float *					data_prev_iter_single;
+	gsl_fft_real_wavetable_float *		wavetable_real_single;
+	gsl_fft_halfcomplex_wavetable_float *	wavetable_halfcomplex_single;
+	gsl_fft_real_workspace_float *		fft_workspace_single;
+
+private:
+	SurrogateWorkspace(const SurrogateWorkspace &);
+	SurrogateWorkspace & operator= (const SurrogateWorkspace &);
+
+	int	m_length;
+	bool	m_single_precision;
+};
@@ -0,0 +1,227 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <cstdlib>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef INCLUDED_IOFUNCTIONS
+	#include "netOnZeroDXC_io.hpp"
+	#define INCLUDED_IOFUNCTIONS
+#endif
+#ifndef INCLUDED_WRITER
+	#include "netOnZeroDXC_writer.hpp"
+	#define INCLUDED_WRITER
+#endif
+
+AsyncWriter::AsyncWriter (size_t max_queued)
+{
+	m_max_queued = (max_queued > 0)? max_queued : 1;
+	m_closing = false;
+	m_busy = false;
+	m_failed = false;
+	m_thread = std::thread(&AsyncWriter::run, this);
+}
+
+AsyncWriter::~AsyncWriter ()
+{
+	finish();
+}
+
+int AsyncWriter::saveDiagram (std::vector < std::vector <double> > diagram, std::string path, std::string prefix, std::string label, char delimiter,
+				std::string label_a, std::string label_b, char separator)
+{
+	WriteJob	job;
+	job.kind = WRITE_JOB_DIAGRAM;
+	job.table = std::move(diagram);
+	job.path = path;
+	job.prefix = prefix;
+	job.label = label;
+	job.delimiter = delimiter;
+	job.label_a = label_a;
+	job.label_b = label_b;
+	job.separator = separator;
+
+	return submit(job);
+}
+
+int AsyncWriter::saveDiagramBinary (std::vector < std::vector <double> > diagram, std::string path, std::string prefix, std::string label, char delimiter,
+				std::string label_a, std::string label_b, int cell_type, int nr_surrogates)
+{
+	WriteJob	job;
+	job.kind = WRITE_JOB_DIAGRAM_BINARY;
+	job.table = std::move(diagram);
+	job.path = path;
+	job.prefix = prefix;
+	job.label = label;
+	job.delimiter = delimiter;
+	job.label_a = label_a;
+	job.label_b = label_b;
+	job.cell_type = cell_type;
+	job.nr_surrogates = nr_surrogates;
+
+	return submit(job);
+}
+
+int AsyncWriter::saveLinearData (std::vector <double> x, std::vector <double> y, std::string path, std::string prefix, std::string label, char delimiter,
+				std::string label_a, std::string label_b, char separator)
+{
+	WriteJob	job;
+	job.kind = WRITE_JOB_LINEAR;
+	job.x = std::move(x);
+	job.y = std::move(y);
+	job.path = path;
+	job.prefix = prefix;
+	job.label = label;
+	job.delimiter = delimiter;
+	job.label_a = label_a;
+	job.label_b = label_b;
+	job.separator = separator;
+
+	return submit(job);
+}
+
+int AsyncWriter::appendArchive (ArchiveFile & archive, std::vector < std::vector <double> > data_table, std::string quantity, std::string label_a,
+				std::string label_b, int cell_type, int nr_surrogates)
+{
+	WriteJob	job;
+	job.kind = WRITE_JOB_ARCHIVE;
+	job.archive = &archive;
+	job.table = std::move(data_table);
+	job.label = quantity;
+	job.label_a = label_a;
+	job.label_b = label_b;
+	job.cell_type = cell_type;
+	job.nr_surrogates = nr_surrogates;
+
+	return submit(job);
+}
+
+int AsyncWriter::flush ()
+{
+	std::unique_lock <std::mutex>	lock(m_mutex);
+	while (!m_failed && (m_busy || !m_queue.empty()))
+		m_idle.wait(lock);
+
+	return (m_failed)? 1 : 0;
+}
+
+int AsyncWriter::finish ()
+{
+	{
+		std::lock_guard <std::mutex>	lock(m_mutex);
+		m_closing = true;
+	}
+	m_not_empty.notify_all();
+	if (m_thread.joinable())
+		m_thread.join();
+
+	std::lock_guard <std::mutex>	lock(m_mutex);
+	return (m_failed)? 1 : 0;
+}
+
+std::string AsyncWriter::failedOutput ()
+{
+	std::lock_guard <std::mutex>	lock(m_mutex);
+	return m_failed_output;
+}
+
+int AsyncWriter::submit (WriteJob & job)
+{
+	std::unique_lock <std::mutex>	lock(m_mutex);
+	while (!m_failed && !m_closing && (m_queue.size() >= m_max_queued))		// Back-pressure: wait for the writer to catch up
+		m_not_full.wait(lock);
+	if (m_failed || m_closing)
+		return 1;
+	m_queue.push_back(std::move(job));
+	lock.unlock();
+	m_not_empty.notify_one();
+
+	return 0;
+}
+
+void AsyncWriter::run ()
+{
+	WriteJob	job;
+	int		error;
+	while (true) {
+		{
+			std::unique_lock <std::mutex>	lock(m_mutex);
+			while (!m_closing && m_queue.empty())
+				m_not_empty.wait(lock);
+			if (m_queue.empty())
+				return;
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+			m_busy = true;
+		}
+		m_not_full.notify_one();
+
+		std::stringstream	description;
+		switch (job.kind) {
+			case WRITE_JOB_DIAGRAM:
+				error = netOnZeroDXC_save_diagram(job.table, job.path, job.prefix, job.label, job.delimiter, job.label_a, job.label_b, job.separator);
+				description << netOnZeroDXC_generate_filepath(job.path, job.prefix, job.label, job.delimiter, job.label_a, job.label_b);
+				break;
+			case WRITE_JOB_DIAGRAM_BINARY:
+				error = netOnZeroDXC_save_diagram_binary(job.table, job.path, job.prefix, job.label, job.delimiter, job.label_a, job.label_b, job.cell_type, job.nr_surrogates);
+				description << netOnZeroDXC_generate_filepath(job.path, job.prefix, job.label, job.delimiter, job.label_a, job.label_b);
+				break;
+			case WRITE_JOB_LINEAR:
+				error = netOnZeroDXC_save_linear_data(job.x, job.y, job.path, job.prefix, job.label, job.delimiter, job.label_a, job.label_b, job.separator);
+				description << netOnZeroDXC_generate_filepath(job.path, job.prefix, job.label, job.delimiter, job.label_a, job.label_b);
+				break;
+			case WRITE_JOB_ARCHIVE:
+				error = netOnZeroDXC_archive_append_table(*job.archive, job.table, job.label, job.label_a, job.label_b, job.cell_type, job.nr_surrogates);
+				description << "archive record " << job.label << " (" << job.label_a << ", " << job.label_b << ")";
+				break;
+			default:
+				error = 1;
+				break;
+		}
+
+		{
+			std::lock_guard <std::mutex>	lock(m_mutex);
+			m_busy = false;
+			if (error) {
+				if (!m_failed) {
+					m_failed = true;
+					m_failed_output = description.str();		// Reported once by the caller, through failedOutput
+				}
+				m_queue.clear();
+				m_not_full.notify_all();
+			}
+		}
+		m_idle.notify_all();
+	}
+}
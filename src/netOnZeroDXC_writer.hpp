@@ -0,0 +1,102 @@
+// --------------------------------------------------------------------------
+//
+// This file is part of the NetOnZeroDXC software package.
+//
+// Version 1.1 - July 2019
+//
+//
+// The NetOnZeroDXC package is free software; you can use it, redistribute it,
+// and/or modify it under the terms of the GNU General Public License
+// version 3 as published by the Free Software Foundation. The full text
+// of the license can be found in the file LICENSE.txt at the top level of
+// the package distribution.
+//
+// Authors:
+//		Alessio Perinelli and Leonardo Ricci
+//		Department of Physics, University of Trento
+//		I-38123 Trento, Italy
+//		alessio.perinelli@unitn.it
+//		leonardo.ricci@unitn.it
+//		https://github.com/LeonardoRicci/netOnZeroDXC
+//
+//
+// If you use the NetOnZeroDXC package for your analyses, please cite:
+//
+//	A. Perinelli, D. E. Chiari and L. Ricci,
+//	"Correlation in brain networks at different time scale resolution".
+//	Chaos 28 (6):063127, 2018
+//
+// --------------------------------------------------------------------------
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifndef INCLUDED_ARCHIVE
+	#include "netOnZeroDXC_archive.hpp"
+	#define INCLUDED_ARCHIVE
+#endif
+
+// Output files are formatted and written by a background thread, so that the computation of the
+// next pair overlaps with disk I/O. Jobs take ownership of their data; when WRITER_QUEUE_SIZE jobs
+// are pending, submission blocks until the writer catches up. A single writer thread keeps
+// archive records in submission order. After the first failure, pending jobs are discarded and
+// every later submission returns an error; the writer reports nothing itself, failedOutput names
+// the output that failed for the caller to report. flush waits for the pending jobs and keeps the writer running, finish
+// also stops it.
+
+#define WRITER_QUEUE_SIZE		32
+
+#define WRITE_JOB_DIAGRAM		0
+#define WRITE_JOB_DIAGRAM_BINARY	1
+#define WRITE_JOB_LINEAR		2
+#define WRITE_JOB_ARCHIVE		3
+
+struct WriteJob {
+	int					kind;
+	std::vector < std::vector <double> >	table;
+	std::vector <double>			x;
+	std::vector <double>			y;
+	std::string				path;
+	std::string				prefix;
+	std::string				label;
+	std::string				label_a;
+	std::string				label_b;
+	char					delimiter;
+	char					separator;
+	int					cell_type;
+	int					nr_surrogates;
+	ArchiveFile *				archive;
+};
+
+class AsyncWriter
+{
+public:
+	AsyncWriter(size_t);
+	~AsyncWriter();
+
+	int saveDiagram(std::vector < std::vector <double> >, std::string, std::string, std::string, char, std::string, std::string, char);
+	int saveDiagramBinary(std::vector < std::vector <double> >, std::string, std::string, std::string, char, std::string, std::string, int, int);
+	int saveLinearData(std::vector <double>, std::vector <double>, std::string, std::string, std::string, char, std::string, std::string, char);
+	int appendArchive(ArchiveFile &, std::vector < std::vector <double> >, std::string, std::string, std::string, int, int);
+	int flush();
+	int finish();
+	std::string failedOutput();
+
+private:
+	int submit(WriteJob &);
+	void run();
+
+	size_t			m_max_queued;
+	bool			m_closing;
+	bool			m_busy;
+	bool			m_failed;
+	std::string		m_failed_output;
+	std::deque <WriteJob>	m_queue;
+	std::mutex		m_mutex;
+	std::condition_variable	m_not_empty;
+	std::condition_variable	m_not_full;
+	std::condition_variable	m_idle;
+	std::thread		m_thread;
+};